@@ -0,0 +1,47 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the parallel report aggregation
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "reportAggregator.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void aggregatorBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Report aggregation, single threaded (parsing cost) and on all cores (scaling)
+		double reportsPerCore[2] = { 0.0, 0.0 };
+		const int aggregateThreads[2] = { 1, 0 };
+		for (int i = 0; i < 2; i++) {
+			suite.run(string("macro/reportAggregator.200") + ((aggregateThreads[i] == 1) ? ".1thread" : ".allthreads"), fixtures.deviceReportsXml.size(), [&]() {
+				reportAggregator aggregator;
+				aggregator.threadCount = aggregateThreads[i];
+				aggregator.aggregateXml(fixtures.deviceReportsXml);
+				reportsPerCore[i] = aggregator.reportsPerSecondPerCore();
+				benchmarkSink = aggregator.capDistributions.size();
+			});
+		}
+		*suite.log << "  reports/s/core: 1 thread " << (int)reportsPerCore[0] << ", all threads " << (int)reportsPerCore[1] << "\n";
+	}
+
+}
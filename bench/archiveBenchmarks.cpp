@@ -0,0 +1,91 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the deduplicated report archive
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "reportArchive.h"
+#include "mappedReportArchive.h"
+#include <QDir>
+#include <QFile>
+#include <QByteArray>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void archiveBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Deduplicated archive of the 200 device reports, compared to the xml and the per file zlib compressed xml
+		reportArchive archive;
+		suite.run("macro/reportArchive.add.200", fixtures.deviceReports.size(), [&]() {
+			archive.clear();
+			archive.createSchema(fixtures.caps);
+			for (auto& report : fixtures.deviceReports) {
+				archive.addReport(report);
+			}
+			benchmarkSink = archive.chunks.size();
+		});
+		suite.run("macro/reportArchive.read.200", archive.reports.size(), [&]() {
+			size_t caps = 0;
+			for (size_t i = 0; i < archive.reports.size(); i++) {
+				reportData report;
+				archive.readReport(i, report);
+				caps += report.caps.size();
+			}
+			benchmarkSink = caps;
+		});
+		uint64_t archiveXmlBytes = 0;
+		uint64_t archiveCompressedBytes = 0;
+		for (auto& xml : fixtures.deviceReportsXml) {
+			archiveXmlBytes += xml.size();
+			archiveCompressedBytes += qCompress(QByteArray::fromRawData(xml.data(), (int)xml.size()), 9).size();
+		}
+		string archiveFile = QDir::temp().filePath("glcapsviewer_bench.glca").toStdString();
+		archive.save(archiveFile);
+		*suite.log << "  archive: " << archive.chunks.size() << " unique of " << archive.chunkReferences() << " chunks, " << archive.fileSize / 1024 << " KB, ratio to xml " << (double)archiveXmlBytes / archive.fileSize << ", to zlib per file " << (double)archiveCompressedBytes / archive.fileSize << "\n";
+
+		// Opening and querying the archive in place (uncompressed chunks) compared to reading the archive index
+		archive.compressChunks = false;
+		archive.save(archiveFile);
+		suite.run("macro/reportArchive.open.200", archive.reports.size(), [&]() {
+			reportArchive openedArchive;
+			openedArchive.open(archiveFile);
+			benchmarkSink = openedArchive.reports.size();
+		});
+		suite.run("macro/mappedReportArchive.open.200", archive.reports.size(), [&]() {
+			mappedReportArchive mappedArchive;
+			mappedArchive.open(archiveFile);
+			benchmarkSink = mappedArchive.reports.size;
+		});
+		mappedReportArchive mappedArchive;
+		mappedArchive.open(archiveFile);
+		suite.run("macro/mappedReportArchive.getCap.200", mappedArchive.reports.size, [&]() {
+			size_t len = 0;
+			for (size_t i = 0; i < mappedArchive.reports.size; i++) {
+				len += mappedArchive.getCap(i, "GL_MAX_TEXTURE_SIZE").size;
+			}
+			benchmarkSink = len;
+		});
+		mappedArchive.close();
+		QFile::remove(QString::fromStdString(archiveFile));
+	}
+
+}
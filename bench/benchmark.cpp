@@ -0,0 +1,131 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmark suite runner
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmark.h"
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <ctime>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	volatile size_t benchmarkSink = 0;
+
+	double benchmarkResult::itemsPerSecond() const
+	{
+		return (medianTime > 0.0) ? (double)items * 1.0e9 / medianTime : 0.0;
+	}
+
+	/// <summary>
+	/// Runs a single benchmark and stores its timing results
+	/// </summary>
+	/// <param name="name">Name of the benchmark, prefixed with micro/ or macro/</param>
+	/// <param name="items">Number of items processed by a single call of func</param>
+	/// <param name="func">Function to benchmark</param>
+	void benchmarkSuite::run(string name, size_t items, function<void()> func)
+	{
+		if ((!filter.empty()) && (name.find(filter) == string::npos)) {
+			return;
+		}
+
+		typedef chrono::high_resolution_clock clock;
+
+		// Warm up caches and lazy initializations
+		func();
+
+		vector<double> times;
+		double totalTime = 0.0;
+		while ((times.size() < (size_t)minIterations) || (totalTime < minTime * 1.0e9)) {
+			clock::time_point start = clock::now();
+			func();
+			double time = chrono::duration<double, nano>(clock::now() - start).count();
+			times.push_back(time);
+			totalTime += time;
+		}
+
+		sort(times.begin(), times.end());
+
+		benchmarkResult result;
+		result.name = name;
+		result.items = items;
+		result.iterations = (int)times.size();
+		result.minTime = times.front();
+		result.maxTime = times.back();
+		result.medianTime = times[times.size() / 2];
+		result.meanTime = totalTime / times.size();
+		results.push_back(result);
+
+		*log << left << setw(48) << name << right << fixed << setprecision(3);
+		*log << setw(14) << result.medianTime / 1000.0 << " us";
+		*log << setw(16) << setprecision(0) << result.itemsPerSecond() << " items/s";
+		*log << setw(8) << result.iterations << " iterations\n";
+	}
+
+	/// <summary>
+	/// Converts all benchmark results to json
+	/// </summary>
+	/// <returns>Json string with one entry per benchmark, times are in nanoseconds</returns>
+	string benchmarkSuite::resultsToJson()
+	{
+		auto t = std::time(nullptr);
+		auto tm = *std::localtime(&t);
+		char buffer[256];
+		strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+
+		stringstream ss;
+		ss << fixed << setprecision(1);
+		ss << "{\n";
+		ss << "  \"suite\": \"glcapsviewer_bench\",\n";
+		ss << "  \"date\": \"" << buffer << "\",\n";
+		ss << "  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			benchmarkResult& result = results[i];
+			ss << "    {";
+			ss << "\"name\": \"" << result.name << "\", ";
+			ss << "\"iterations\": " << result.iterations << ", ";
+			ss << "\"items\": " << result.items << ", ";
+			ss << "\"min_ns\": " << result.minTime << ", ";
+			ss << "\"median_ns\": " << result.medianTime << ", ";
+			ss << "\"mean_ns\": " << result.meanTime << ", ";
+			ss << "\"max_ns\": " << result.maxTime << ", ";
+			ss << "\"items_per_second\": " << result.itemsPerSecond();
+			ss << "}" << ((i < results.size() - 1) ? "," : "") << "\n";
+		}
+		ss << "  ]\n";
+		ss << "}\n";
+		return ss.str();
+	}
+
+	void benchmarkSuite::exportJson(string fileName)
+	{
+		ofstream destfile;
+		destfile.open(fileName);
+		destfile << resultsToJson();
+		destfile.close();
+	}
+
+}
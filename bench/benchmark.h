@@ -0,0 +1,68 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmark suite runner
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <iostream>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class benchmarkResult
+	{
+	public:
+		string name;
+		int iterations = 0;
+		// Items processed per iteration (e.g. enums looked up, caps written)
+		size_t items = 1;
+		// Times per iteration in nanoseconds
+		double minTime = 0.0;
+		double medianTime = 0.0;
+		double meanTime = 0.0;
+		double maxTime = 0.0;
+		double itemsPerSecond() const;
+	};
+
+	class benchmarkSuite
+	{
+	public:
+		// Only benchmarks containing this string are run
+		string filter;
+		// Each benchmark is repeated until both limits have been reached
+		int minIterations = 10;
+		double minTime = 0.5;
+		// Human readable results and progress, kept off stdout when json is written there
+		ostream* log = &cout;
+		vector<benchmarkResult> results;
+		void run(string name, size_t items, function<void()> func);
+		string resultsToJson();
+		void exportJson(string fileName);
+	};
+
+	// Keeps the compiler from optimizing away benchmarked results
+	extern volatile size_t benchmarkSink;
+
+}
@@ -0,0 +1,85 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmark fixtures shared by the benchmark groups
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include <fstream>
+#include <iterator>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void benchmarkFixtures::load()
+	{
+		capsListXml = readFile("capslist.xml");
+		caps.loadFromXml(capsListXml.c_str());
+
+		reportGeneratorSettings settings;
+		settings.deviceCount = 50;
+		settings.reportsPerDevice = 4.0;
+		reportGenerator generator = createGenerator(settings, capsListXml);
+		for (size_t d = 0; (d < generator.devices.size()) && (deviceReportsXml.size() < 200); d++) {
+			for (int r = 0; (r < generator.devices[d].reportCount) && (deviceReportsXml.size() < 200); r++) {
+				deviceReportsXml.push_back(generator.reportXml((int)d, r));
+			}
+		}
+		deviceReports.resize(deviceReportsXml.size());
+		for (size_t i = 0; i < deviceReportsXml.size(); i++) {
+			deviceReports[i].fromXml(deviceReportsXml[i]);
+		}
+	}
+
+	string benchmarkFixtures::readFile(string fileName)
+	{
+		ifstream file(fileName);
+		return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	}
+
+	/// <summary>
+	/// Creates a generator with its devices generated
+	/// </summary>
+	/// <param name="capsListXml">Capability list used for the cap definitions, only synthetic caps are generated if empty</param>
+	reportGenerator benchmarkFixtures::createGenerator(const reportGeneratorSettings& settings, const string& capsListXml)
+	{
+		reportGenerator generator(settings);
+		if (!capsListXml.empty()) {
+			generator.capDefinitions.loadFromXml(capsListXml.c_str());
+		}
+		generator.generateDevices();
+		return generator;
+	}
+
+	/// <summary>
+	/// Single device with 10k synthetic caps, nothing can be updated so the whole report has to be checked
+	/// </summary>
+	reportGeneratorSettings benchmarkFixtures::largeReportSettings()
+	{
+		reportGeneratorSettings settings;
+		settings.deviceCount = 1;
+		settings.capCount = 10000;
+		settings.extensionCount = 1000;
+		settings.compressedFormatCount = 500;
+		settings.databaseMissingRate = 0.0;
+		return settings;
+	}
+
+}
@@ -0,0 +1,64 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmark fixtures shared by the benchmark groups
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "capsList.h"
+#include "reportGenerator.h"
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	// All synthetic data is generated from fixed seeds so runs are comparable
+
+	class benchmarkFixtures
+	{
+	public:
+		// Capability list shipped with the application
+		string capsListXml;
+		capsList caps;
+		// Reports of 50 devices (at most 200), as xml and parsed
+		vector<string> deviceReportsXml;
+		vector<reportData> deviceReports;
+		void load();
+		static string readFile(string fileName);
+		static reportGenerator createGenerator(const reportGeneratorSettings& settings, const string& capsListXml);
+		static reportGeneratorSettings largeReportSettings();
+	};
+
+	// Benchmark groups, one per area, registered in main
+	typedef void (*benchmarkGroup)(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void coreBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void diffBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void aggregatorBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void queryBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void similarityBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void archiveBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void comparisonBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+	void treeBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures);
+
+}
@@ -0,0 +1,62 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the side by side report comparison
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "glCapsViewerCore.h"
+#include "reportComparison.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void comparisonBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Side by side comparison of 20 reports with internal format information
+		reportGeneratorSettings settings;
+		settings.deviceCount = 20;
+		settings.reportsPerDevice = 1.0;
+		settings.compressedFormatCount = 100;
+		settings.internalFormats = true;
+		reportGenerator generator = benchmarkFixtures::createGenerator(settings, fixtures.capsListXml);
+		vector<reportData> compareReports(generator.devices.size());
+		for (size_t i = 0; i < compareReports.size(); i++) {
+			glCapsViewerCore compareCore;
+			generator.fillCore(compareCore, (int)i, 0);
+			compareReports[i].fromCore(compareCore);
+		}
+		reportComparison comparison;
+		suite.run("macro/reportComparison.build.20", compareReports.size(), [&]() {
+			comparison.clear();
+			for (auto& report : compareReports) {
+				comparison.addReport(report, report.description);
+			}
+			benchmarkSink = comparison.differenceCount();
+		});
+		const char* comparisonFilters[] = { "MAX_WIDTH", "GL_TEXTURE_2D/" };
+		int comparisonFilterIndex = 0;
+		suite.run("macro/reportComparison.filter", comparison.rowCount(), [&]() {
+			benchmarkSink = comparison.filter(comparisonFilters[comparisonFilterIndex++ % 2], -1, true).size();
+		});
+		*suite.log << "  comparison: " << comparison.columnCount() << " reports, " << comparison.rowCount() << " rows, " << comparison.differenceCount() << " with differences\n";
+	}
+
+}
@@ -0,0 +1,121 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the enum list, capability list and report export and update paths
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "glCapsViewerCore.h"
+#include <QByteArray>
+#include <random>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void coreBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Enum list
+		glCapsViewerCore enumCore;
+		suite.run("micro/loadEnumList", 1, [&]() {
+			enumCore.loadEnumList();
+		});
+
+		vector<GLint> lookupEnums;
+		mt19937 rng(42);
+		for (int i = 0; i < 10000; i++) {
+			// Mix of known compressed format enums and unknown values
+			lookupEnums.push_back((i % 2 == 0) ? 0x83F0 + (rng() % 4) : 0x10000 + (rng() % 1000));
+		}
+		suite.run("micro/getEnumName", lookupEnums.size(), [&]() {
+			size_t len = 0;
+			for (auto& glenum : lookupEnums) {
+				len += enumCore.getEnumName(glenum).size();
+			}
+			benchmarkSink = len;
+		});
+
+		// Capability list parsing
+		suite.run("micro/capsList.loadFromXml", 1, [&]() {
+			capsList list;
+			list.loadFromXml(fixtures.capsListXml.c_str());
+			benchmarkSink = list.categories.size();
+		});
+
+		string largeCapsListXml = reportGenerator::capsListXml(200, 50);
+		suite.run("macro/capsList.loadFromXml.10k", 10000, [&]() {
+			capsList list;
+			list.loadFromXml(largeCapsListXml.c_str());
+			benchmarkSink = list.categories.size();
+		});
+
+		// Synthetic report based on the capability list
+		reportGeneratorSettings settings;
+		settings.deviceCount = 1;
+		settings.capCount = 1000;
+		settings.extensionCount = 300;
+		settings.compressedFormatCount = 100;
+		reportGenerator generator = benchmarkFixtures::createGenerator(settings, fixtures.capsListXml);
+		glCapsViewerCore core;
+		generator.fillCore(core, 0, 0);
+
+		// Extension lookups
+		vector<string> lookupExtensions;
+		for (int i = 0; i < 1000; i++) {
+			lookupExtensions.push_back((i % 2 == 0) ? "GL_EXT_synthetic_extension_" + to_string(rng() % 300) : "GL_EXT_missing_extension_" + to_string(i));
+		}
+		suite.run("micro/extensionSupported", lookupExtensions.size(), [&]() {
+			size_t found = 0;
+			for (auto& ext : lookupExtensions) {
+				found += core.extensionSupported(ext) ? 1 : 0;
+			}
+			benchmarkSink = found;
+		});
+
+		// Report export
+		suite.run("macro/reportToXml", 1000, [&]() {
+			benchmarkSink = core.reportToXml().size();
+		});
+
+		// Report update check against a database report
+		string databaseReport = generator.databaseReportXml(core, 1);
+		suite.run("macro/canUpdateReport", 1000, [&]() {
+			benchmarkSink = core.canUpdateReport(databaseReport) ? 1 : 0;
+		});
+
+		// Report update payload (only values missing in the database report)
+		reportDiff updateDiff = core.diffReport(databaseReport);
+		suite.run("macro/reportUpdateToXml", 1000, [&]() {
+			benchmarkSink = qCompress(QByteArray::fromStdString(core.reportUpdateToXml(updateDiff)), 9).size();
+		});
+		string fullPayload = core.reportToXml();
+		string updatePayload = core.reportUpdateToXml(updateDiff);
+		*suite.log << "  payload bytes: full " << fullPayload.size() << " (" << qCompress(QByteArray::fromStdString(fullPayload), 9).size() << " compressed), ";
+		*suite.log << "update " << updatePayload.size() << " (" << qCompress(QByteArray::fromStdString(updatePayload), 9).size() << " compressed)\n";
+
+		reportGenerator largeGenerator = benchmarkFixtures::createGenerator(benchmarkFixtures::largeReportSettings(), "");
+		glCapsViewerCore largeCore;
+		largeGenerator.fillCore(largeCore, 0, 0);
+		string largeDatabaseReport = largeGenerator.databaseReportXml(largeCore, 1);
+		suite.run("macro/canUpdateReport.10k", 10000, [&]() {
+			benchmarkSink = largeCore.canUpdateReport(largeDatabaseReport) ? 1 : 0;
+		});
+	}
+
+}
@@ -0,0 +1,65 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of report parsing and the structured report diff
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "glCapsViewerCore.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void diffBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		reportGenerator largeGenerator = benchmarkFixtures::createGenerator(benchmarkFixtures::largeReportSettings(), "");
+		glCapsViewerCore largeCore;
+		largeGenerator.fillCore(largeCore, 0, 0);
+		string largeDatabaseReport = largeGenerator.databaseReportXml(largeCore, 1);
+
+		// Report diff, parsing and comparison separately
+		suite.run("macro/reportData.fromXml.10k", 10000, [&]() {
+			reportData report;
+			report.fromXml(largeDatabaseReport);
+			benchmarkSink = report.caps.size();
+		});
+
+		reportData largeLocalReport;
+		largeLocalReport.fromCore(largeCore);
+		reportData largeDatabaseData;
+		largeDatabaseData.fromXml(largeGenerator.databaseReportXml(largeCore, 2));
+		// Second report of the same device, so caps, extensions and formats differ
+		glCapsViewerCore otherCore;
+		largeGenerator.fillCore(otherCore, 0, 1);
+		reportData largeOtherReport;
+		largeOtherReport.fromCore(otherCore);
+		suite.run("macro/reportDiff.compare.10k", 10000, [&]() {
+			reportDiff diff;
+			diff.compare(largeDatabaseData, largeLocalReport);
+			benchmarkSink = diff.entries.size();
+		});
+		suite.run("macro/reportDiff.compare.changed.10k", 10000, [&]() {
+			reportDiff diff;
+			diff.compare(largeLocalReport, largeOtherReport);
+			benchmarkSink = diff.entries.size();
+		});
+	}
+
+}
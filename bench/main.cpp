@@ -0,0 +1,98 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmark suite for the non OpenGL code paths
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QDir>
+#include <iostream>
+
+#include "benchmark.h"
+#include "benchmarkFixtures.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_bench [options]\n\n";
+	cout << "  --json <file>      Write results as json to file (\"-\" for stdout)\n";
+	cout << "  --filter <text>    Only run benchmarks whose name contains text\n";
+	cout << "  --min-time <sec>   Minimum measuring time per benchmark (default 0.5)\n";
+	cout << "  --data <dir>       Directory containing capslist.xml and enumList.xml\n";
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	benchmarkSuite suite;
+	string jsonFile;
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--json") && hasValue) {
+			jsonFile = args[++i].toStdString();
+		}
+		else if ((args[i] == "--filter") && hasValue) {
+			suite.filter = args[++i].toStdString();
+		}
+		else if ((args[i] == "--min-time") && hasValue) {
+			suite.minTime = args[++i].toDouble();
+		}
+		else if ((args[i] == "--data") && hasValue) {
+			QDir::setCurrent(args[++i]);
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+	if (jsonFile == "-") {
+		suite.log = &cerr;
+	}
+
+	benchmarkFixtures fixtures;
+	fixtures.load();
+	// New benchmark areas are added as a group here
+	const benchmarkGroup groups[] = {
+		coreBenchmarks,
+		diffBenchmarks,
+		aggregatorBenchmarks,
+		queryBenchmarks,
+		similarityBenchmarks,
+		archiveBenchmarks,
+		comparisonBenchmarks,
+		treeBenchmarks
+	};
+	for (auto& group : groups) {
+		group(suite, fixtures);
+	}
+
+	if (jsonFile == "-") {
+		cout << suite.resultsToJson();
+	}
+	else if (!jsonFile.empty()) {
+		suite.exportJson(jsonFile);
+	}
+
+	return 0;
+}
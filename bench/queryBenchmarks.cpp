@@ -0,0 +1,96 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the columnar report store and the inverted report index
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "reportColumnStore.h"
+#include "reportIndex.h"
+#include <random>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void queryBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Columnar store queries over 1M rows, built from 1000 distinct synthetic reports
+		capsList storeCaps;
+		storeCaps.loadFromXml(reportGenerator::capsListXml(1, 8).c_str());
+		reportColumnStore store;
+		store.createSchema(storeCaps);
+		mt19937 storeRng(7);
+		vector<reportData> storeReports(1000);
+		for (auto& report : storeReports) {
+			report.caps.push_back(make_pair("GL_RENDERER", "Synthetic renderer " + to_string(storeRng() % 100)));
+			for (int i = 0; i < 8; i++) {
+				report.caps.push_back(make_pair("GL_MAX_SYNTHETIC_LIMIT_" + to_string(i), to_string(4096 << (storeRng() % 4))));
+			}
+			for (int i = 0; i < 100; i++) {
+				if (storeRng() % 2 == 0) {
+					report.extensions.push_back("GL_EXT_synthetic_extension_" + to_string(i));
+				}
+			}
+		}
+		for (int i = 0; i < 1000000; i++) {
+			store.addReport(storeReports[i % storeReports.size()]);
+		}
+		reportQuery storeQuery;
+		storeQuery.parse("GL_MAX_SYNTHETIC_LIMIT_0 >= 16384 and GL_EXT_synthetic_extension_3");
+		suite.run("macro/reportColumnStore.select.1M", store.rowCount, [&]() {
+			vector<uint64_t> mask;
+			string error;
+			store.select(storeQuery, mask, error);
+			benchmarkSink = reportColumnStore::countRows(mask);
+		});
+		reportQuery storeRangeQuery;
+		storeRangeQuery.parse("GL_MAX_SYNTHETIC_LIMIT_1 > 4096 and GL_MAX_SYNTHETIC_LIMIT_2 < 32768 and not GL_EXT_synthetic_extension_5");
+		suite.run("macro/reportColumnStore.select.range.1M", store.rowCount, [&]() {
+			vector<uint64_t> mask;
+			string error;
+			store.select(storeRangeQuery, mask, error);
+			benchmarkSink = reportColumnStore::countRows(mask);
+		});
+		*suite.log << "  column store: " << store.rowCount << " rows, " << store.memoryUsage() / (1024 * 1024) << " MB\n";
+
+		// Inverted index queries over 100k reports (posting list intersection)
+		reportIndex index;
+		for (int i = 0; i < 100000; i++) {
+			index.addReport(storeReports[i % storeReports.size()], i);
+		}
+		reportQuery indexQuery;
+		indexQuery.parse("GL_MAX_SYNTHETIC_LIMIT_0 >= 16384 and GL_EXT_synthetic_extension_3 and not GL_EXT_synthetic_extension_5");
+		suite.run("macro/reportIndex.select.100k", index.reports.size(), [&]() {
+			vector<uint32_t> result;
+			string error;
+			index.select(indexQuery, result, error);
+			benchmarkSink = result.size();
+		});
+		reportQuery rendererQuery;
+		rendererQuery.parse("renderer:\"renderer 42\" and GL_EXT_synthetic_extension_7");
+		suite.run("macro/reportIndex.select.renderer.100k", index.reports.size(), [&]() {
+			vector<uint32_t> result;
+			string error;
+			index.select(rendererQuery, result, error);
+			benchmarkSink = result.size();
+		});
+	}
+
+}
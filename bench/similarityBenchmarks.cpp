@@ -0,0 +1,45 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the nearest device search
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "reportSimilarity.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void similarityBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		// Nearest device search over 100k reports with the capability list schema
+		reportSimilarity similarity;
+		similarity.createSchema(fixtures.caps);
+		for (int i = 0; i < 100000; i++) {
+			similarity.addReport(fixtures.deviceReports[i % fixtures.deviceReports.size()], "");
+		}
+		similarity.build();
+		suite.run("macro/reportSimilarity.query.100k", similarity.size(), [&]() {
+			benchmarkSink = similarity.query(fixtures.deviceReports[0], 50).size();
+		});
+		*suite.log << "  similarity: " << similarity.dimensions << " dimensions, " << similarity.vectors.size() / (1024 * 1024) << " MB\n";
+	}
+
+}
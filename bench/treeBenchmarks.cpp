@@ -0,0 +1,81 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Benchmarks of the implementation tree filtering
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "benchmarkFixtures.h"
+#include "treeproxyfilter.h"
+#include <QStandardItemModel>
+#include <QStandardItem>
+#include <random>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Fills a model with the same two level layout as the implementation tree (groups with key/value rows)
+	/// </summary>
+	void fillSyntheticTree(QStandardItemModel& model, int groupCount, int itemsPerGroup)
+	{
+		mt19937 rng(42);
+		const char* prefixes[] = { "GL_MAX_", "GL_MIN_", "GL_NUM_", "GL_" };
+		const char* suffixes[] = { "TEXTURE_SIZE", "UNIFORM_COMPONENTS", "VERTEX_ATTRIBS", "DRAW_BUFFERS", "SAMPLES", "VIEWPORTS" };
+
+		QStandardItem* rootItem = model.invisibleRootItem();
+		for (int g = 0; g < groupCount; g++) {
+			QStandardItem* groupItem = new QStandardItem("Group " + QString::number(g));
+			for (int i = 0; i < itemsPerGroup; i++) {
+				QList<QStandardItem*> rowItems;
+				string name = string(prefixes[rng() % 4]) + suffixes[rng() % 6] + "_" + to_string(i);
+				rowItems << new QStandardItem(QString::fromStdString(name));
+				rowItems << new QStandardItem(QString::number((int)(rng() % 65536)));
+				groupItem->appendRow(rowItems);
+			}
+			rootItem->appendRow(groupItem);
+		}
+	}
+
+	int countVisibleRows(QAbstractItemModel& model, const QModelIndex& parent)
+	{
+		int count = model.rowCount(parent);
+		int visible = count;
+		for (int i = 0; i < count; i++) {
+			visible += countVisibleRows(model, model.index(i, 0, parent));
+		}
+		return visible;
+	}
+
+	void treeBenchmarks(benchmarkSuite& suite, benchmarkFixtures& fixtures)
+	{
+		QStandardItemModel treeModel;
+		fillSyntheticTree(treeModel, 50, 200);
+		TreeProxyFilter filterProxy;
+		filterProxy.setSourceModel(&treeModel);
+		const char* filters[] = { "MAX_TEXTURE", "UNIFORM" };
+		int filterIndex = 0;
+		suite.run("macro/TreeProxyFilter.10k", 10000, [&]() {
+			// Alternate between filters to force re-filtering
+			filterProxy.setFilterRegExp(QRegExp(filters[filterIndex++ % 2], Qt::CaseInsensitive, QRegExp::RegExp));
+			benchmarkSink = countVisibleRows(filterProxy, QModelIndex());
+		});
+	}
+
+}
@@ -0,0 +1,259 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Buffer streaming strategy probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "bufferStreamingProbe.h"
+#include "glCapsViewerCore.h"
+#include <cstring>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string bufferStreamingProbe::name() const
+	{
+		return "bufferstreaming";
+	}
+
+	bool bufferStreamingProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Waits until the GPU is done with a ring buffer region
+	/// </summary>
+	/// <returns>Time spent waiting in microseconds</returns>
+	double bufferStreamingProbe::waitRegion(int region)
+	{
+		if (fences[region] == 0) {
+			return 0.0;
+		}
+		glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+		while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+		glDeleteSync(fences[region]);
+		fences[region] = 0;
+		return chrono::duration<double, micro>(glPerformanceProbes::clock::now() - start).count();
+	}
+
+	void bufferStreamingProbe::fenceRegion(int region)
+	{
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	/// <summary>
+	/// Streams and draws framesPerSample frames per sample
+	/// The CPU time spent in the upload beyond a plain copy of the frame data is reported as stall (waiting for the GPU, driver copies)
+	/// </summary>
+	/// <param name="copyTime">Time of a memcpy of one frame in microseconds</param>
+	/// <param name="upload">Writes the data of a frame</param>
+	/// <param name="ring">Frames are written to consecutive ring buffer regions, each region is fenced after the draw reading it</param>
+	void bufferStreamingProbe::measureStrategy(glPerformanceProbes& probes, const string& strategy, double copyTime, function<void(int frame)> upload, bool ring)
+	{
+		GLsizei vertexCount = frameSize / (4 * sizeof(GLfloat));
+		probeSamples uploadSamples;
+		probeSamples frameSamples;
+		glPerformanceProbes::clearErrors();
+		// First sample is the warm up
+		for (int s = 0; s <= probes.sampleCount; s++) {
+			double uploadTime = 0.0;
+			double frameTime = glPerformanceProbes::timeFinished([&]() {
+				for (int frame = 0; frame < framesPerSample; frame++) {
+					glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+					upload(frame);
+					uploadTime += chrono::duration<double, micro>(glPerformanceProbes::clock::now() - start).count();
+					int region = frame % ringFrames;
+					glDrawArrays(GL_POINTS, ring ? region * vertexCount : 0, vertexCount);
+					if (ring) {
+						fenceRegion(region);
+					}
+				}
+			});
+			if (s > 0) {
+				uploadSamples.add(uploadTime / framesPerSample);
+				frameSamples.add(frameTime / framesPerSample);
+			}
+		}
+		for (int region = 0; region < ringFrames; region++) {
+			waitRegion(region);
+		}
+		if (glGetError() != GL_NO_ERROR) {
+			probes.addMessage(name(), strategy + " skipped, streaming failed");
+			return;
+		}
+		double uploadTime = uploadSamples.median();
+		double frameTime = frameSamples.median();
+		probes.addValue(name(), strategy, "mbps", (frameTime > 0.0) ? frameSize / frameTime : 0.0);
+		probes.addValue(name(), strategy, "upload_us", uploadTime);
+		probes.addValue(name(), strategy, "stall_us", max(uploadTime - copyTime, 0.0));
+	}
+
+	void bufferStreamingProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		string vertexSource =
+			"#version 330\n"
+			"layout(location = 0) in vec4 data;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(data.xy * 2.0 - 1.0, 0.0, 1.0);\n"
+			"}\n";
+		string fragmentSource =
+			"#version 330\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	color = vec4(1.0);\n"
+			"}\n";
+		string log;
+		GLuint program = glPerformanceProbes::createProgram(vertexSource, fragmentSource, log);
+		if (program == 0) {
+			probes.addMessage(name(), "skipped, program failed: " + log);
+			return;
+		}
+
+		bool mapBufferRange = (GLEW_VERSION_3_0) || (GLEW_ARB_map_buffer_range);
+		bool sync = (GLEW_VERSION_3_2) || (GLEW_ARB_sync);
+		bool bufferStorage = (GLEW_VERSION_4_4) || (GLEW_ARB_buffer_storage);
+		if ((!mapBufferRange) || (!sync)) {
+			probes.addMessage(name(), "ring buffers skipped, requires GL_ARB_map_buffer_range and GL_ARB_sync");
+		}
+		else if (!bufferStorage) {
+			probes.addMessage(name(), "persistent mapping skipped, requires OpenGL 4.4 or GL_ARB_buffer_storage");
+		}
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		GLuint framebuffer;
+		GLuint renderTarget;
+		GLuint vertexArray;
+		glGenFramebuffers(1, &framebuffer);
+		glGenTextures(1, &renderTarget);
+		glBindTexture(GL_TEXTURE_2D, renderTarget);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTarget, 0);
+		glViewport(0, 0, 64, 64);
+		glGenVertexArrays(1, &vertexArray);
+		glBindVertexArray(vertexArray);
+		glUseProgram(program);
+
+		// Vertex positions within the render target
+		vector<GLfloat> frameData(frameSize / sizeof(GLfloat));
+		for (size_t i = 0; i < frameData.size(); i++) {
+			frameData[i] = (GLfloat)((i * 7919) % 1024) / 1024.0f;
+		}
+		vector<GLfloat> copyDestination(frameData.size());
+		double copyTime = probes.medianTime([&]() {
+			memcpy(copyDestination.data(), frameData.data(), frameSize);
+		});
+		fences.assign(ringFrames, 0);
+
+		auto createBuffer = [&](GLsizeiptr size) {
+			GLuint buffer;
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_ARRAY_BUFFER, buffer);
+			glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+			glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
+			return buffer;
+		};
+		auto deleteBuffer = [&](GLuint buffer) {
+			glDisableVertexAttribArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glDeleteBuffers(1, &buffer);
+		};
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			probes.addMessage(name(), "skipped, render target not complete");
+		}
+		else {
+			GLuint buffer = createBuffer(frameSize);
+			measureStrategy(probes, "glBufferSubData", copyTime, [&](int frame) {
+				glBufferSubData(GL_ARRAY_BUFFER, 0, frameSize, frameData.data());
+			}, false);
+			deleteBuffer(buffer);
+
+			// The driver can hand out new storage while the GPU still reads the previous one
+			buffer = createBuffer(frameSize);
+			measureStrategy(probes, "orphaning", copyTime, [&](int frame) {
+				glBufferData(GL_ARRAY_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, frameSize, frameData.data());
+			}, false);
+			deleteBuffer(buffer);
+
+			if ((mapBufferRange) && (sync)) {
+				// Regions are only reused after their fence has been signaled, so mapping doesn't have to synchronize
+				buffer = createBuffer(frameSize * ringFrames);
+				measureStrategy(probes, "unsynchronized ring", copyTime, [&](int frame) {
+					int region = frame % ringFrames;
+					waitRegion(region);
+					void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, region * frameSize, frameSize, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+					if (mapped != nullptr) {
+						memcpy(mapped, frameData.data(), frameSize);
+						glUnmapBuffer(GL_ARRAY_BUFFER);
+					}
+				}, true);
+				deleteBuffer(buffer);
+
+				if (bufferStorage) {
+					GLbitfield flags[] = { GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT };
+					string strategies[] = { "persistent coherent", "persistent explicit flush" };
+					for (int i = 0; i < 2; i++) {
+						bool coherent = ((flags[i] & GL_MAP_COHERENT_BIT) != 0);
+						glGenBuffers(1, &buffer);
+						glBindBuffer(GL_ARRAY_BUFFER, buffer);
+						glBufferStorage(GL_ARRAY_BUFFER, frameSize * ringFrames, nullptr, flags[i]);
+						glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+						glEnableVertexAttribArray(0);
+						unsigned char* mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, frameSize * ringFrames, flags[i] | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT));
+						if (mapped == nullptr) {
+							probes.addMessage(name(), strategies[i] + " skipped, buffer could not be mapped");
+						}
+						else {
+							measureStrategy(probes, strategies[i], copyTime, [&](int frame) {
+								int region = frame % ringFrames;
+								waitRegion(region);
+								memcpy(mapped + region * frameSize, frameData.data(), frameSize);
+								if (!coherent) {
+									glFlushMappedBufferRange(GL_ARRAY_BUFFER, region * frameSize, frameSize);
+								}
+							}, true);
+							glUnmapBuffer(GL_ARRAY_BUFFER);
+						}
+						deleteBuffer(buffer);
+					}
+				}
+			}
+		}
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteTextures(1, &renderTarget);
+		glDeleteProgram(program);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+}
@@ -0,0 +1,60 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Buffer streaming strategy probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures per frame upload throughput and CPU stalls of the common strategies for streaming dynamic vertex data:
+	/// glBufferSubData, orphaning with glBufferData, an unsynchronized glMapBufferRange ring buffer and persistently mapped
+	/// GL_ARB_buffer_storage ring buffers with coherent and explicitly flushed mappings
+	/// Every frame writes a block of vertices and draws them, so the driver has to deal with data still in use by the GPU
+	/// </summary>
+	class bufferStreamingProbe : public glPerformanceProbe
+	{
+	private:
+		// Fences of the ring buffer regions
+		vector<GLsync> fences;
+		double waitRegion(int region);
+		void fenceRegion(int region);
+		void measureStrategy(glPerformanceProbes& probes, const string& strategy, double copyTime, function<void(int frame)> upload, bool ring);
+	public:
+		// Bytes written per frame
+		int frameSize = 1 << 20;
+		// Frames per timed sample
+		int framesPerSample = 16;
+		// Frames in flight for the ring buffers
+		int ringFrames = 3;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+	};
+
+}
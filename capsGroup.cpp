@@ -36,13 +36,17 @@ namespace capsViewer {
 		string errorValue = "n/a";
 		// Flush OpenGL error state
 		glGetError();
+		GLint glerr = GL_NO_ERROR;
+		// Only the query itself is timed, stamps are not taken if profiling is disabled
+		glQueryProfiler::clock::time_point queryStart;
+		glQueryProfiler::clock::time_point queryEnd;
 
 		if (type == "glint") 
 		{
 			GLint* intVal;
 			intVal = new GLint[dim];
-			glGetIntegerv(id, intVal);
-			GLint glerr = glGetError();
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glGetIntegerv(id, intVal); });
+			glerr = glGetError();
 			if (dim == 1)
 			{
 				capabilities[idstr] = to_string(intVal[0]);
@@ -61,7 +65,7 @@ namespace capsViewer {
 		{
 			GLint64* intVal;
 			intVal = new GLint64[dim];
-			glGetInteger64v(id, intVal);
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glGetInteger64v(id, intVal); });
 			string valString = "";
 			for (int i = 0; i < dim; i++) {
 				if (i > 0) {
@@ -69,7 +73,7 @@ namespace capsViewer {
 				}
 				valString += to_string(intVal[i]);
 			}
-			GLint glerr = glGetError();
+			glerr = glGetError();
 			capabilities[idstr] = valString;
 			if (glerr != GL_NO_ERROR) {
 				capabilities[idstr] = errorValue;
@@ -81,9 +85,11 @@ namespace capsViewer {
 		{
 			GLint *intVal;
 			intVal = new GLint[dim];
-			for (int i = 0; i < dim; i++) 
-				glGetIntegeri_v(id, i, &intVal[i]);
-			GLint glerr = glGetError();
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() {
+				for (int i = 0; i < dim; i++)
+					glGetIntegeri_v(id, i, &intVal[i]);
+			});
+			glerr = glGetError();
 			if (dim == 1)
 			{
 				capabilities[idstr] = to_string(intVal[0]);
@@ -103,7 +109,7 @@ namespace capsViewer {
 		{
 			GLint* intVal;
 			intVal = new GLint[dim];
-			glGetProgramivARB(GL_FRAGMENT_PROGRAM_ARB, id, intVal);
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glGetProgramivARB(GL_FRAGMENT_PROGRAM_ARB, id, intVal); });
 			string valString = "";
 			for (int i = 0; i < dim; i++) {
 				if (i > 0) {
@@ -111,7 +117,7 @@ namespace capsViewer {
 				}
 				valString += to_string(intVal[i]);
 			}
-			GLint glerr = glGetError();
+			glerr = glGetError();
 			capabilities[idstr] = valString;
 			if (glerr != GL_NO_ERROR) {
 				capabilities[idstr] = errorValue;
@@ -123,7 +129,7 @@ namespace capsViewer {
 		{
 			GLint* intVal;
 			intVal = new GLint[dim];
-			glGetProgramivARB(GL_VERTEX_PROGRAM_ARB, id, intVal);
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glGetProgramivARB(GL_VERTEX_PROGRAM_ARB, id, intVal); });
 			string valString = "";
 			for (int i = 0; i < dim; i++) {
 				if (i > 0) {
@@ -131,7 +137,7 @@ namespace capsViewer {
 				}
 				valString += to_string(intVal[i]);
 			}
-			GLint glerr = glGetError();
+			glerr = glGetError();
 			capabilities[idstr] = valString;
 			if (glerr != GL_NO_ERROR) {
 				capabilities[idstr] = errorValue;
@@ -143,7 +149,7 @@ namespace capsViewer {
 		{
 			GLfloat* floatVal;
 			floatVal = new GLfloat[dim];
-			glGetFloatv(id, floatVal);
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glGetFloatv(id, floatVal); });
 			string valString = "";
 			for (int i = 0; i < dim; i++) {
 				if (i > 0) {
@@ -151,7 +157,7 @@ namespace capsViewer {
 				}
 				valString += to_string(floatVal[i]);
 			}
-			GLint glerr = glGetError();
+			glerr = glGetError();
 			capabilities[idstr] = valString;
 			if (glerr != GL_NO_ERROR) {
 				capabilities[idstr] = errorValue;
@@ -161,13 +167,19 @@ namespace capsViewer {
 
 		if (type == "glstring") 
 		{
-			string valString = reinterpret_cast<const char*>(glGetString(id));
-			GLint glerr = glGetError();
+			const GLubyte* glString = nullptr;
+			glQueryProfiler::timeQuery(profiler, queryStart, queryEnd, [&]() { glString = glGetString(id); });
+			string valString = reinterpret_cast<const char*>(glString);
+			glerr = glGetError();
 			capabilities[idstr] = valString;
 			if (glerr != GL_NO_ERROR) {
 				capabilities[idstr] = "";
 			}
 		}
+
+		if ((profiler != nullptr) && (profiler->enabled)) {
+			profiler->recordCap(idstr, id, queryStart, queryEnd, glerr);
+		}
 	}
 
 }
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include <string>
 #include <map>
 #include <GL/glew.h>
+#include "glQueryProfiler.h"
 
 using namespace std;
 
@@ -40,6 +41,7 @@ namespace capsViewer {
 		string name;
 		bool supported;
 		bool visible = true;
+		glQueryProfiler* profiler = nullptr;
 		void addCapability(string idstr, GLenum id, string type, int dim);
 	};
 
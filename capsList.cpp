@@ -0,0 +1,128 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* OpenGL capability list (capslist.xml) definitions
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "capsList.h"
+#include <QXmlStreamReader>
+#include <fstream>
+#include <iterator>
+#include <cstdlib>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Loads the capability list from an xml file
+	/// </summary>
+	/// <param name="fileName">Name of the xml file (usually capslist.xml)</param>
+	/// <returns>false if the xml could not be parsed</returns>
+	bool capsList::loadFromFile(string fileName)
+	{
+		ifstream capsListXml(fileName);
+		vector<char> buffer((istreambuf_iterator<char>(capsListXml)), istreambuf_iterator<char>());
+		buffer.push_back('\0');
+		return loadFromXml(&buffer[0]);
+	}
+
+	/// <summary>
+	/// Parses the categories, their requirements and caps from the capability list xml
+	/// </summary>
+	/// <param name="xml">Zero terminated xml string</param>
+	/// <returns>false if the xml could not be parsed</returns>
+	bool capsList::loadFromXml(const char* xml)
+	{
+		categories.clear();
+
+		QXmlStreamReader xmlStream(xml);
+
+		while (!xmlStream.atEnd()) {
+
+			xmlStream.readNext();
+
+			if (xmlStream.name() == "category") {
+				QXmlStreamAttributes nodeAttribs = xmlStream.attributes();
+				capsCategory category;
+				category.name = nodeAttribs.value("name").toString().toStdString();
+
+				while (!xmlStream.atEnd()) {
+
+					xmlStream.readNext();
+
+					if ((xmlStream.name() == "requirements") && (xmlStream.isStartElement())) {
+						QXmlStreamAttributes nodeAttribs = xmlStream.attributes();
+						category.hasRequirements = true;
+						category.requiredExtension = nodeAttribs.value("extension").toString().toStdString();
+						category.requiredVersion = nodeAttribs.value("version").toString().toStdString();
+					}
+
+					if ((xmlStream.name() == "cap") && (xmlStream.isStartElement())) {
+						QXmlStreamAttributes nodeAttribs = xmlStream.attributes();
+						capDefinition cap;
+						cap.name = nodeAttribs.value("name").toString().toStdString();
+						cap.type = nodeAttribs.value("type").toString().toStdString();
+						cap.components = nodeAttribs.value("components").toInt();
+						cap.id = strtoul(nodeAttribs.value("enum").toString().toStdString().c_str(), 0, 16);
+						category.caps.push_back(cap);
+					}
+
+					if (xmlStream.name() == "category") {
+						break;
+					}
+
+				}
+
+				categories.push_back(category);
+			}
+
+		}
+
+		return (!xmlStream.hasError());
+	}
+
+	/// <summary>
+	/// Names of all caps stored as a single integer value in reports, caps with multiple components stored as separate values are listed per component (name[i])
+	/// Float caps and caps stored as a list of values (e.g. "1 ,2") are not included
+	/// </summary>
+	vector<string> capsList::integerCapNames() const
+	{
+		vector<string> names;
+		for (auto& category : categories) {
+			for (auto& cap : category.caps) {
+				if ((cap.type == "glint") || (cap.type == "glintindex")) {
+					if (cap.components == 1) {
+						names.push_back(cap.name);
+					}
+					else {
+						for (int i = 0; i < cap.components; i++) {
+							names.push_back(cap.name + "[" + to_string(i) + "]");
+						}
+					}
+				}
+				else if (((cap.type == "glint64") || (cap.type == "glintfragmentprogram") || (cap.type == "glintvertexprogram")) && (cap.components == 1)) {
+					names.push_back(cap.name);
+				}
+			}
+		}
+		return names;
+	}
+
+}
@@ -0,0 +1,61 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* OpenGL capability list (capslist.xml) definitions
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class capDefinition
+	{
+	public:
+		string name;
+		GLenum id;
+		string type;
+		int components;
+	};
+
+	class capsCategory
+	{
+	public:
+		string name;
+		bool hasRequirements = false;
+		string requiredExtension;
+		string requiredVersion;
+		vector<capDefinition> caps;
+	};
+
+	class capsList
+	{
+	public:
+		vector<capsCategory> categories;
+		bool loadFromFile(string fileName);
+		bool loadFromXml(const char* xml);
+		vector<string> integerCapNames() const;
+	};
+
+}
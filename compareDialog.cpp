@@ -0,0 +1,200 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Side by side comparison of the local report and locally available reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "compareDialog.h"
+#include "workStealingPool.h"
+
+#include <QApplication>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QDialogButtonBox>
+#include <QMessageBox>
+#include <fstream>
+#include <iterator>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Lists the local report and all given reports, checked reports are compared
+	/// </summary>
+	/// <param name="localReport">Current report, can be NULL if no report has been generated</param>
+	/// <param name="reports">Locally available reports (database reports and imported reports)</param>
+	compareDialog::compareDialog(const reportData* localReport, const vector<indexedReport>& reports, function<string(GLint)> getEnumName, QWidget * parent, Qt::WindowFlags f) : QDialog(parent, f)
+	{
+		hasLocalReport = (localReport != NULL);
+		if (hasLocalReport) {
+			this->localReport = *localReport;
+		}
+		this->reports = reports;
+		comparison.getEnumName = getEnumName;
+
+		QVBoxLayout *layout = new QVBoxLayout;
+
+		QLabel* labelCaption = new QLabel();
+		labelCaption->setText("Reports to compare");
+		labelCaption->setStyleSheet("font: 75 11pt;");
+		layout->addWidget(labelCaption);
+
+		listReports = new QListWidget();
+		listReports->setObjectName("listReports");
+		listReports->setMaximumHeight(160);
+		for (size_t i = 0; i < reports.size(); i++) {
+			if (reports[i].fileName.empty()) {
+				continue;
+			}
+			QString text = QString::fromStdString(reports[i].renderer + " - " + reports[i].version);
+			if (!reports[i].operatingSystem.empty()) {
+				text += " (" + QString::fromStdString(reports[i].operatingSystem) + ")";
+			}
+			QListWidgetItem *item = new QListWidgetItem(text, listReports);
+			item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+			item->setCheckState(Qt::Unchecked);
+			item->setData(Qt::UserRole, (int)i);
+		}
+		listReports->sortItems();
+		if (hasLocalReport) {
+			QListWidgetItem *item = new QListWidgetItem("Local report : " + QString::fromStdString(this->localReport.description));
+			item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+			item->setCheckState(Qt::Checked);
+			item->setData(Qt::UserRole, -1);
+			item->setTextColor(QColor::fromRgb(50, 180, 50));
+			listReports->insertItem(0, item);
+		}
+		layout->addWidget(listReports);
+
+		QHBoxLayout *filterLayout = new QHBoxLayout;
+		QPushButton *buttonCompare = new QPushButton("Compare");
+		connect(buttonCompare, SIGNAL(released()), this, SLOT(slotCompare()));
+		filterLayout->addWidget(buttonCompare);
+		editFilter = new QLineEdit();
+		editFilter->setObjectName("editFilter");
+		editFilter->setPlaceholderText("Filter");
+		connect(editFilter, SIGNAL(textChanged(QString)), this, SLOT(slotFilter()));
+		filterLayout->addWidget(editFilter);
+		comboSection = new QComboBox();
+		comboSection->addItems(QStringList() << "All" << "Capabilities" << "Extensions" << "Compressed formats" << "Internal formats");
+		connect(comboSection, SIGNAL(currentIndexChanged(int)), this, SLOT(slotFilter()));
+		filterLayout->addWidget(comboSection);
+		checkBoxDifferences = new QCheckBox("Differences only");
+		connect(checkBoxDifferences, SIGNAL(toggled(bool)), this, SLOT(slotFilter()));
+		filterLayout->addWidget(checkBoxDifferences);
+		labelSummary = new QLabel();
+		filterLayout->addWidget(labelSummary);
+		filterLayout->addStretch();
+		layout->addLayout(filterLayout);
+
+		tableComparison = new QTableView();
+		tableComparison->setModel(&comparisonModel);
+		tableComparison->setSelectionBehavior(QAbstractItemView::SelectRows);
+		tableComparison->horizontalHeader()->setDefaultAlignment(Qt::AlignLeft);
+		tableComparison->horizontalHeader()->setDefaultSectionSize(200);
+		tableComparison->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+		tableComparison->verticalHeader()->setDefaultSectionSize(24);
+		tableComparison->verticalHeader()->setVisible(false);
+		layout->addWidget(tableComparison);
+
+		QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+		connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+		layout->addWidget(buttonBox);
+
+		setLayout(layout);
+		setWindowTitle("Compare reports");
+		setWindowIcon(QIcon(":/glcapsviewer/Resources/compare24.png"));
+		resize(1024, 700);
+	}
+
+	compareDialog::~compareDialog()
+	{
+	}
+
+	/// <summary>
+	/// Reads all checked reports (in parallel) and compares them in list order
+	/// </summary>
+	void compareDialog::slotCompare()
+	{
+		// Index into the report list, -1 for the local report
+		vector<int> selection;
+		for (int i = 0; i < listReports->count(); i++) {
+			QListWidgetItem *item = listReports->item(i);
+			if (item->checkState() == Qt::Checked) {
+				selection.push_back(item->data(Qt::UserRole).toInt());
+			}
+		}
+		if (selection.size() < 2) {
+			QMessageBox::warning(this, tr("Compare reports"), tr("Please select at least two reports to compare."));
+			return;
+		}
+
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		vector<reportData> selectedReports(selection.size());
+		vector<uint8_t> loaded(selection.size(), 0);
+		workStealingPool pool;
+		for (size_t i = 0; i < selection.size(); i++) {
+			if (selection[i] == -1) {
+				selectedReports[i] = localReport;
+				loaded[i] = 1;
+				continue;
+			}
+			const string& fileName = reports[selection[i]].fileName;
+			pool.submit([&selectedReports, &loaded, &fileName, i](int) {
+				ifstream file(fileName, ios::binary);
+				string xml((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+				loaded[i] = ((!xml.empty()) && (selectedReports[i].fromXml(xml))) ? 1 : 0;
+			});
+		}
+		pool.wait();
+
+		comparison.clear();
+		int failed = 0;
+		for (size_t i = 0; i < selection.size(); i++) {
+			if (!loaded[i]) {
+				failed++;
+				continue;
+			}
+			if (selection[i] == -1) {
+				comparison.addReport(selectedReports[i], "Local report");
+			}
+			else {
+				const indexedReport& info = reports[selection[i]];
+				comparison.addReport(selectedReports[i], info.renderer + "\n" + info.version);
+			}
+		}
+		comparisonModel.setComparison(&comparison);
+		slotFilter();
+		QApplication::restoreOverrideCursor();
+
+		if (failed > 0) {
+			QMessageBox::warning(this, tr("Compare reports"), tr("%1 reports could not be read.").arg(failed));
+		}
+	}
+
+	void compareDialog::slotFilter()
+	{
+		comparisonModel.setFilter(editFilter->text(), comboSection->currentIndex() - 1, checkBoxDifferences->isChecked());
+		labelSummary->setText(QString::number(comparison.rowCount()) + " rows, " + QString::number(comparison.differenceCount()) + " with differences, " + QString::number(comparisonModel.rowCount()) + " shown");
+	}
+
+}
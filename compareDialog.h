@@ -0,0 +1,61 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Side by side comparison of the local report and locally available reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+#include <QDialog>
+#include <QListWidget>
+#include <QTableView>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <vector>
+#include "reportComparison.h"
+#include "reportComparisonModel.h"
+#include "reportIndex.h"
+
+namespace capsViewer {
+
+	class compareDialog : public QDialog
+	{
+		Q_OBJECT
+	private:
+		reportData localReport;
+		bool hasLocalReport;
+		std::vector<indexedReport> reports;
+		reportComparison comparison;
+		reportComparisonModel comparisonModel;
+		QListWidget *listReports;
+		QTableView *tableComparison;
+		QLineEdit *editFilter;
+		QComboBox *comboSection;
+		QCheckBox *checkBoxDifferences;
+		QLabel *labelSummary;
+	public:
+		compareDialog(const reportData* localReport, const std::vector<indexedReport>& reports, std::function<std::string(GLint)> getEnumName, QWidget * parent = 0, Qt::WindowFlags f = 0);
+		~compareDialog();
+	private slots:
+		void slotCompare();
+		void slotFilter();
+	};
+
+}
@@ -0,0 +1,286 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Compressed format upload and sampling probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "compressedFormatProbe.h"
+#include "glCapsViewerCore.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string compressedFormatProbe::name() const
+	{
+		return "compressedformats";
+	}
+
+	bool compressedFormatProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		if (core.compressedFormats.empty()) {
+			reason = "no compressed formats";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Block dimensions of common compressed formats, other formats use the block size reported by the internal format sweep (requires GL_ARB_internalformat_query2)
+	/// </summary>
+	/// <returns>false for unknown formats</returns>
+	bool compressedFormatProbe::blockSize(GLenum format, GLint& width, GLint& height, GLint& size)
+	{
+		// ASTC formats are numbered by footprint, all blocks are 16 bytes
+		const GLint astcFootprints[][2] = { { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 }, { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 } };
+		for (GLenum astcBase : { (GLenum)GL_COMPRESSED_RGBA_ASTC_4x4_KHR, (GLenum)GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR }) {
+			if ((format >= astcBase) && (format < astcBase + 14)) {
+				width = astcFootprints[format - astcBase][0];
+				height = astcFootprints[format - astcBase][1];
+				size = 16;
+				return true;
+			}
+		}
+		width = 4;
+		height = 4;
+		switch (format) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+		case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+			size = 8;
+			return true;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+			size = 16;
+			return true;
+		}
+		return false;
+	}
+
+	/// <returns>Median time of a fullscreen pass sampling the texture in microseconds</returns>
+	double compressedFormatProbe::measureSampling(glPerformanceProbes& probes, GLuint texture, GLuint program)
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glUseProgram(program);
+		double time = probes.medianTime([&]() {
+			for (int i = 0; i < passesPerSample; i++) {
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		glUseProgram(0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return time / passesPerSample;
+	}
+
+	void compressedFormatProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		string fragmentSource =
+			"#version 330\n"
+			"uniform sampler2D source;\n"
+			"in vec2 uv;\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	color = texture(source, uv);\n"
+			"}\n";
+		string log;
+		GLuint program = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource, log);
+		if (program == 0) {
+			probes.addMessage(name(), "skipped, sampling program failed: " + log);
+			return;
+		}
+
+		GLint unpackAlignment;
+		GLint viewport[4];
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// Uploads read from client memory, the caller's bindings are restored by glPerformanceProbes
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// Fullscreen passes render into an offscreen GL_RGBA8 target of the maximum texture size
+		GLuint vertexArray;
+		GLuint framebuffer;
+		GLuint renderTarget;
+		glGenVertexArrays(1, &vertexArray);
+		glGenFramebuffers(1, &framebuffer);
+		glGenTextures(1, &renderTarget);
+		glBindTexture(GL_TEXTURE_2D, renderTarget);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTarget, 0);
+		glBindVertexArray(vertexArray);
+		glViewport(0, 0, textureSize, textureSize);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			probes.addMessage(name(), "sampling skipped, render target not complete");
+		}
+		bool canSample = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+		const internalFormatTarget* target = core.getInternalFormatTarget(GL_TEXTURE_2D);
+		// Deterministic content, zero blocks may be special cased by decoders
+		unsigned int seed = 0x2545F491;
+		auto random = [&]() {
+			seed = seed * 1664525u + 1013904223u;
+			return (unsigned char)(seed >> 24);
+		};
+
+		// Uncompressed reference times per texel, measured once for the size of each block footprint
+		double referenceUpload = 0.0;
+		double referenceSampling = 0.0;
+		GLint referenceWidth = 0;
+		GLint referenceHeight = 0;
+
+		for (auto& compressedFormat : core.compressedFormats) {
+			GLenum format = (GLenum)compressedFormat;
+			string formatName = core.getEnumName(format);
+			GLint blockWidth = 0;
+			GLint blockHeight = 0;
+			GLint blockBytes = 0;
+			// Known formats use the table, others the block size of the internal format sweep
+			if (!blockSize(format, blockWidth, blockHeight, blockBytes)) {
+				const internalFormatInfo* formatInfo = nullptr;
+				if (target != nullptr) {
+					for (auto& textureFormat : target->textureFormats) {
+						if (textureFormat.textureFormat == format) {
+							formatInfo = &textureFormat;
+						}
+					}
+				}
+				if ((formatInfo == nullptr) || (!formatInfo->getValue(GL_TEXTURE_COMPRESSED_BLOCK_WIDTH, blockWidth)) || (!formatInfo->getValue(GL_TEXTURE_COMPRESSED_BLOCK_HEIGHT, blockHeight)) ||
+					(!formatInfo->getValue(GL_TEXTURE_COMPRESSED_BLOCK_SIZE, blockBytes)) || (blockWidth <= 0) || (blockHeight <= 0) || (blockBytes <= 0)) {
+					probes.addMessage(name(), formatName + " skipped, unknown block size");
+					continue;
+				}
+				// Some implementations report the block size in bits instead of bytes, blocks of all compressed formats are at most 16 bytes
+				if ((blockBytes > 16) && (blockBytes % 8 == 0)) {
+					blockBytes /= 8;
+				}
+			}
+
+			GLsizei width = (textureSize / blockWidth) * blockWidth;
+			GLsizei height = (textureSize / blockHeight) * blockHeight;
+			vector<unsigned char> data((width / blockWidth) * (height / blockHeight) * blockBytes);
+			for (auto& value : data) {
+				value = random();
+			}
+
+			if ((width != referenceWidth) || (height != referenceHeight)) {
+				vector<unsigned char> referenceData(width * height * 4);
+				for (auto& value : referenceData) {
+					value = random();
+				}
+				GLuint referenceTexture;
+				glGenTextures(1, &referenceTexture);
+				glBindTexture(GL_TEXTURE_2D, referenceTexture);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+				referenceUpload = probes.medianTime([&]() {
+					for (int i = 0; i < uploadsPerSample; i++) {
+						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, referenceData.data());
+					}
+				}) / uploadsPerSample;
+				referenceSampling = (canSample) ? measureSampling(probes, referenceTexture, program) : 0.0;
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glDeleteTextures(1, &referenceTexture);
+				referenceWidth = width;
+				referenceHeight = height;
+			}
+
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+			glPerformanceProbes::clearErrors();
+			glCompressedTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, (GLsizei)data.size(), data.data());
+			if (glGetError() != GL_NO_ERROR) {
+				probes.addMessage(name(), formatName + " skipped, texture could not be created");
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glDeleteTextures(1, &texture);
+				continue;
+			}
+			double upload = probes.medianTime([&]() {
+				for (int i = 0; i < uploadsPerSample; i++) {
+					glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, (GLsizei)data.size(), data.data());
+				}
+			}) / uploadsPerSample;
+			// Some formats (e.g. ETC1) only allow whole images to be specified
+			if (glGetError() != GL_NO_ERROR) {
+				probes.addMessage(name(), formatName + " upload skipped, glCompressedTexSubImage2D not supported");
+				upload = 0.0;
+			}
+			double sampling = (canSample) ? measureSampling(probes, texture, program) : 0.0;
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glDeleteTextures(1, &texture);
+
+			bool softwareDecode = false;
+			if ((upload > 0.0) && (referenceUpload > 0.0)) {
+				double uploadRatio = upload / referenceUpload;
+				probes.addValue(name(), formatName, "upload_us", upload);
+				probes.addValue(name(), formatName, "upload_mbps", (double)data.size() / upload);
+				probes.addValue(name(), formatName, "upload_ratio", uploadRatio);
+				softwareDecode = (uploadRatio >= uploadThreshold);
+			}
+			if ((sampling > 0.0) && (referenceSampling > 0.0)) {
+				double samplingRatio = sampling / referenceSampling;
+				probes.addValue(name(), formatName, "sample_us", sampling);
+				probes.addValue(name(), formatName, "sample_ratio", samplingRatio);
+				softwareDecode = softwareDecode || (samplingRatio >= samplingThreshold);
+			}
+			probes.addValue(name(), formatName, "software_decode", softwareDecode ? 1.0 : 0.0);
+		}
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteTextures(1, &renderTarget);
+		glDeleteProgram(program);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	}
+
+}
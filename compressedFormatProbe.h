@@ -0,0 +1,59 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Compressed format upload and sampling probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures glCompressedTexSubImage2D upload time and the cost of sampling the texture in a fullscreen pass for every format in GL_COMPRESSED_TEXTURE_FORMATS,
+	/// both relative to an uncompressed GL_RGBA8 texture of the same size
+	/// Formats decoded by the driver on the CPU upload slower per texel than uncompressed data although they are a fraction of its size, formats decoded per fetch sample slower
+	/// </summary>
+	class compressedFormatProbe : public glPerformanceProbe
+	{
+	private:
+		double measureSampling(glPerformanceProbes& probes, GLuint texture, GLuint program);
+	public:
+		// Maximum width and height of the uploaded textures, rounded down to a multiple of the block size
+		int textureSize = 1024;
+		// Uploads and fullscreen passes per timed sample
+		int uploadsPerSample = 4;
+		int passesPerSample = 4;
+		// A format is flagged as decoded in software if its upload time per texel relative to GL_RGBA8 reaches uploadThreshold
+		// or its sampling time relative to GL_RGBA8 reaches samplingThreshold
+		double uploadThreshold = 1.0;
+		double samplingThreshold = 2.0;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static bool blockSize(GLenum format, GLint& width, GLint& height, GLint& size);
+	};
+
+}
@@ -0,0 +1,197 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Draw call submission overhead probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "drawSubmissionProbe.h"
+#include "glCapsViewerCore.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string drawSubmissionProbe::name() const
+	{
+		return "drawsubmission";
+	}
+
+	bool drawSubmissionProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Times issuing the draws (CPU submission) and issuing plus executing them, the pipeline is drained before each sample
+	/// </summary>
+	void drawSubmissionProbe::measurePath(glPerformanceProbes& probes, const string& path, function<void()> submit)
+	{
+		probeSamples submitSamples;
+		probeSamples totalSamples;
+		glPerformanceProbes::clearErrors();
+		// First sample is the warm up
+		for (int i = 0; i <= probes.sampleCount; i++) {
+			glFinish();
+			glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+			submit();
+			glPerformanceProbes::clock::time_point submitted = glPerformanceProbes::clock::now();
+			glFinish();
+			glPerformanceProbes::clock::time_point finished = glPerformanceProbes::clock::now();
+			if (i > 0) {
+				submitSamples.add(chrono::duration<double, micro>(submitted - start).count());
+				totalSamples.add(chrono::duration<double, micro>(finished - start).count());
+			}
+		}
+		if (glGetError() != GL_NO_ERROR) {
+			probes.addMessage(name(), path + " skipped, draws failed");
+			return;
+		}
+		double submitTime = submitSamples.median();
+		double totalTime = totalSamples.median();
+		probes.addValue(name(), path, "submit_ns_per_draw", submitTime * 1000.0 / drawCount);
+		probes.addValue(name(), path, "submit_draws_per_s", (submitTime > 0.0) ? drawCount / submitTime * 1000000.0 : 0.0);
+		probes.addValue(name(), path, "draws_per_s", (totalTime > 0.0) ? drawCount / totalTime * 1000000.0 : 0.0);
+	}
+
+	void drawSubmissionProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// Instances are spread over the render target on the same grid as the triangles of the individual draws
+		string vertexSource =
+			"#version 330\n"
+			"layout(location = 0) in vec2 position;\n"
+			"void main()\n"
+			"{\n"
+			"	vec2 offset = vec2(gl_InstanceID % 64, (gl_InstanceID / 64) % 64) / 32.0;\n"
+			"	gl_Position = vec4(position + offset, 0.0, 1.0);\n"
+			"}\n";
+		string fragmentSource =
+			"#version 330\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	color = vec4(1.0);\n"
+			"}\n";
+		string log;
+		GLuint program = glPerformanceProbes::createProgram(vertexSource, fragmentSource, log);
+		if (program == 0) {
+			probes.addMessage(name(), "skipped, program failed: " + log);
+			return;
+		}
+
+		// Optional paths are checked with the GLEW flags like the probe requirements
+		bool multiDrawIndirect = (GLEW_VERSION_4_3) || (GLEW_ARB_multi_draw_indirect);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		// One small triangle per draw with its own three indices
+		vector<GLfloat> vertices;
+		vector<GLuint> indices;
+		for (int i = 0; i < drawCount; i++) {
+			float x = (float)(i % 64) / 32.0f - 1.0f;
+			float y = (float)((i / 64) % 64) / 32.0f - 1.0f;
+			GLfloat triangle[] = { x, y, x + 0.03f, y, x, y + 0.03f };
+			vertices.insert(vertices.end(), triangle, triangle + 6);
+			for (GLuint v = 0; v < 3; v++) {
+				indices.push_back(i * 3 + v);
+			}
+		}
+
+		GLuint framebuffer;
+		GLuint renderTarget;
+		GLuint vertexArray;
+		GLuint buffers[2];
+		glGenFramebuffers(1, &framebuffer);
+		glGenTextures(1, &renderTarget);
+		glBindTexture(GL_TEXTURE_2D, renderTarget);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, framebufferSize, framebufferSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTarget, 0);
+		glViewport(0, 0, framebufferSize, framebufferSize);
+		glGenVertexArrays(1, &vertexArray);
+		glGenBuffers(2, buffers);
+		glBindVertexArray(vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		glUseProgram(program);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			probes.addMessage(name(), "skipped, render target not complete");
+		}
+		else {
+			measurePath(probes, "glDrawElements", [&]() {
+				for (int i = 0; i < drawCount; i++) {
+					glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, (const void*)(i * 3 * sizeof(GLuint)));
+				}
+			});
+
+			vector<GLsizei> counts(drawCount, 3);
+			vector<const void*> offsets(drawCount);
+			for (int i = 0; i < drawCount; i++) {
+				offsets[i] = (const void*)(i * 3 * sizeof(GLuint));
+			}
+			measurePath(probes, "glMultiDrawElements", [&]() {
+				glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), drawCount);
+			});
+
+			// Same number of triangles as a single draw call
+			measurePath(probes, "glDrawElementsInstanced", [&]() {
+				glDrawElementsInstanced(GL_TRIANGLES, 3, GL_UNSIGNED_INT, nullptr, drawCount);
+			});
+
+			if (multiDrawIndirect) {
+				// count, instanceCount, firstIndex, baseVertex, baseInstance
+				vector<GLuint> commands;
+				for (int i = 0; i < drawCount; i++) {
+					GLuint command[] = { 3, 1, (GLuint)i * 3, 0, 0 };
+					commands.insert(commands.end(), command, command + 5);
+				}
+				GLuint indirectBuffer;
+				glGenBuffers(1, &indirectBuffer);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+				glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(GLuint), commands.data(), GL_STATIC_DRAW);
+				measurePath(probes, "glMultiDrawElementsIndirect", [&]() {
+					glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, drawCount, 0);
+				});
+				glDeleteBuffers(1, &indirectBuffer);
+			}
+			else {
+				probes.addMessage(name(), "glMultiDrawElementsIndirect skipped, requires OpenGL 4.3 or GL_ARB_multi_draw_indirect");
+			}
+		}
+
+		glDeleteBuffers(2, buffers);
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteTextures(1, &renderTarget);
+		glDeleteProgram(program);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+}
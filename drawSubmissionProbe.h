@@ -0,0 +1,53 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Draw call submission overhead probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures the cost of submitting thousands of tiny indexed draws (one triangle each) with individual glDrawElements calls, glMultiDrawElements,
+	/// one instanced draw and glMultiDrawElementsIndirect (OpenGL 4.3 or GL_ARB_multi_draw_indirect)
+	/// The CPU time to issue the draws and the time until they have been executed are reported separately
+	/// </summary>
+	class drawSubmissionProbe : public glPerformanceProbe
+	{
+	private:
+		void measurePath(glPerformanceProbes& probes, const string& path, function<void()> submit);
+	public:
+		// Draws per sample
+		int drawCount = 4096;
+		// Width and height of the render target, small so the draws are not fill rate bound
+		int framebufferSize = 64;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+	};
+
+}
@@ -0,0 +1,255 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Changes of a device's capabilities across driver versions
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "driverTimeline.h"
+#include "reportQuery.h"
+#include <algorithm>
+#include <sstream>
+#include <cctype>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	int timelineStep::regressionCount() const
+	{
+		int count = 0;
+		for (auto& change : changes) {
+			count += change.regression ? 1 : 0;
+		}
+		return count;
+	}
+
+	void driverTimeline::clear()
+	{
+		versions.clear();
+		steps.clear();
+	}
+
+	/// <summary>
+	/// Adds a report of the device, the order is not relevant
+	/// </summary>
+	/// <param name="version">Driver version as listed by the database (e.g. "4.5.0 NVIDIA 368.81")</param>
+	void driverTimeline::addReport(int reportId, const string& version, const string& operatingSystem, const reportData& report)
+	{
+		timelineVersion entry;
+		entry.reportId = reportId;
+		entry.version = version;
+		entry.operatingSystem = operatingSystem;
+		entry.report = report;
+		versions.push_back(entry);
+	}
+
+	/// <summary>
+	/// Compares version strings with numbers compared by value, so "368.9" < "368.81" and "15.9" < "15.12"
+	/// </summary>
+	bool driverTimeline::versionLess(const string& a, const string& b)
+	{
+		size_t i = 0;
+		size_t j = 0;
+		while ((i < a.size()) && (j < b.size())) {
+			if ((isdigit((unsigned char)a[i])) && (isdigit((unsigned char)b[j]))) {
+				size_t numberStartA = i;
+				size_t numberStartB = j;
+				while ((i < a.size()) && (a[i] == '0')) {
+					i++;
+				}
+				while ((j < b.size()) && (b[j] == '0')) {
+					j++;
+				}
+				size_t digitsA = i;
+				size_t digitsB = j;
+				while ((i < a.size()) && (isdigit((unsigned char)a[i]))) {
+					i++;
+				}
+				while ((j < b.size()) && (isdigit((unsigned char)b[j]))) {
+					j++;
+				}
+				// Without leading zeros the longer number is the larger one
+				if (i - digitsA != j - digitsB) {
+					return (i - digitsA) < (j - digitsB);
+				}
+				int order = a.compare(digitsA, i - digitsA, b, digitsB, j - digitsB);
+				if (order != 0) {
+					return order < 0;
+				}
+				if (i - numberStartA != j - numberStartB) {
+					return (i - numberStartA) < (j - numberStartB);
+				}
+				continue;
+			}
+			if (a[i] != b[j]) {
+				return a[i] < b[j];
+			}
+			i++;
+			j++;
+		}
+		return (a.size() - i) < (b.size() - j);
+	}
+
+	/// <summary>
+	/// Classifies a difference between two driver versions
+	/// Numeric caps that decrease are regressions, except for minimums (GL_MIN_*) where an increase is worse
+	/// </summary>
+	timelineChange classifyChange(const reportDiffEntry& entry)
+	{
+		timelineChange change;
+		change.section = entry.section;
+		change.name = entry.name;
+		change.oldValue = entry.baseValue;
+		change.newValue = entry.otherValue;
+		// Caps that become (un)available are additions and removals, not changed values
+		diffType type = entry.type;
+		if ((type == diffChanged) && (!reportData::isAvailable(entry.otherValue))) {
+			type = diffRemoved;
+		}
+		else if ((type == diffChanged) && (!reportData::isAvailable(entry.baseValue))) {
+			type = diffAdded;
+		}
+		switch (type) {
+		case diffAdded:
+		case diffMissing:
+			change.type = timelineAdded;
+			break;
+		case diffRemoved:
+			change.type = timelineRemoved;
+			change.regression = true;
+			break;
+		case diffChanged:
+		{
+			int64_t oldValue;
+			int64_t newValue;
+			if ((reportQuery::parseValue(entry.baseValue, oldValue)) && (reportQuery::parseValue(entry.otherValue, newValue))) {
+				change.type = (newValue > oldValue) ? timelineIncreased : timelineDecreased;
+				bool minimum = (entry.name.find("_MIN_") != string::npos);
+				change.regression = (minimum) ? (change.type == timelineIncreased) : (change.type == timelineDecreased);
+			}
+			else {
+				change.type = timelineChanged;
+			}
+			break;
+		}
+		}
+		return change;
+	}
+
+	/// <summary>
+	/// Orders the reports by operating system and driver version and compares consecutive versions
+	/// </summary>
+	void driverTimeline::build()
+	{
+		stable_sort(versions.begin(), versions.end(), [](const timelineVersion& a, const timelineVersion& b) {
+			if (a.operatingSystem != b.operatingSystem) {
+				return a.operatingSystem < b.operatingSystem;
+			}
+			if (a.version != b.version) {
+				return versionLess(a.version, b.version);
+			}
+			return a.reportId < b.reportId;
+		});
+
+		steps.clear();
+		for (size_t i = 1; i < versions.size(); i++) {
+			const timelineVersion& from = versions[i - 1];
+			const timelineVersion& to = versions[i];
+			if (from.operatingSystem != to.operatingSystem) {
+				continue;
+			}
+			timelineStep step;
+			step.operatingSystem = to.operatingSystem;
+			step.fromReportId = from.reportId;
+			step.toReportId = to.reportId;
+			step.fromVersion = from.version;
+			step.toVersion = to.version;
+			reportDiff diff;
+			diff.compare(from.report, to.report);
+			for (auto& entry : diff.entries) {
+				// Caps without a value in both versions (empty or n/a) did not change
+				if ((entry.section == diffSectionCaps) && (!reportData::isAvailable(entry.baseValue)) && (!reportData::isAvailable(entry.otherValue))) {
+					continue;
+				}
+				step.changes.push_back(classifyChange(entry));
+			}
+			steps.push_back(step);
+		}
+	}
+
+	int driverTimeline::changeCount() const
+	{
+		int count = 0;
+		for (auto& step : steps) {
+			count += (int)step.changes.size();
+		}
+		return count;
+	}
+
+	int driverTimeline::regressionCount() const
+	{
+		int count = 0;
+		for (auto& step : steps) {
+			count += step.regressionCount();
+		}
+		return count;
+	}
+
+	/// <summary>
+	/// Returns the change log with a block per version step, regressions are marked with "!", e.g.
+	/// Windows 10 : 4.5.0 NVIDIA 368.81 -> 4.5.0 NVIDIA 372.54 (2 changes, 1 regression)
+	///   + extension GL_ARB_gl_spirv
+	/// ! decreased cap GL_MAX_VIEWPORTS : 16 -> 8
+	/// </summary>
+	/// <param name="getEnumName">Function used to resolve compressed format names</param>
+	string driverTimeline::toText(function<string(GLint)> getEnumName) const
+	{
+		const char* symbols[] = { "+", "-", "increased", "decreased", "~" };
+		stringstream ss;
+		for (auto& step : steps) {
+			ss << step.operatingSystem << " : " << step.fromVersion << " -> " << step.toVersion;
+			ss << " (" << step.changes.size() << " changes, " << step.regressionCount() << " regressions)\n";
+			for (auto& change : step.changes) {
+				string name = (change.section == diffSectionCompressedFormats) ? getEnumName(atoi(change.name.c_str())) : change.name;
+				ss << (change.regression ? "! " : "  ") << symbols[change.type] << " " << reportDiff::sectionName(change.section) << " " << name;
+				switch (change.type) {
+				case timelineAdded:
+					ss << (change.newValue.empty() ? "" : " : " + change.newValue);
+					break;
+				case timelineRemoved:
+					ss << (change.oldValue.empty() ? "" : " : " + change.oldValue);
+					break;
+				default:
+					ss << " : " << change.oldValue << " -> " << change.newValue;
+					break;
+				}
+				ss << "\n";
+			}
+		}
+		ss << versions.size() << " reports, " << steps.size() << " version steps, " << changeCount() << " changes, " << regressionCount() << " regressions\n";
+		return ss.str();
+	}
+
+	string driverTimeline::typeName(timelineChangeType type)
+	{
+		const char* names[] = { "added", "removed", "increased", "decreased", "changed" };
+		return names[type];
+	}
+
+}
@@ -0,0 +1,91 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Changes of a device's capabilities across driver versions
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <GL/glew.h>
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	enum timelineChangeType { timelineAdded, timelineRemoved, timelineIncreased, timelineDecreased, timelineChanged };
+
+	class timelineChange
+	{
+	public:
+		diffSection section;
+		timelineChangeType type;
+		string name;
+		string oldValue;
+		string newValue;
+		// Lost extensions, formats or values and limits that got worse
+		bool regression = false;
+	};
+
+	class timelineVersion
+	{
+	public:
+		int reportId = -1;
+		string version;
+		string operatingSystem;
+		reportData report;
+	};
+
+	/// <summary>
+	/// Changes between two consecutive driver versions on the same operating system
+	/// </summary>
+	class timelineStep
+	{
+	public:
+		string operatingSystem;
+		int fromReportId;
+		int toReportId;
+		string fromVersion;
+		string toVersion;
+		vector<timelineChange> changes;
+		int regressionCount() const;
+	};
+
+	/// <summary>
+	/// Reports of one device are ordered by operating system and driver version, every version is compared to the previous one with the structured diff
+	/// </summary>
+	class driverTimeline
+	{
+	public:
+		vector<timelineVersion> versions;
+		vector<timelineStep> steps;
+		void clear();
+		void addReport(int reportId, const string& version, const string& operatingSystem, const reportData& report);
+		void build();
+		int changeCount() const;
+		int regressionCount() const;
+		string toText(function<string(GLint)> getEnumName) const;
+		static bool versionLess(const string& a, const string& b);
+		static string typeName(timelineChangeType type);
+	};
+
+}
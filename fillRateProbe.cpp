@@ -0,0 +1,160 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Framebuffer fill rate and blending probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "fillRateProbe.h"
+#include "glCapsViewerCore.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string fillRateProbe::name() const
+	{
+		return "fillrate";
+	}
+
+	bool fillRateProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Sized color formats render targets are commonly created with, formats that are not renderable are skipped
+	/// </summary>
+	vector<GLenum> fillRateProbe::colorFormats()
+	{
+		GLenum formats[] = { GL_R8, GL_RG8, GL_RGBA8, GL_SRGB8_ALPHA8, GL_RGB10_A2, GL_RGBA16, GL_R11F_G11F_B10F, GL_R16F, GL_RG16F, GL_RGBA16F, GL_R32F, GL_RG32F, GL_RGBA32F };
+		return vector<GLenum>(formats, formats + sizeof(formats) / sizeof(formats[0]));
+	}
+
+	void fillRateProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// Output varies per pixel and has partial alpha, so neither fast clears nor blend shortcuts apply
+		string fragmentSource =
+			"#version 330\n"
+			"in vec2 uv;\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	color = vec4(uv, 1.0 - uv.x, 0.5);\n"
+			"}\n";
+		string log;
+		GLuint program = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource, log);
+		if (program == 0) {
+			probes.addMessage(name(), "skipped, program failed: " + log);
+			return;
+		}
+
+		GLint viewport[4];
+		GLboolean blend;
+		GLint blendSource;
+		GLint blendDestination;
+		GLint blendSourceAlpha;
+		GLint blendDestinationAlpha;
+		GLint blendEquation;
+		GLint blendEquationAlpha;
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glGetBooleanv(GL_BLEND, &blend);
+		glGetIntegerv(GL_BLEND_SRC_RGB, &blendSource);
+		glGetIntegerv(GL_BLEND_DST_RGB, &blendDestination);
+		glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSourceAlpha);
+		glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDestinationAlpha);
+		glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquation);
+		glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquationAlpha);
+
+		GLuint framebuffer;
+		GLuint vertexArray;
+		glGenFramebuffers(1, &framebuffer);
+		glGenVertexArrays(1, &vertexArray);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glBindVertexArray(vertexArray);
+		glUseProgram(program);
+		glViewport(0, 0, framebufferSize, framebufferSize);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glBlendEquation(GL_FUNC_ADD);
+		double pixels = (double)framebufferSize * framebufferSize * passesPerSample;
+
+		for (auto& format : colorFormats()) {
+			string formatName = core.getEnumName(format);
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glPerformanceProbes::clearErrors();
+			// Allocation format and type only matter for the (absent) data
+			glTexImage2D(GL_TEXTURE_2D, 0, format, framebufferSize, framebufferSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+			if ((glGetError() != GL_NO_ERROR) || (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)) {
+				probes.addMessage(name(), formatName + " skipped, not renderable");
+			}
+			else {
+				auto draw = [&]() {
+					for (int i = 0; i < passesPerSample; i++) {
+						glDrawArrays(GL_TRIANGLES, 0, 3);
+					}
+				};
+				glDisable(GL_BLEND);
+				double fillTime = probes.medianTime(draw);
+				double fillRate = (fillTime > 0.0) ? pixels / fillTime : 0.0;
+				probes.addValue(name(), formatName, "fill_mpixels_per_s", fillRate);
+
+				// Blending is tried if support can't be queried
+				GLint blendSupport = glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format, GL_FRAMEBUFFER_BLEND, GL_FULL_SUPPORT);
+				if (blendSupport == GL_NONE) {
+					probes.addMessage(name(), formatName + " blending skipped, not supported");
+				}
+				else {
+					glEnable(GL_BLEND);
+					glPerformanceProbes::clearErrors();
+					double blendTime = probes.medianTime(draw);
+					if (glGetError() != GL_NO_ERROR) {
+						probes.addMessage(name(), formatName + " blending skipped, draw failed");
+					}
+					else {
+						double blendRate = (blendTime > 0.0) ? pixels / blendTime : 0.0;
+						probes.addValue(name(), formatName, "blend_mpixels_per_s", blendRate);
+						probes.addValue(name(), formatName, "blend_ratio", (fillRate > 0.0) ? blendRate / fillRate : 0.0);
+					}
+					glDisable(GL_BLEND);
+				}
+			}
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+			glDeleteTextures(1, &texture);
+		}
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteProgram(program);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glBlendFuncSeparate(blendSource, blendDestination, blendSourceAlpha, blendDestinationAlpha);
+		glBlendEquationSeparate(blendEquation, blendEquationAlpha);
+		if (blend) {
+			glEnable(GL_BLEND);
+		}
+	}
+
+}
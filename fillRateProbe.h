@@ -0,0 +1,50 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Framebuffer fill rate and blending probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures the fill rate of fullscreen passes into color attachments of common LDR and HDR formats, with and without alpha blending
+	/// </summary>
+	class fillRateProbe : public glPerformanceProbe
+	{
+	public:
+		// Width and height of the render targets, modest so the probe also finishes quickly on software rasterizers
+		int framebufferSize = 1024;
+		// Fullscreen passes per timed sample
+		int passesPerSample = 8;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static vector<GLenum> colorFormats();
+	};
+
+}
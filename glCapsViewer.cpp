@@ -26,6 +26,10 @@
 #include "settings.h"
 #include "submitDialog.h"
 #include "internalFormatTarget.h"
+#include "reportAggregator.h"
+#include "compareDialog.h"
+#include "reportFetcher.h"
+#include "driverTimeline.h"
 #include <GL/glew.h>
 #ifdef _WIN32
 	#include <GL/wglew.h>
@@ -46,11 +50,14 @@
 #include <QComboBox>
 #include <QInputDialog>
 #include <sstream>  
+#include <set>
 #include <QXmlStreamReader>
 #include <QFormLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QDialogButtonBox>
+#include <QVBoxLayout>
+#include <QEventLoop>
 #ifdef __linux__
 	#include <GL/glxew.h>
 #endif
@@ -68,10 +75,14 @@ glCapsViewer::glCapsViewer(QWidget *parent)
 	connect(ui.actionSettings, SIGNAL(triggered()), this, SLOT(slotSettings()));
 	connect(ui.actionUpload, SIGNAL(triggered()), this, SLOT(slotUpload()));
 	connect(ui.actionDevice, SIGNAL(triggered()), this, SLOT(slotShowDeviceOnline()));
+	connect(ui.actionCompare, SIGNAL(triggered()), this, SLOT(slotCompareReports()));
 	connect(ui.pushButtonRefreshDataBase, SIGNAL(released()), this, SLOT(slotRefreshDatabase()));
 	connect(ui.listWidgetDatabaseDevices, SIGNAL(itemSelectionChanged()), this, SLOT(slotDatabaseDevicesItemChanged()));
 	connect(ui.tabWidget, SIGNAL(currentChanged(int)), this, SLOT(slotTabChanged(int)));
 	connect(ui.comboBoxDeviceVersions, SIGNAL(currentIndexChanged(int)), this, SLOT(slotDeviceVersionChanged(int)));
+	connect(ui.lineEditDatabaseQuery, SIGNAL(returnPressed()), this, SLOT(slotQueryDatabase()));
+	connect(ui.pushButtonImportReports, SIGNAL(released()), this, SLOT(slotImportReports()));
+	connect(ui.pushButtonDeviceTimeline, SIGNAL(released()), this, SLOT(slotDeviceTimeline()));
 
 	ui.tableWidgetDatabaseDeviceReport->horizontalHeader()->setDefaultAlignment(Qt::AlignLeft);
 	ui.tableWidgetDatabaseDeviceReport->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
@@ -105,11 +116,21 @@ glCapsViewer::glCapsViewer(QWidget *parent)
 		newTitle << this->windowTitle().toStdString() << " - ! Connected to development database !";
 		this->setWindowTitle(QString::fromStdString(newTitle.str()));
 	#endif
+
+	updateWindowTitle();
+
+	databaseIndex.getEnumName = [this](GLint glenum) { return core.getEnumName(glenum); };
+
+	uploadQueue = new capsViewer::uploadSpool(capsViewer::uploadSpool::defaultDirectory(), this);
+	connect(uploadQueue, SIGNAL(reportSubmitted(QString, QString)), this, SLOT(slotQueuedReportSubmitted(QString, QString)));
+	uploadQueue->start();
 }
 
 glCapsViewer::~glCapsViewer()
 {
-
+	if (databaseIndexLoader.joinable()) {
+		databaseIndexLoader.join();
+	}
 }
 
 /// <summary>
@@ -137,7 +158,7 @@ void glCapsViewer::updateReportState()
 		// Report present, check if it can be updated		
 		int reportId = glhttp.getReportId(core.description);
 		if (canUpdateReport(reportId)) {
-			ui.labelReportPresent->setText("<font color='#0000FF'>Device already present in database, but can be updated with missing values!</font>");
+			ui.labelReportPresent->setText("<font color='#0000FF'>Device already present in database, but can be updated with " + QString::number((int)databaseDiff.updates().size()) + " missing values!</font>");
 		}
 	}
 	else {
@@ -329,6 +350,49 @@ void glCapsViewer::displayInternalFormatInfo()
 	}
 }
 
+/// <summary>
+/// Lists the results of the performance probes by probe and case
+/// </summary>
+void glCapsViewer::displayPerformance()
+{
+	QTreeWidget *tree = ui.treeWidgetPerformance;
+	tree->clear();
+
+	if (!core.performanceProbes.enabled) {
+		QTreeWidgetItem *infoItem = new QTreeWidgetItem(tree);
+		infoItem->setText(0, "Performance probes have not been run (start with -probeperformance)");
+		infoItem->setTextColor(0, QColor::fromRgb(100, 100, 100));
+		return;
+	}
+
+	QTreeWidgetItem *probeItem = NULL;
+	QTreeWidgetItem *caseItem = NULL;
+	for (auto& value : core.performanceProbes.values) {
+		if ((probeItem == NULL) || (probeItem->text(0).toStdString() != value.probe)) {
+			probeItem = new QTreeWidgetItem(tree);
+			probeItem->setText(0, QString::fromStdString(value.probe));
+			caseItem = NULL;
+		}
+		if ((caseItem == NULL) || (caseItem->text(0).toStdString() != value.name)) {
+			caseItem = new QTreeWidgetItem(probeItem);
+			caseItem->setText(0, QString::fromStdString(value.name));
+		}
+		QTreeWidgetItem *valueItem = new QTreeWidgetItem(caseItem);
+		valueItem->setText(0, QString::fromStdString(value.metric));
+		valueItem->setText(1, QString::fromStdString(capsViewer::glPerformanceProbes::formatValue(value.value)));
+	}
+
+	if (!core.performanceProbes.messages.empty()) {
+		QTreeWidgetItem *messagesItem = new QTreeWidgetItem(tree);
+		messagesItem->setText(0, "Messages");
+		for (auto& message : core.performanceProbes.messages) {
+			QTreeWidgetItem *messageItem = new QTreeWidgetItem(messagesItem);
+			messageItem->setText(0, QString::fromStdString(message));
+			messageItem->setTextColor(0, QColor::fromRgb(100, 100, 100));
+		}
+	}
+}
+
 /// <summary>
 ///	Reads implementation details, extensions and capabilities
 ///	and displays the report
@@ -351,6 +415,12 @@ void glCapsViewer::generateReport()
 	core.readCompressedFormats();
 	if (core.extensionSupported("GL_ARB_internalformat_query")) 
 		core.readInternalFormats();
+	if (core.queryProfiler.enabled)
+		core.exportQueryProfile("glCapsViewer_queryprofile.txt");
+	if (core.performanceProbes.enabled) {
+		core.runPerformanceProbes();
+		core.exportPerformanceReport("glCapsViewer_performance.txt");
+	}
 
 	ui.labelDescription->setText(QString::fromStdString(core.description));
 
@@ -358,8 +428,10 @@ void glCapsViewer::generateReport()
 	displayExtensions();
 	displayCompressedFormats();
 	displayInternalFormatInfo();
+	displayPerformance();
 
 	updateReportState();
+	updateSimilarDevices();
 
 	// Tab captions
 	stringstream tabText;
@@ -544,73 +616,8 @@ bool glCapsViewer::canUpdateReport(int reportId) {
 	// Download report and check against xml
 	glCapsViewerHttp glchttp;
 	string reportXml = glchttp.fetchReport(reportId);
-
-	bool capsMissing = false;
-	bool compressedFormatsMissing = false;
-	bool internalFormatsMissing = false;
-
-	// Gather client-side available caps
-	vector<string> capsList;
-	for (auto& capsGroup : core.capgroups) {
-		for (auto& cap : capsGroup.capabilities) {
-			if (cap.second != "n/a") {
-				capsList.push_back(cap.first);
-			}
-		}
-	}
-
-	QXmlStreamReader xmlReader(&reportXml[0]);
-
-	vector<string> capsMissingDatabase;
-	vector<int> compressedFormatsDatabase;
-	while (!xmlReader.atEnd()) {
-		if ((xmlReader.isStartElement()) && (xmlReader.name() == "implementation")) {
-			while (!xmlReader.atEnd()) {
-				xmlReader.readNext();
-				if (xmlReader.name() == "implementation") {
-					break;
-				}
-				QXmlStreamAttributes attrib = xmlReader.attributes();
-				QString nodeName = attrib.value("id").toString();
-				QString nodeValue = xmlReader.readElementText();
-				if (nodeValue == "") 
-				{
-					capsMissingDatabase.push_back(nodeName.toStdString());
-				}
-
-			}
-		}
-		if ((xmlReader.isStartElement()) && (xmlReader.name() == "compressedtextureformats")) {
-			while (!xmlReader.atEnd()) {
-				xmlReader.readNext();
-				if (xmlReader.name() == "compressedtextureformats") {
-					break;
-				}
-				compressedFormatsDatabase.push_back(atoi(xmlReader.readElementText().toStdString().c_str()));
-			}
-		}
-		xmlReader.readNext();
-	}
-
-	// Check for missing caps
-	for (auto& capMissingDatabase : capsMissingDatabase) {
-		if (std::find(capsList.begin(), capsList.end(), capMissingDatabase) != capsList.end()) {
-			capsMissing = true;
-			break;
-		}
-	}
-
-	// Check for missing compressed formats
-	for (auto& compressedFormatClient : core.compressedFormats) {
-		if (std::find(compressedFormatsDatabase.begin(), compressedFormatsDatabase.end(), compressedFormatClient) == compressedFormatsDatabase.end()) {
-			compressedFormatsMissing = true;
-			break;
-		}
-	}
-
-	// TODO : Check internal formats
-
-	return (capsMissing || compressedFormatsMissing || internalFormatsMissing);
+	databaseDiff = core.diffReport(reportXml);
+	return databaseDiff.canUpdate();
 }
 
 void glCapsViewer::slotClose()
@@ -624,7 +631,11 @@ void glCapsViewer::slotUpload()
 
 	if (!glchttp.checkServerConnection()) 
 	{
-		QMessageBox::warning(this, tr("Error"), tr("Could not connect to the OpenGL hardware database!\n\nPlease check your internet connection and proxy settings!"));
+		QMessageBox::StandardButton reply;
+		reply = QMessageBox::question(this, tr("Error"), tr("Could not connect to the OpenGL hardware database!\n\nPlease check your internet connection and proxy settings!\n\nDo you want to add the report to the upload queue? It will be submitted as soon as the database can be reached."), QMessageBox::Yes | QMessageBox::No);
+		if (reply == QMessageBox::Yes) {
+			queueReport();
+		}
 		return;
 	}
 
@@ -646,6 +657,12 @@ void glCapsViewer::slotUpload()
 				QMessageBox::information(this, tr("Report submitted"), tr("Your report has been uploaded to the database!\n\nThanks for your contribution!"));
 				updateReportState();
 			}
+			else if (reply.empty())
+			{
+				// Connection lost during upload
+				queueReport();
+				QMessageBox::warning(this, tr("Error"), tr("The report could not be uploaded and has been added to the upload queue.\n\nIt will be submitted as soon as the database can be reached."));
+			}
 			else 
 			{
 				QMessageBox::warning(this, tr("Error"), "The report could not be uploaded : \n" + QString::fromStdString(reply));
@@ -668,9 +685,16 @@ void glCapsViewer::slotUpload()
 				// TODO : Error handling
 				if (ok) 
 				{
-					string xml = core.reportToXml();
+					string xml = core.reportUpdateToXml(databaseDiff);
+					QApplication::setOverrideCursor(Qt::WaitCursor);
 					string httpReply = glchttp.postReportForUpdate(xml);
-					QMessageBox::information(this, tr("Report updated"), QString::fromStdString(httpReply));
+					QApplication::restoreOverrideCursor();
+					if (glCapsViewerHttp::updateSucceeded(httpReply)) {
+						QMessageBox::information(this, tr("Report updated"), "Updated capabilities : \n" + QString::fromStdString(httpReply.substr(11)).trimmed());
+					}
+					else {
+						QMessageBox::warning(this, tr("Error"), "The report could not be updated : \n" + QString::fromStdString(httpReply));
+					}
 					updateReportState();
 				}
 			}
@@ -689,6 +713,25 @@ void glCapsViewer::slotUpload()
 	}
 }
 
+/// <summary>
+///	Adds the current report to the upload queue
+/// </summary>
+/// <returns>false if the same report is already queued</returns>
+bool glCapsViewer::queueReport()
+{
+	if (core.submitter.empty()) {
+		core.submitter = appSettings.submitterName.toStdString();
+	}
+	return uploadQueue->enqueue(core.description, core.reportToXml());
+}
+
+void glCapsViewer::slotQueuedReportSubmitted(QString description, QString reply)
+{
+	if (description.toStdString() == core.description) {
+		updateReportState();
+	}
+}
+
 void glCapsViewer::slotExportXml(){
 	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"), "glCapsViewer_Report.xml", tr("xml (*.xml)"));
 	core.exportXml(fileName.toStdString());
@@ -731,13 +774,241 @@ void glCapsViewer::slotSettings()
 	dialog.setModal(true);
 	dialog.exec();
 	appSettings.restore();
+	updateWindowTitle();
+}
+
+/// <summary>
+///	Shows the database url in the window title if it's not the default database
+/// </summary>
+void glCapsViewer::updateWindowTitle()
+{
+	if (defaultWindowTitle.isEmpty()) {
+		defaultWindowTitle = windowTitle();
+	}
+	if (glCapsViewerHttp::getBaseUrl() != glCapsViewerHttp::getDefaultBaseUrl()) {
+		setWindowTitle(defaultWindowTitle + " - Connected to " + QString::fromStdString(glCapsViewerHttp::getBaseUrl()));
+	}
+	else {
+		setWindowTitle(defaultWindowTitle);
+	}
 }
 
 void glCapsViewer::slotTabChanged(int index)
 {
 	if (index == 1) {
+		loadDatabaseIndex();
+		refreshDeviceList();
+		if (!ui.lineEditDatabaseQuery->text().trimmed().isEmpty()) {
+			slotQueryDatabase();
+		}
+	}
+}
+
+/// <summary>
+///	Starts indexing all cached database reports on a background thread, so generating a report doesn't wait for it
+/// The index and the similar device search must not be accessed until the load has finished (see loadDatabaseIndex)
+/// </summary>
+void glCapsViewer::startDatabaseIndexLoad()
+{
+	if ((databaseIndexLoaded) || (databaseIndexLoader.joinable())) {
+		return;
+	}
+	databaseIndexLoader = thread([this]() {
+		capsViewer::capsList capsList;
+		capsList.loadFromFile("capslist.xml");
+		similarDevices.createSchema(capsList);
+		databaseIndex.importFiles(databaseCache.fileNames(), capsViewer::reportCache::reportId, [this](const capsViewer::reportData& report, const capsViewer::indexedReport& info) {
+			similarDevices.addReport(report, info.renderer);
+		});
+		similarDevices.build();
+		QMetaObject::invokeMethod(this, "slotDatabaseIndexLoaded", Qt::QueuedConnection);
+	});
+}
+
+/// <summary>
+///	Waits for the cached database reports to be indexed, starts indexing if it hasn't been started yet (e.g. when the database tab is opened before a report has been generated)
+/// </summary>
+void glCapsViewer::loadDatabaseIndex()
+{
+	if (databaseIndexLoaded) {
+		return;
+	}
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	startDatabaseIndexLoad();
+	databaseIndexLoader.join();
+	databaseIndexLoaded = true;
+	updateDatabaseIndexLabel();
+	QApplication::restoreOverrideCursor();
+}
+
+void glCapsViewer::slotDatabaseIndexLoaded()
+{
+	// Already finished by loadDatabaseIndex
+	if (databaseIndexLoaded) {
+		return;
+	}
+	databaseIndexLoader.join();
+	databaseIndexLoaded = true;
+	updateDatabaseIndexLabel();
+	if (!core.description.empty()) {
+		updateSimilarDevices();
+	}
+}
+
+/// <summary>
+///	Stores a report fetched from the database in the local cache and adds it to the index
+/// </summary>
+void glCapsViewer::indexDatabaseReport(int reportId, const string& reportXml)
+{
+	loadDatabaseIndex();
+	if ((reportXml.empty()) || (databaseIndex.contains(reportId))) {
+		return;
+	}
+	capsViewer::reportData report;
+	if (!report.fromXml(reportXml)) {
+		return;
+	}
+	databaseCache.store(reportId, reportXml);
+	if (addDatabaseReport(reportId, report)) {
+		similarDevices.build();
+	}
+}
+
+/// <summary>
+///	Adds a cached database report to the index and the similar device search, the caller builds the similar device search once all reports have been added
+/// </summary>
+/// <returns>false if the report was already indexed</returns>
+bool glCapsViewer::addDatabaseReport(int reportId, const capsViewer::reportData& report)
+{
+	int document = databaseIndex.addReport(report, reportId, databaseCache.fileName(reportId));
+	if (document > -1) {
+		similarDevices.addReport(report, databaseIndex.reports[document].renderer);
+	}
+	updateDatabaseIndexLabel();
+	return (document > -1);
+}
+
+/// <summary>
+///	Shows the devices of the locally available database reports closest in capabilities to the current report
+/// Updated again once the index has been loaded in the background
+/// </summary>
+void glCapsViewer::updateSimilarDevices()
+{
+	if (!databaseIndexLoaded) {
+		ui.labelSimilarDevices->setVisible(false);
+		startDatabaseIndexLoad();
+		return;
+	}
+	if (similarDevices.size() == 0) {
+		ui.labelSimilarDevices->setVisible(false);
+		return;
+	}
+	capsViewer::reportData report;
+	report.fromCore(core);
+	// Devices usually have multiple reports, so more reports than devices shown are fetched
+	vector<capsViewer::similarReport> matches = similarDevices.query(report, 50);
+	string ownRenderer = core.implementation["Renderer"];
+	set<string> listedDevices;
+	QStringList devices;
+	for (auto& match : matches) {
+		const string& renderer = similarDevices.labels[match.index];
+		if ((renderer.empty()) || (renderer == ownRenderer) || (listedDevices.count(renderer) > 0)) {
+			continue;
+		}
+		listedDevices.insert(renderer);
+		devices << QString::fromStdString(renderer) + " (" + QString::number((int)(match.similarity * 100.0f + 0.5f)) + "%)";
+		if (devices.size() == 3) {
+			break;
+		}
+	}
+	ui.labelSimilarDevices->setText("Closest devices in local reports : " + devices.join(", "));
+	ui.labelSimilarDevices->setVisible(!devices.isEmpty());
+}
+
+void glCapsViewer::updateDatabaseIndexLabel()
+{
+	ui.labelDatabaseIndex->setText(QString::number(databaseIndex.reports.size()) + " reports indexed");
+}
+
+/// <summary>
+///	Lists all devices with locally available reports matching the query, an empty query shows all database devices
+/// </summary>
+void glCapsViewer::slotQueryDatabase()
+{
+	QString query = ui.lineEditDatabaseQuery->text().trimmed();
+	if (query.isEmpty()) {
 		refreshDeviceList();
+		updateDatabaseIndexLabel();
+		return;
+	}
+	string error;
+	vector<uint32_t> matches = databaseIndex.query(query.toStdString(), error);
+	if (!error.empty()) {
+		ui.labelDatabaseIndex->setText("<font color='#FF0000'>" + QString::fromStdString(error).toHtmlEscaped() + "</font>");
+		return;
+	}
+
+	// Matching reports grouped by device
+	map<string, int> devices;
+	for (auto document : matches) {
+		devices[databaseIndex.reports[document].renderer]++;
+	}
+	ui.listWidgetDatabaseDevices->clear();
+	for (auto& device : devices) {
+		QListWidgetItem *deviceItem = new QListWidgetItem(QString::fromStdString(device.first) + " (" + QString::number(device.second) + ")", ui.listWidgetDatabaseDevices);
+		deviceItem->setSizeHint(QSize(deviceItem->sizeHint().height(), 24));
+		deviceItem->setData(Qt::UserRole, QString::fromStdString(device.first));
+	}
+	ui.labelDatabaseIndex->setText(QString::number(matches.size()) + " of " + QString::number(databaseIndex.reports.size()) + " reports match");
+}
+
+/// <summary>
+///	Copies all reports of a directory (exported or database reports) to the local cache and indexes them
+/// </summary>
+void glCapsViewer::slotImportReports()
+{
+	QString directory = QFileDialog::getExistingDirectory(this, tr("Import reports"));
+	if (directory.isEmpty()) {
+		return;
 	}
+	loadDatabaseIndex();
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	vector<string> cachedFiles;
+	for (auto& fileName : capsViewer::reportAggregator::findReports(directory.toStdString())) {
+		string cachedFile = databaseCache.importFile(fileName);
+		if (!cachedFile.empty()) {
+			cachedFiles.push_back(cachedFile);
+		}
+	}
+	int imported = databaseIndex.importFiles(cachedFiles, capsViewer::reportCache::reportId, [this](const capsViewer::reportData& report, const capsViewer::indexedReport& info) {
+		similarDevices.addReport(report, info.renderer);
+	});
+	// Imported reports are encoded together, with statistics that include them
+	if (imported > 0) {
+		similarDevices.build();
+	}
+	QApplication::restoreOverrideCursor();
+	updateDatabaseIndexLabel();
+	if ((imported > 0) && (!core.description.empty())) {
+		updateSimilarDevices();
+	}
+	QMessageBox::information(this, tr("Import complete"), tr("%1 reports have been imported.").arg(imported));
+}
+
+/// <summary>
+///	Compares the current report side by side with any number of locally available database and imported reports
+/// </summary>
+void glCapsViewer::slotCompareReports()
+{
+	loadDatabaseIndex();
+	capsViewer::reportData report;
+	bool hasReport = !core.description.empty();
+	if (hasReport) {
+		report.fromCore(core);
+	}
+	capsViewer::compareDialog dialog(hasReport ? &report : NULL, databaseIndex.reports, [this](GLint glenum) { return core.getEnumName(glenum); }, this);
+	dialog.setModal(true);
+	dialog.exec();
 }
 
 void glCapsViewer::slotFilterExtensions(QString text)
@@ -762,14 +1033,19 @@ void glCapsViewer::slotFilterTextureFormats(QString text)
 ///	Fetches a list of available report version for currently selected device
 /// </summary>
 void glCapsViewer::slotDatabaseDevicesItemChanged() {
-	// TODO : Check if ui.listWidgetDatabaseDevices->currentItem()->text() is assigned
 	glCapsViewerHttp glchttp;
 	vector<reportInfo> reportList;
 	
 	ui.comboBoxDeviceVersions->clear();
+	deviceReports.clear();
+	// The device list is cleared on refresh and for queries
+	if (ui.listWidgetDatabaseDevices->currentItem() == NULL) {
+		return;
+	}
 	QVariant data = ui.listWidgetDatabaseDevices->currentItem()->data(Qt::UserRole);
 	QString deviceName = data.toString();
 	reportList = glchttp.fetchDeviceReports(deviceName.toStdString());
+	deviceReports = reportList;
 
 	for (auto& report : reportList) {
 		stringstream ss;
@@ -778,6 +1054,92 @@ void glCapsViewer::slotDatabaseDevicesItemChanged() {
 	}
 }
 
+/// <summary>
+///	Fetches all report versions of the selected device (concurrently, cached reports are read from disk)
+/// and lists the changes between consecutive driver versions
+/// </summary>
+void glCapsViewer::slotDeviceTimeline()
+{
+	if (deviceReports.size() < 2) {
+		QMessageBox::information(this, tr("Timeline"), tr("The timeline requires at least two report versions of the selected device."));
+		return;
+	}
+	loadDatabaseIndex();
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	vector<int> reportIds;
+	for (auto& report : deviceReports) {
+		reportIds.push_back(report.reportId);
+	}
+	capsViewer::reportFetcher fetcher(&databaseCache);
+	QEventLoop loop;
+	connect(&fetcher, SIGNAL(finished()), &loop, SLOT(quit()));
+	fetcher.fetch(reportIds);
+	loop.exec(QEventLoop::ExcludeUserInputEvents);
+
+	capsViewer::driverTimeline timeline;
+	int added = 0;
+	for (auto& info : deviceReports) {
+		auto xml = fetcher.reports.find(info.reportId);
+		capsViewer::reportData report;
+		if ((xml == fetcher.reports.end()) || (!report.fromXml(xml->second))) {
+			continue;
+		}
+		if (addDatabaseReport(info.reportId, report)) {
+			added++;
+		}
+		timeline.addReport(info.reportId, info.version, info.operatingSystem, report);
+	}
+	timeline.build();
+	// Only the newly fetched reports are encoded
+	if (added > 0) {
+		similarDevices.build();
+	}
+	QApplication::restoreOverrideCursor();
+
+	QDialog dialog(this);
+	dialog.setWindowTitle("Timeline - " + QString::fromStdString(deviceReports.front().device));
+	QVBoxLayout *layout = new QVBoxLayout;
+	QString summary = QString::number(timeline.versions.size()) + " report versions, " + QString::number(timeline.changeCount()) + " changes, " + QString::number(timeline.regressionCount()) + " regressions";
+	if (!fetcher.failedReports.empty()) {
+		summary += " (" + QString::number(fetcher.failedReports.size()) + " reports could not be fetched)";
+	}
+	layout->addWidget(new QLabel(summary));
+
+	QTreeWidget *tree = new QTreeWidget();
+	tree->setHeaderLabels(QStringList() << "Change" << "Name" << "Value");
+	for (auto& step : timeline.steps) {
+		QTreeWidgetItem *stepItem = new QTreeWidgetItem(tree);
+		stepItem->setText(0, QString::fromStdString(step.operatingSystem));
+		stepItem->setText(1, QString::fromStdString(step.fromVersion + " -> " + step.toVersion));
+		stepItem->setText(2, QString::number(step.changes.size()) + " changes, " + QString::number(step.regressionCount()) + " regressions");
+		stepItem->setTextColor(1, QColor::fromRgb(0, 0, 255));
+		for (auto& change : step.changes) {
+			QTreeWidgetItem *changeItem = new QTreeWidgetItem(stepItem);
+			string name = (change.section == capsViewer::diffSectionCompressedFormats) ? core.getEnumName(atoi(change.name.c_str())) : change.name;
+			string value = (change.type == capsViewer::timelineAdded) ? change.newValue : (change.type == capsViewer::timelineRemoved) ? change.oldValue : change.oldValue + " -> " + change.newValue;
+			changeItem->setText(0, QString::fromStdString(capsViewer::driverTimeline::typeName(change.type) + " " + capsViewer::reportDiff::sectionName(change.section)));
+			changeItem->setText(1, QString::fromStdString(name));
+			changeItem->setText(2, QString::fromStdString(value));
+			if (change.regression) {
+				for (int column = 0; column < 3; column++) {
+					changeItem->setTextColor(column, QColor::fromRgb(255, 0, 0));
+				}
+			}
+		}
+		// Steps without regressions are collapsed
+		stepItem->setExpanded(step.regressionCount() > 0);
+	}
+	tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+	layout->addWidget(tree);
+
+	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+	connect(buttonBox, SIGNAL(rejected()), &dialog, SLOT(reject()));
+	layout->addWidget(buttonBox);
+	dialog.setLayout(layout);
+	dialog.resize(900, 600);
+	dialog.exec();
+}
+
 /// <summary>
 ///	Fetches the report for the currently selected device and report version
 /// Displays it in table form
@@ -792,6 +1154,7 @@ void glCapsViewer::slotDeviceVersionChanged(int index) {
 	int reportId = ui.comboBoxDeviceVersions->itemData(index).toInt();
 	glCapsViewerHttp glchttp;
 	string reportXml = glchttp.fetchReport(reportId);
+	indexDatabaseReport(reportId, reportXml);
 	// Generate simple report
 
 	QTableWidget *table = ui.tableWidgetDatabaseDeviceReport;
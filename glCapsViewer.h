@@ -27,9 +27,15 @@
 #include <QNetworkReply>
 #include "ui_glCapsViewer.h"
 #include "glCapsViewerCore.h"
+#include "glCapsViewerHttp.h"
 #include "settings.h"
+#include "uploadSpool.h"
+#include "reportCache.h"
+#include "reportIndex.h"
+#include "reportSimilarity.h"
 #include <QStandardItemModel>
 #include <QStandardItem>
+#include <thread>
 #include <treeproxyfilter.h>
 
 class glCapsViewer : public QMainWindow
@@ -44,10 +50,26 @@ public:
 	GLFWwindow* window;
 	void updateReportState();
 	void generateReport();
+	bool queueReport();
 	bool contextTypeSelection();
 private:
 	QNetworkAccessManager* nam;
 	capsViewer::settings appSettings;
+	QString defaultWindowTitle;
+	// Differences between the database report and the current report
+	capsViewer::reportDiff databaseDiff;
+	// Reports waiting for submission (e.g. captured without connection to the database)
+	capsViewer::uploadSpool* uploadQueue;
+	// Database reports available locally (viewed or imported) and their index for queries
+	capsViewer::reportCache databaseCache;
+	capsViewer::reportIndex databaseIndex;
+	// Nearest neighbour search over the same reports
+	capsViewer::reportSimilarity similarDevices;
+	bool databaseIndexLoaded = false;
+	// Indexes the cached reports in the background after the first report has been generated
+	thread databaseIndexLoader;
+	// Report versions of the device selected in the database tab
+	vector<reportInfo> deviceReports;
 	struct
 	TreeProxyFilter extensionFilterProxy;
 	QStandardItemModel extensionTreeModel;
@@ -61,6 +83,14 @@ private:
 	void displayExtensions();
 	void displayCompressedFormats();
 	void displayInternalFormatInfo();
+	void displayPerformance();
+	void updateWindowTitle();
+	void startDatabaseIndexLoad();
+	void loadDatabaseIndex();
+	void indexDatabaseReport(int reportId, const string& reportXml);
+	bool addDatabaseReport(int reportId, const capsViewer::reportData& report);
+	void updateDatabaseIndexLabel();
+	void updateSimilarDevices();
 private slots:
 	void slotRefreshReport();
 	void slotClose();
@@ -74,6 +104,12 @@ private slots:
 	void slotDatabaseDevicesItemChanged();
 	void slotDeviceVersionChanged(int index);
 	void slotTabChanged(int index);
+	void slotQueuedReportSubmitted(QString description, QString reply);
+	void slotQueryDatabase();
+	void slotImportReports();
+	void slotCompareReports();
+	void slotDeviceTimeline();
+	void slotDatabaseIndexLoaded();
 	void slotFilterExtensions(QString text);
 	void slotFilterImplementation(QString text);
 	void slotFilterTextureFormats(QString text);
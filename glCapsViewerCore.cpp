@@ -48,6 +48,7 @@
 #include <iterator>
 
 #include <capsGroup.h>
+#include <capsList.h>
 #include "glCapsViewerCore.h"
 
 using namespace std;
@@ -108,6 +109,8 @@ void glCapsViewerCore::clear() {
 	implementation.clear();
 	capgroups.clear();
 	compressedFormats.clear();
+	queryProfiler.clear();
+	performanceProbes.clear();
 	description = "";
 	submitter = "";	
 }
@@ -163,16 +166,18 @@ void glCapsViewerCore::readExtensions()
 {
 	// Use glGetStringi if available (GL 3.x)
 	if ((GL_VERSION_3_0) && (glGetStringi != NULL)) {
-		GLint numExtensions;
-		glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+		GLint numExtensions = 0;
+		queryProfiler.queryCap("GL_NUM_EXTENSIONS", GL_NUM_EXTENSIONS, [&]() { glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions); });
 		for (int i = 0; i < numExtensions; i++) {
-			const GLubyte* glExt = glGetStringi(GL_EXTENSIONS, i);
+			const GLubyte* glExt = nullptr;
+			queryProfiler.queryCap("GL_EXTENSIONS (indexed)", GL_EXTENSIONS, [&]() { glExt = glGetStringi(GL_EXTENSIONS, i); });
 			string ext = reinterpret_cast<const char*>(glExt);
 			extensions.push_back(ext);
 		}
 	}
 	else {
-		const GLubyte* glExtensions = glGetString(GL_EXTENSIONS);
+		const GLubyte* glExtensions = nullptr;
+		queryProfiler.queryCap("GL_EXTENSIONS", GL_EXTENSIONS, [&]() { glExtensions = glGetString(GL_EXTENSIONS); });
 		string extensionString = reinterpret_cast<const char*>(glExtensions);
 		split(extensionString, extensions, ' ');
 	}
@@ -233,6 +238,7 @@ void glCapsViewerCore::readImplementation()
 	capsGroup.name = "implementation";
 	capsGroup.supported = true;
 	capsGroup.visible = false;
+	capsGroup.profiler = &queryProfiler;
 	capsGroup.addCapability("GL_VENDOR", GL_VENDOR, "glstring", 1);
 	capsGroup.addCapability("GL_RENDERER", GL_RENDERER, "glstring", 1);
 	capsGroup.addCapability("GL_VERSION", GL_VERSION, "glstring", 1);
@@ -259,11 +265,11 @@ string glCapsViewerCore::getEnumName(GLint glenum)
 
 void glCapsViewerCore::readCompressedFormats()
 {
-	GLint numFormats;
-	glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numFormats);
+	GLint numFormats = 0;
+	queryProfiler.queryCap("GL_NUM_COMPRESSED_TEXTURE_FORMATS", GL_NUM_COMPRESSED_TEXTURE_FORMATS, [&]() { glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numFormats); });
 	GLint* formats;
 	formats = new GLint[numFormats];
-	glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats);
+	queryProfiler.queryCap("GL_COMPRESSED_TEXTURE_FORMATS", GL_COMPRESSED_TEXTURE_FORMATS, [&]() { glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats); });
 	for (int i = 0; i < numFormats; i++) {
 		compressedFormats.push_back(formats[i]);
 	}
@@ -282,11 +288,34 @@ void glCapsViewerCore::readInternalFormats()
 
 	bool internalformatquery2 = extensionSupported("GL_ARB_internalformat_query2");
 	for (auto& target : internalFormatTargets) {
+		target.profiler = &queryProfiler;
 		target.getInternalFormatInfo(internalformatquery2);
 	}
 
 }
 
+/// <summary>
+/// Runs the optional performance probes (only if enabled), needs the internal format information for the per format probes
+/// </summary>
+void glCapsViewerCore::runPerformanceProbes()
+{
+	performanceProbes.run(*this);
+}
+
+/// <summary>
+/// Returns the internal format information of a texture target
+/// </summary>
+/// <returns>NULL if internal formats have not been read (e.g. GL_ARB_internalformat_query not supported)</returns>
+const capsViewer::internalFormatTarget* glCapsViewerCore::getInternalFormatTarget(GLenum target)
+{
+	for (auto& internalFormatTarget : internalFormatTargets) {
+		if (internalFormatTarget.target == target) {
+			return &internalFormatTarget;
+		}
+	}
+	return NULL;
+}
+
 /// <summary>
 /// Loads mapping list of OpenGL enum values and strings from xml file
 /// </summary>
@@ -321,18 +350,14 @@ bool glCapsViewerCore::loadEnumList()
 }
 
 
-string glCapsViewerCore::reportToXml() 
+/// <summary>
+/// Writes the report identity and submission info shared by full reports and report updates
+/// </summary>
+void glCapsViewerCore::writeReportInfo(QXmlStreamWriter& xmlWriter)
 {
 	const string appVersion = "glCapsViewer 1.1 - Copyright 2011-2016 by Sascha Willems (www.saschawillems.de)";
-	const string appAbout = "glCapsViewer 1.1";
 	const string fileVersion = "4.0";
 
-	QString xmlStr;
-	QXmlStreamWriter xmlWriter(&xmlStr);
-	xmlWriter.setAutoFormatting(true);
-	xmlWriter.writeStartDocument();
-
-	xmlWriter.writeStartElement("implementationinfo");
 	xmlWriter.writeTextElement("fileversion", QString::fromStdString(fileVersion));
 	xmlWriter.writeTextElement("appversion", QString::fromStdString(appVersion));
 	xmlWriter.writeTextElement("description", QString::fromStdString(description));
@@ -347,6 +372,21 @@ string glCapsViewerCore::reportToXml()
 	xmlWriter.writeTextElement("submitter", QString::fromStdString(submitter));
 	xmlWriter.writeTextElement("os", QString::fromStdString(implementation["Operating system"]));
 	xmlWriter.writeTextElement("comment", QString::fromStdString(comment));
+}
+
+/// <summary>
+/// Writes the report xml, as uploaded to the database and exported to files
+/// </summary>
+/// <param name="includePerformance">Adds the performance probe results, only for local exports as they are no capabilities and not part of the database schema</param>
+string glCapsViewerCore::reportToXml(bool includePerformance) 
+{
+	QString xmlStr;
+	QXmlStreamWriter xmlWriter(&xmlStr);
+	xmlWriter.setAutoFormatting(true);
+	xmlWriter.writeStartDocument();
+
+	xmlWriter.writeStartElement("implementationinfo");
+	writeReportInfo(xmlWriter);
 
 	// Extensions
 	xmlWriter.writeStartElement("extensions");
@@ -409,6 +449,38 @@ string glCapsViewerCore::reportToXml()
 	xmlWriter.writeEndElement(); // internalformatinformation
 #endif
 
+	// Performance probes, only present if they have been run
+	if ((includePerformance) && (!performanceProbes.values.empty())) {
+		xmlWriter.writeStartElement("performance");
+		string currentProbe;
+		string currentCase;
+		for (auto& value : performanceProbes.values) {
+			if ((value.probe != currentProbe) || (value.name != currentCase)) {
+				if (!currentCase.empty()) {
+					xmlWriter.writeEndElement(); // case
+				}
+				if (value.probe != currentProbe) {
+					if (!currentProbe.empty()) {
+						xmlWriter.writeEndElement(); // probe
+					}
+					xmlWriter.writeStartElement("probe");
+					xmlWriter.writeAttribute("name", QString::fromStdString(value.probe));
+					currentProbe = value.probe;
+				}
+				xmlWriter.writeStartElement("case");
+				xmlWriter.writeAttribute("name", QString::fromStdString(value.name));
+				currentCase = value.name;
+			}
+			xmlWriter.writeStartElement("value");
+			xmlWriter.writeAttribute("name", QString::fromStdString(value.metric));
+			xmlWriter.writeCharacters(QString::fromStdString(capsViewer::glPerformanceProbes::formatValue(value.value)));
+			xmlWriter.writeEndElement(); // value
+		}
+		xmlWriter.writeEndElement(); // case
+		xmlWriter.writeEndElement(); // probe
+		xmlWriter.writeEndElement(); // performance
+	}
+
 	xmlWriter.writeEndElement(); // root
 
 	return xmlStr.toStdString();
@@ -416,84 +488,142 @@ string glCapsViewerCore::reportToXml()
 
 void glCapsViewerCore::exportXml(string fileName)
 {
-	string xml = reportToXml();
+	string xml = reportToXml(true);
 	ofstream destfile;
 	destfile.open(fileName);
 	destfile << xml;
 	destfile.close();
 }
 
-void glCapsViewerCore::readCapabilities()
+/// <summary>
+/// Compares a report from the online database against the current report
+/// </summary>
+/// <param name="reportXml">Report xml as returned by the database</param>
+/// <returns>Differences with the database report as base</returns>
+capsViewer::reportDiff glCapsViewerCore::diffReport(string reportXml)
 {
+	capsViewer::reportData databaseReport;
+	databaseReport.fromXml(reportXml);
+	capsViewer::reportData localReport;
+	localReport.fromCore(*this);
+	capsViewer::reportDiff diff;
+	diff.compare(databaseReport, localReport);
+	return diff;
+}
 
-	ifstream enumListxml("capslist.xml");
-	vector<char> buffer((istreambuf_iterator<char>(enumListxml)), istreambuf_iterator<char>());
-	buffer.push_back('\0');
-	QXmlStreamReader xmlStream(&buffer[0]);
-	QXmlStreamAttributes nodeAttribs;
-
-	while (!xmlStream.atEnd())  {
+/// <summary>
+/// Checks if a report from the online database is missing values that are available in the current report
+/// </summary>
+/// <param name="reportXml">Report xml as returned by the database</param>
+/// <returns>true if the database report can be updated</returns>
+bool glCapsViewerCore::canUpdateReport(string reportXml)
+{
+	return diffReport(reportXml).canUpdate();
+}
 
-		xmlStream.readNext();
+/// <summary>
+/// Generates a report update that only contains the values the database report can be updated with
+/// Uses the same layout as reportToXml, so the database reads it like a full report
+/// </summary>
+/// <param name="diff">Differences between the database report (base) and the current report</param>
+/// <returns>Report xml with the report identity, missing caps and compressed formats not yet in the database</returns>
+string glCapsViewerCore::reportUpdateToXml(const capsViewer::reportDiff& diff)
+{
+	// No auto formatting to keep the payload small
+	QString xmlStr;
+	QXmlStreamWriter xmlWriter(&xmlStr);
+	xmlWriter.writeStartDocument();
 
-		if (xmlStream.name() == "category") {
-			// TODO : wgl and glx need to be checked different (wglewIsSupported, etc.)
-			nodeAttribs = xmlStream.attributes();
-			QString catName = nodeAttribs.value("name").toString();
-			capsViewer::capsGroup capsGroup;
-			capsGroup.name = catName.toStdString();
-			capsGroup.supported = false;
+	xmlWriter.writeStartElement("implementationinfo");
+	writeReportInfo(xmlWriter);
 
-			while (!xmlStream.atEnd()) {
+	vector<const capsViewer::reportDiffEntry*> updates = diff.updates();
+	xmlWriter.writeStartElement("caps");
+	for (auto& entry : updates) {
+		if (entry->section == capsViewer::diffSectionCaps) {
+			xmlWriter.writeStartElement("cap");
+			xmlWriter.writeAttribute("id", QString::fromStdString(entry->name));
+			xmlWriter.writeTextElement("value", QString::fromStdString(entry->otherValue));
+			xmlWriter.writeEndElement();
+		}
+	}
+	xmlWriter.writeEndElement();
 
-				xmlStream.readNext();
+	xmlWriter.writeStartElement("compressedtextureformats");
+	for (auto& entry : updates) {
+		if (entry->section == capsViewer::diffSectionCompressedFormats) {
+			xmlWriter.writeTextElement("compressedtextureformat", QString::fromStdString(entry->name));
+		}
+	}
+	xmlWriter.writeEndElement();
 
-				if ((xmlStream.name() == "requirements") && (xmlStream.isStartElement())) {
-					QXmlStreamAttributes nodeAttribs = xmlStream.attributes();
-					string reqExt = nodeAttribs.value("extension").toString().toStdString();
-					string reqVersion = nodeAttribs.value("version").toString().toStdString();
+	// Internal formats are not yet in the database (see reportToXml), so they're not part of updates
 
-					// Check extension
-					if (!reqExt.empty()) {
-						capsGroup.supported = extensionSupported(reqExt);
-					}
+	xmlWriter.writeEndElement();
+	xmlWriter.writeEndDocument();
 
-					if (!reqVersion.empty()) {
-						replace(reqVersion.begin(), reqVersion.end(), '.', '_');
-						stringstream glewVersion;
-						glewVersion << "GL_VERSION_" << reqVersion;
-						capsGroup.supported = glewIsSupported(glewVersion.str().c_str());
-					}
+	return xmlStr.toStdString();
+}
 
-					if ((reqExt.empty()) && (reqVersion.empty())) {
-						capsGroup.supported = true;
-					}
-				}
+/// <summary>
+/// Writes the ranked OpenGL query profile of the last capture to a text file
+/// </summary>
+/// <param name="fileName">Name of the file to write the profile to</param>
+void glCapsViewerCore::exportQueryProfile(string fileName)
+{
+	queryProfiler.exportReport(fileName, [this](GLint glenum) { return getEnumName(glenum); });
+}
 
-				if (capsGroup.supported) 
-				{
-					if ((xmlStream.name() == "cap") && (xmlStream.isStartElement())) 
-					{
-						QXmlStreamAttributes nodeAttribs = xmlStream.attributes();
-						string capName = nodeAttribs.value("name").toString().toStdString();
-						string capType = nodeAttribs.value("type").toString().toStdString();
-						string capEnumStr = nodeAttribs.value("enum").toString().toStdString();
-						int capComponents = nodeAttribs.value("components").toInt();
-						uint32_t capEnum = toHex(nodeAttribs.value("enum").toString().toStdString());
-						capsGroup.addCapability(capName, capEnum, capType, capComponents);
-					}
-				}
+/// <summary>
+/// Writes the results of the performance probes to a text file, the context type is part of the header as results depend on it (e.g. shader compile times)
+/// </summary>
+/// <param name="fileName">Name of the file to write the results to</param>
+void glCapsViewerCore::exportPerformanceReport(string fileName)
+{
+	performanceProbes.exportReport(fileName, description + " (" + contextType + ")");
+}
 
-				if (xmlStream.name() == "category") 
-				{
-					break;
-				}
+void glCapsViewerCore::readCapabilities()
+{
+	capsViewer::capsList capsList;
+	capsList.loadFromFile("capslist.xml");
+
+	for (auto& category : capsList.categories) {
+		// TODO : wgl and glx need to be checked different (wglewIsSupported, etc.)
+		capsViewer::capsGroup capsGroup;
+		capsGroup.name = category.name;
+		capsGroup.supported = false;
+		capsGroup.profiler = &queryProfiler;
+
+		if (category.hasRequirements) {
+			string reqExt = category.requiredExtension;
+			string reqVersion = category.requiredVersion;
+
+			// Check extension
+			if (!reqExt.empty()) {
+				capsGroup.supported = extensionSupported(reqExt);
+			}
 
+			if (!reqVersion.empty()) {
+				replace(reqVersion.begin(), reqVersion.end(), '.', '_');
+				stringstream glewVersion;
+				glewVersion << "GL_VERSION_" << reqVersion;
+				capsGroup.supported = glewIsSupported(glewVersion.str().c_str());
 			}
 
-			capgroups.push_back(capsGroup);
+			if ((reqExt.empty()) && (reqVersion.empty())) {
+				capsGroup.supported = true;
+			}
+		}
 
+		if (capsGroup.supported) 
+		{
+			for (auto& cap : category.caps) 
+			{
+				capsGroup.addCapability(cap.name, cap.id, cap.type, cap.components);
+			}
 		}
 
+		capgroups.push_back(capsGroup);
 	}
 }
@@ -27,13 +27,19 @@
 #include <map>
 #include <capsGroup.h>
 #include <internalFormatTarget.h>
+#include <glQueryProfiler.h>
+#include <glPerformanceProbe.h>
+#include <reportDiff.h>
 
 using namespace std;
 
+class QXmlStreamWriter;
+
 class glCapsViewerCore 
 {
 private:
 	map<GLint, string> enumList;
+	void writeReportInfo(QXmlStreamWriter& xmlWriter);
 public:
 	vector<string> availableContextTypes;
 	map<string, string> implementation;
@@ -46,6 +52,8 @@ public:
 	string submitter = "";
 	string comment = "";
 	string contextType = "";
+	capsViewer::glQueryProfiler queryProfiler;
+	capsViewer::glPerformanceProbes performanceProbes;
 	string readOperatingSystem();
 	bool extensionSupported(string ext);
 	void clear();
@@ -54,11 +62,18 @@ public:
 	void readExtensions();
 	void readCompressedFormats();
 	void readInternalFormats();
+	void runPerformanceProbes();
+	const capsViewer::internalFormatTarget* getInternalFormatTarget(GLenum target);
 	void printExtensions();
 	void readOsExtensions();
 	bool loadEnumList();
 	string getEnumName(GLint glenum);
-	string reportToXml();
+	string reportToXml(bool includePerformance = false);
+	string reportUpdateToXml(const capsViewer::reportDiff& diff);
+	capsViewer::reportDiff diffReport(string reportXml);
+	bool canUpdateReport(string reportXml);
 	void exportXml(string fileName);
+	void exportQueryProfile(string fileName);
+	void exportPerformanceReport(string fileName);
 };
 
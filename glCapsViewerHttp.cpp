@@ -28,6 +28,8 @@
 #include <QHttpMultiPart>
 #include <QXmlStreamReader>
 
+string glCapsViewerHttp::baseUrl = "";
+
 glCapsViewerHttp::glCapsViewerHttp()
 {
 }
@@ -55,6 +57,39 @@ bool glCapsViewerHttp::checkServerConnection()
 	return (reply->error() == QNetworkReply::NoError);
 }
 
+/// <summary>
+/// Checks if the server state lists support for compressed report updates (a line containing "compressed_updates")
+/// </summary>
+/// <param name="serverState">Reply of gl_serverstate.php</param>
+bool glCapsViewerHttp::supportsCompressedUpdates(const string& serverState)
+{
+	stringstream ss(serverState);
+	string line;
+	while (getline(ss, line)) {
+		if (QString::fromStdString(line).trimmed() == "compressed_updates") {
+			return true;
+		}
+	}
+	return false;
+}
+
+/// <summary>
+/// The update script replies with "res_updated" on the first line, followed by the list of updated caps
+/// </summary>
+bool glCapsViewerHttp::updateSucceeded(const string& reply)
+{
+	return reply.compare(0, 11, "res_updated") == 0;
+}
+
+/// <summary>
+/// Asks the database if it accepts compressed report updates
+/// </summary>
+/// <returns>false if the server doesn't advertise support or can't be reached</returns>
+bool glCapsViewerHttp::checkCompressedUpdates()
+{
+	return supportsCompressedUpdates(httpGet(getBaseUrl() + "services/gl_serverstate.php"));
+}
+
 /// <summary>
 /// Execute http get request 
 /// </summary>
@@ -92,17 +127,13 @@ string glCapsViewerHttp::httpGet(string url)
 /// </summary>
 /// <param name="url">url for the http post</param>
 /// <param name="data">string data to post</param>
+/// <param name="compress">Send the data zlib compressed (see createMultiPart)</param>
 /// <returns>Server answer</returns>
-string glCapsViewerHttp::httpPost(string url, string data) 
+string glCapsViewerHttp::httpPost(string url, string data, bool compress) 
 {
 	manager = new QNetworkAccessManager(NULL);
 
-	QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-
-	QHttpPart xmlPart;
-	xmlPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"data\"; filename=\"glcapsviewerreport.xml\""));
-	xmlPart.setBody(QString::fromStdString(data).toLatin1());
-	multiPart->append(xmlPart);
+	QHttpMultiPart *multiPart = createMultiPart(data, compress);
 
 	QUrl qurl(QString::fromStdString(url));
 	QNetworkRequest request(qurl);
@@ -130,6 +161,38 @@ string glCapsViewerHttp::httpPost(string url, string data)
 
 }
 
+/// <summary>
+/// Creates the multipart form data for posting a report to the database
+/// </summary>
+/// <param name="data">Report xml</param>
+/// <param name="compress">Send the data zlib compressed (content type application/zlib) with the uncompressed size in a separate "size" field, only if the server supports it (see supportsCompressedUpdates)</param>
+/// <returns>Multipart form data, ownership is passed to the caller</returns>
+QHttpMultiPart* glCapsViewerHttp::createMultiPart(string data, bool compress)
+{
+	QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
+
+	QByteArray body = QString::fromStdString(data).toLatin1();
+	QHttpPart xmlPart;
+	if (compress) {
+		// qCompress prefixes the zlib stream with the uncompressed size, which is sent separately
+		xmlPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"data\"; filename=\"glcapsviewerreport.xml.z\""));
+		xmlPart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("application/zlib"));
+		xmlPart.setBody(qCompress(body, 9).mid(4));
+
+		QHttpPart sizePart;
+		sizePart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"size\""));
+		sizePart.setBody(QByteArray::number(body.size()));
+		multiPart->append(sizePart);
+	}
+	else {
+		xmlPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"data\"; filename=\"glcapsviewerreport.xml\""));
+		xmlPart.setBody(body);
+	}
+	multiPart->append(xmlPart);
+
+	return multiPart;
+}
+
 /// <summary>
 /// Encodes an url (or string) to make it comply to RFC2396 by replacing
 /// illegal characters
@@ -210,14 +273,21 @@ string glCapsViewerHttp::postReport(string xml)
 }
 
 /// <summary>
-/// Posts the given url to the db report update script 
+/// Posts the given report update (see glCapsViewerCore::reportUpdateToXml) to the db report update script 
+/// The update is sent compressed only if the server advertises support for it, and again as plain xml if the compressed update is not accepted
 /// </summary>
-/// <returns>Coma separated list of updated caps</returns>
+/// <returns>Server reply, see updateSucceeded</returns>
 string glCapsViewerHttp::postReportForUpdate(string xml)
 {
 	string httpReply;
 	stringstream urlss;
 	urlss << getBaseUrl() << "services/gl_updatereport.php";
+	if (checkCompressedUpdates()) {
+		httpReply = httpPost(urlss.str(), xml, true);
+		if (updateSucceeded(httpReply)) {
+			return httpReply;
+		}
+	}
 	httpReply = httpPost(urlss.str(), xml);
 	return httpReply;
 }
@@ -292,6 +362,26 @@ vector<reportInfo> glCapsViewerHttp::fetchDeviceReports(string device)
 /// Returns the base url of the OpenGL hardware database
 /// </summary>
 string glCapsViewerHttp::getBaseUrl()
+{
+	return (!baseUrl.empty()) ? baseUrl : getDefaultBaseUrl();
+}
+
+/// <summary>
+/// Sets the base url of the database to connect to (e.g. a local server for testing)
+/// </summary>
+/// <param name="url">Base url of the database, empty to use the default database</param>
+void glCapsViewerHttp::setBaseUrl(string url)
+{
+	if ((!url.empty()) && (url.back() != '/')) {
+		url += "/";
+	}
+	baseUrl = url;
+}
+
+/// <summary>
+/// Returns the url of the database selected at compile time
+/// </summary>
+string glCapsViewerHttp::getDefaultBaseUrl()
 {
 #ifdef DEVDATABASE
 	return "http://www.delphigl.de/opengldatabase_dev/";
@@ -27,6 +27,7 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QUrl>
+#include <QHttpMultiPart>
 #include <QDateTime>
 #include <QFile>
 #include <QDebug>
@@ -50,15 +51,22 @@ private:
 	QNetworkProxy *proxy;
 	QNetworkAccessManager *manager;
 	string httpGet(string url);
-	string httpPost(string url, string data);
-	string encodeUrl(string url);
+	string httpPost(string url, string data, bool compress = false);
+	static string baseUrl;
 public:
+	static string encodeUrl(string url);
+	static QHttpMultiPart* createMultiPart(string data, bool compress);
+	static bool supportsCompressedUpdates(const string& serverState);
+	static bool updateSucceeded(const string& reply);
+	bool checkCompressedUpdates();
 	int getReportId(string description);
 	bool checkReportPresent(string description);
 	vector<string> fetchDevices();
 	vector<reportInfo> fetchDeviceReports(string device);
 	bool checkServerConnection();
 	static string getBaseUrl();
+	static string getDefaultBaseUrl();
+	static void setBaseUrl(string url);
 	string fetchReport(int reportId);
 	string postReport(string xml);
 	string postReportForUpdate(string xml);
@@ -0,0 +1,441 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Optional performance probes run with the report context
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "glPerformanceProbe.h"
+#include "glCapsViewerCore.h"
+#include "textureUploadProbe.h"
+#include "readbackProbe.h"
+#include "compressedFormatProbe.h"
+#include "shaderCompileProbe.h"
+#include "drawSubmissionProbe.h"
+#include "bufferStreamingProbe.h"
+#include "fillRateProbe.h"
+#include "textureSamplingProbe.h"
+#include "imageAccessProbe.h"
+#include "mipmapGenerationProbe.h"
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void probeSamples::add(double time)
+	{
+		samples.push_back(time);
+	}
+
+	/// <summary>
+	/// Nearest rank percentile of the samples
+	/// </summary>
+	double probeSamples::percentile(double p) const
+	{
+		if (samples.empty()) {
+			return 0.0;
+		}
+		vector<double> sorted = samples;
+		sort(sorted.begin(), sorted.end());
+		size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+		return sorted[(rank > 0) ? min(rank - 1, sorted.size() - 1) : 0];
+	}
+
+	double probeSamples::median() const
+	{
+		return percentile(50.0);
+	}
+
+	void probeBindings::save()
+	{
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture2D);
+		if (GLEW_VERSION_1_5) {
+			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+		}
+		if ((GLEW_VERSION_2_1) || (GLEW_ARB_pixel_buffer_object)) {
+			glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+			glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+		}
+		if ((GLEW_VERSION_4_0) || (GLEW_ARB_draw_indirect)) {
+			glGetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &drawIndirectBuffer);
+		}
+		if ((GLEW_VERSION_3_0) || (GLEW_ARB_vertex_array_object)) {
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+		}
+		if (GLEW_VERSION_2_0) {
+			glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		}
+		if ((GLEW_VERSION_3_0) || (GLEW_ARB_framebuffer_object)) {
+			glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+			glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+		}
+		if ((GLEW_VERSION_4_2) || (GLEW_ARB_shader_image_load_store)) {
+			const GLenum imagePnames[6] = { GL_IMAGE_BINDING_NAME, GL_IMAGE_BINDING_LEVEL, GL_IMAGE_BINDING_LAYERED, GL_IMAGE_BINDING_LAYER, GL_IMAGE_BINDING_ACCESS, GL_IMAGE_BINDING_FORMAT };
+			for (int i = 0; i < 6; i++) {
+				glGetIntegeri_v(imagePnames[i], 0, &image[i]);
+			}
+		}
+	}
+
+	void probeBindings::restore()
+	{
+		glBindTexture(GL_TEXTURE_2D, texture2D);
+		if (GLEW_VERSION_1_5) {
+			glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+		}
+		if ((GLEW_VERSION_2_1) || (GLEW_ARB_pixel_buffer_object)) {
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+		}
+		if ((GLEW_VERSION_4_0) || (GLEW_ARB_draw_indirect)) {
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawIndirectBuffer);
+		}
+		if ((GLEW_VERSION_3_0) || (GLEW_ARB_vertex_array_object)) {
+			glBindVertexArray(vertexArray);
+		}
+		if (GLEW_VERSION_2_0) {
+			glUseProgram(program);
+		}
+		if ((GLEW_VERSION_3_0) || (GLEW_ARB_framebuffer_object)) {
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+		}
+		if ((GLEW_VERSION_4_2) || (GLEW_ARB_shader_image_load_store)) {
+			glBindImageTexture(0, image[0], image[1], (GLboolean)image[2], image[3], image[4], image[5]);
+		}
+	}
+
+	void glPerformanceProbes::clear()
+	{
+		values.clear();
+		messages.clear();
+	}
+
+	/// <summary>
+	/// Runs all probes supported by the current context, does nothing if probing is not enabled
+	/// </summary>
+	void glPerformanceProbes::run(glCapsViewerCore& core)
+	{
+		clear();
+		if (!enabled) {
+			return;
+		}
+		textureUploadProbe textureUpload;
+		runProbe(textureUpload, core);
+		readbackProbe readback;
+		runProbe(readback, core);
+		compressedFormatProbe compressedFormats;
+		runProbe(compressedFormats, core);
+		shaderCompileProbe shaderCompile;
+		runProbe(shaderCompile, core);
+		drawSubmissionProbe drawSubmission;
+		runProbe(drawSubmission, core);
+		bufferStreamingProbe bufferStreaming;
+		runProbe(bufferStreaming, core);
+		fillRateProbe fillRate;
+		runProbe(fillRate, core);
+		textureSamplingProbe textureSampling;
+		runProbe(textureSampling, core);
+		imageAccessProbe imageAccess;
+		runProbe(imageAccess, core);
+		mipmapGenerationProbe mipmapGeneration;
+		runProbe(mipmapGeneration, core);
+	}
+
+	void glPerformanceProbes::runProbe(glPerformanceProbe& probe, glCapsViewerCore& core)
+	{
+		string reason;
+		if (!probe.supported(core, reason)) {
+			addMessage(probe.name(), "skipped, " + reason);
+			return;
+		}
+		clearErrors();
+		probeBindings bindings;
+		bindings.save();
+		probe.run(core, *this);
+		GLenum error = glGetError();
+		if (error != GL_NO_ERROR) {
+			addMessage(probe.name(), "finished with OpenGL error " + core.getEnumName(error));
+		}
+		bindings.restore();
+		clearErrors();
+	}
+
+	void glPerformanceProbes::addValue(const string& probe, const string& name, const string& metric, double value)
+	{
+		performanceValue performance;
+		performance.probe = probe;
+		performance.name = name;
+		performance.metric = metric;
+		performance.value = value;
+		values.push_back(performance);
+	}
+
+	void glPerformanceProbes::addMessage(const string& probe, const string& message)
+	{
+		messages.push_back(probe + " : " + message);
+	}
+
+	/// <summary>
+	/// Lists all values grouped by probe, followed by skipped probes and cases
+	/// </summary>
+	string glPerformanceProbes::reportToText()
+	{
+		stringstream ss;
+		string probe;
+		for (auto& value : values) {
+			if (value.probe != probe) {
+				probe = value.probe;
+				ss << (ss.tellp() > 0 ? "\n" : "") << probe << "\n";
+			}
+			ss << "  " << left << setw(64) << value.name << setw(20) << value.metric << right << setw(14) << formatValue(value.value) << "\n";
+		}
+		if (!messages.empty()) {
+			ss << "\nMessages (" << messages.size() << ")\n";
+			for (auto& message : messages) {
+				ss << "  " << message << "\n";
+			}
+		}
+		return ss.str();
+	}
+
+	void glPerformanceProbes::exportReport(string fileName, string header)
+	{
+		ofstream destfile(fileName);
+		destfile << header << "\n\n" << reportToText();
+	}
+
+	/// <summary>
+	/// Measures the wall clock time of OpenGL work, the pipeline is drained before and after the work
+	/// </summary>
+	/// <returns>Time in microseconds</returns>
+	double glPerformanceProbes::timeFinished(function<void()> work)
+	{
+		glFinish();
+		clock::time_point start = clock::now();
+		work();
+		glFinish();
+		return chrono::duration<double, micro>(clock::now() - start).count();
+	}
+
+	/// <summary>
+	/// Times the work once to warm up and then sampleCount times
+	/// </summary>
+	/// <returns>Median time in microseconds</returns>
+	double glPerformanceProbes::medianTime(function<void()> work)
+	{
+		timeFinished(work);
+		probeSamples samples;
+		for (int i = 0; i < sampleCount; i++) {
+			samples.add(timeFinished(work));
+		}
+		return samples.median();
+	}
+
+	void glPerformanceProbes::clearErrors()
+	{
+		int maxErrors = 32;
+		while ((glGetError() != GL_NO_ERROR) && (maxErrors-- > 0));
+	}
+
+	/// <summary>
+	/// Compiles and links a program from a vertex and a fragment shader
+	/// </summary>
+	/// <param name="log">Receives the info log of the stage that failed</param>
+	/// <returns>Program name, 0 if compiling or linking failed</returns>
+	GLuint glPerformanceProbes::createProgram(const string& vertexSource, const string& fragmentSource, string& log)
+	{
+		vector<pair<GLenum, string>> stages;
+		stages.push_back(make_pair((GLenum)GL_VERTEX_SHADER, vertexSource));
+		stages.push_back(make_pair((GLenum)GL_FRAGMENT_SHADER, fragmentSource));
+		return createProgram(stages, log);
+	}
+
+	/// <summary>
+	/// Compiles and links a program from shader stages and their sources (e.g. a single GL_COMPUTE_SHADER)
+	/// </summary>
+	GLuint glPerformanceProbes::createProgram(const vector<pair<GLenum, string>>& stages, string& log)
+	{
+		GLuint program = glCreateProgram();
+		GLint status;
+		for (auto& stage : stages) {
+			GLuint shader = glCreateShader(stage.first);
+			const char* source = stage.second.c_str();
+			glShaderSource(shader, 1, &source, nullptr);
+			glCompileShader(shader);
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+			if (status != GL_TRUE) {
+				GLint length = 0;
+				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+				vector<char> infoLog(max(length, 1));
+				glGetShaderInfoLog(shader, (GLsizei)infoLog.size(), nullptr, infoLog.data());
+				log = infoLog.data();
+				glDeleteShader(shader);
+				glDeleteProgram(program);
+				return 0;
+			}
+			glAttachShader(program, shader);
+			// Flagged for deletion, deleted with the program
+			glDeleteShader(shader);
+		}
+		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE) {
+			GLint length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+			vector<char> infoLog(max(length, 1));
+			glGetProgramInfoLog(program, (GLsizei)infoLog.size(), nullptr, infoLog.data());
+			log = infoLog.data();
+			glDeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+	/// <summary>
+	/// Vertex shader for a fullscreen triangle drawn without vertex attributes (glDrawArrays(GL_TRIANGLES, 0, 3) with an empty vertex array), passes uv to the fragment shader
+	/// </summary>
+	string glPerformanceProbes::fullscreenVertexSource()
+	{
+		return
+			"#version 330\n"
+			"out vec2 uv;\n"
+			"void main()\n"
+			"{\n"
+			"	uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+			"	gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);\n"
+			"}\n";
+	}
+
+	/// <summary>
+	/// Size of a pixel in client memory
+	/// </summary>
+	/// <returns>Size in bytes, 0 for unknown format and type combinations</returns>
+	size_t glPerformanceProbes::pixelSize(GLenum format, GLenum type)
+	{
+		// Packed types contain all components
+		switch (type) {
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_10_10_10_2:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			return 4;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+		}
+
+		size_t components = 0;
+		switch (format) {
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+			components = 1;
+			break;
+		case GL_RG:
+		case GL_RG_INTEGER:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			components = 3;
+			break;
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+		case GL_BGRA_INTEGER:
+			components = 4;
+			break;
+		default:
+			return 0;
+		}
+
+		switch (type) {
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			return components;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_HALF_FLOAT:
+			return components * 2;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+			return components * 4;
+		default:
+			return 0;
+		}
+	}
+
+	/// <summary>
+	/// Support of a format for an operation (e.g. GL_FILTER), from the internal format sweep or queried if the format is not part of the sweep
+	/// </summary>
+	/// <param name="unknown">Returned if the support can't be queried (no GL_ARB_internalformat_query2)</param>
+	/// <returns>GL_FULL_SUPPORT, GL_CAVEAT_SUPPORT or GL_NONE</returns>
+	GLint glPerformanceProbes::formatSupport(glCapsViewerCore& core, GLenum target, GLenum format, GLenum pname, GLint unknown)
+	{
+		GLint value;
+		const internalFormatTarget* formatTarget = core.getInternalFormatTarget(target);
+		if (formatTarget != nullptr) {
+			for (auto& textureFormat : formatTarget->textureFormats) {
+				if ((textureFormat.textureFormat == format) && (textureFormat.supported) && (textureFormat.getValue(pname, value))) {
+					return value;
+				}
+			}
+		}
+		if (!core.extensionSupported("GL_ARB_internalformat_query2")) {
+			return unknown;
+		}
+		value = unknown;
+		glGetInternalformativ(target, format, pname, 1, &value);
+		return value;
+	}
+
+	/// <summary>
+	/// Formats a measured value with up to six significant digits
+	/// </summary>
+	string glPerformanceProbes::formatValue(double value)
+	{
+		stringstream ss;
+		ss << setprecision(6) << value;
+		return ss.str();
+	}
+
+}
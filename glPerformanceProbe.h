@@ -0,0 +1,133 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Optional performance probes run with the report context
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <GL/glew.h>
+
+class glCapsViewerCore;
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Single measured value, stored in the report as "probe/name/metric" (e.g. "textureupload/GL_RGBA GL_BGRA GL_UNSIGNED_BYTE/direct_mbps")
+	/// </summary>
+	class performanceValue
+	{
+	public:
+		string probe;
+		string name;
+		string metric;
+		double value;
+	};
+
+	/// <summary>
+	/// Timed samples of a measured case in microseconds
+	/// </summary>
+	class probeSamples
+	{
+	public:
+		vector<double> samples;
+		void add(double time);
+		double percentile(double p) const;
+		double median() const;
+	};
+
+	/// <summary>
+	/// Object bindings changed by the probes, saved before and restored after every probe by glPerformanceProbes::runProbe
+	/// Only bindings the context supports are saved, the element array buffer is vertex array state and is restored with the vertex array
+	/// </summary>
+	class probeBindings
+	{
+	private:
+		GLint texture2D = 0;
+		GLint arrayBuffer = 0;
+		GLint packBuffer = 0;
+		GLint unpackBuffer = 0;
+		GLint drawIndirectBuffer = 0;
+		GLint vertexArray = 0;
+		GLint program = 0;
+		GLint drawFramebuffer = 0;
+		GLint readFramebuffer = 0;
+		// Image unit 0 (name, level, layered, layer, access, format)
+		GLint image[6] = { 0, 0, 0, 0, GL_READ_ONLY, GL_R8 };
+	public:
+		void save();
+		void restore();
+	};
+
+	class glPerformanceProbes;
+
+	/// <summary>
+	/// Measures one aspect of the implementation with the current context and adds the results to the probe list
+	/// Probes must leave the context state as they found it, bindings are restored by the probe list (see probeBindings), other state (pixel store, enables, parameters of existing objects) by the probe itself
+	/// </summary>
+	class glPerformanceProbe
+	{
+	public:
+		virtual ~glPerformanceProbe() {}
+		// Short name used as key in the report (e.g. "textureupload")
+		virtual string name() const = 0;
+		// Returns false with a reason if the context lacks the required version or extensions
+		virtual bool supported(glCapsViewerCore& core, string& reason) const = 0;
+		virtual void run(glCapsViewerCore& core, glPerformanceProbes& probes) = 0;
+	};
+
+	/// <summary>
+	/// Runs all performance probes, measurements use the wall clock around glFinish so they also work on implementations without timer queries (e.g. llvmpipe)
+	/// </summary>
+	class glPerformanceProbes
+	{
+	private:
+		void runProbe(glPerformanceProbe& probe, glCapsViewerCore& core);
+	public:
+		typedef chrono::high_resolution_clock clock;
+		bool enabled = false;
+		// Timed samples per measured case, the median is reported
+		int sampleCount = 5;
+		vector<performanceValue> values;
+		// Skipped probes and cases with the reason
+		vector<string> messages;
+		void clear();
+		void run(glCapsViewerCore& core);
+		void addValue(const string& probe, const string& name, const string& metric, double value);
+		void addMessage(const string& probe, const string& message);
+		string reportToText();
+		void exportReport(string fileName, string header);
+		double medianTime(function<void()> work);
+		static double timeFinished(function<void()> work);
+		static void clearErrors();
+		static GLuint createProgram(const string& vertexSource, const string& fragmentSource, string& log);
+		static GLuint createProgram(const vector<pair<GLenum, string>>& stages, string& log);
+		static string fullscreenVertexSource();
+		static size_t pixelSize(GLenum format, GLenum type);
+		static GLint formatSupport(glCapsViewerCore& core, GLenum target, GLenum format, GLenum pname, GLint unknown);
+		static string formatValue(double value);
+	};
+
+}
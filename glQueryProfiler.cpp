@@ -0,0 +1,227 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* OpenGL query profiler
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "glQueryProfiler.h"
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Adds a single query sample to the stats
+	/// </summary>
+	/// <param name="time">Query time in microseconds</param>
+	/// <param name="error">OpenGL error reported after the query</param>
+	void glQueryStats::addSample(double time, GLenum error)
+	{
+		calls++;
+		totalTime += time;
+		maxTime = max(maxTime, time);
+		if (error != GL_NO_ERROR) {
+			errors++;
+			lastError = error;
+		}
+		int bucket = 0;
+		double bucketLimit = 1.0;
+		while ((time >= bucketLimit) && (bucket < histogramBuckets - 1)) {
+			bucketLimit *= 2.0;
+			bucket++;
+		}
+		histogram[bucket]++;
+	}
+
+	double glQueryStats::meanTime() const
+	{
+		return (calls > 0) ? totalTime / calls : 0.0;
+	}
+
+	double glQueryStats::errorRate() const
+	{
+		return (calls > 0) ? (double)errors / calls : 0.0;
+	}
+
+	/// <summary>
+	/// Returns the non-empty histogram buckets as a compact string
+	/// </summary>
+	/// <returns>String with bucket ranges and sample counts (e.g. "<1us:3 2-4us:1")</returns>
+	string glQueryStats::histogramToString() const
+	{
+		stringstream ss;
+		for (int i = 0; i < histogramBuckets; i++) {
+			if (histogram[i] == 0) {
+				continue;
+			}
+			if (ss.tellp() > 0) {
+				ss << " ";
+			}
+			if (i == 0) {
+				ss << "<1us";
+			}
+			else if (i == histogramBuckets - 1) {
+				ss << ">=" << (1 << (i - 1)) << "us";
+			}
+			else {
+				ss << (1 << (i - 1)) << "-" << (1 << i) << "us";
+			}
+			ss << ":" << histogram[i];
+		}
+		return ss.str();
+	}
+
+	glQueryProfiler::clock::time_point glQueryProfiler::now()
+	{
+		return clock::now();
+	}
+
+	void glQueryProfiler::clear()
+	{
+		capStats.clear();
+		formatStats.clear();
+		pnameStats.clear();
+	}
+
+	double elapsedMicroseconds(glQueryProfiler::clock::time_point start, glQueryProfiler::clock::time_point end)
+	{
+		return chrono::duration<double, micro>(end - start).count();
+	}
+
+	/// <summary>
+	/// Records a capability query (glGet*)
+	/// </summary>
+	/// <param name="capName">Name of the capability as listed in the caps list</param>
+	/// <param name="pname">OpenGL enum that has been queried</param>
+	/// <param name="start">Time point at which the query has been issued</param>
+	/// <param name="end">Time point at which the query returned</param>
+	/// <param name="error">OpenGL error reported after the query</param>
+	void glQueryProfiler::recordCap(const string& capName, GLenum pname, clock::time_point start, clock::time_point end, GLenum error)
+	{
+		if (!enabled) {
+			return;
+		}
+		double time = elapsedMicroseconds(start, end);
+		capStats[capName].addSample(time, error);
+		pnameStats[pname].addSample(time, error);
+	}
+
+	/// <summary>
+	/// Records an internal format query (glGetInternalformativ)
+	/// </summary>
+	void glQueryProfiler::recordInternalFormat(GLenum target, GLenum format, GLenum pname, clock::time_point start, clock::time_point end, GLenum error)
+	{
+		if (!enabled) {
+			return;
+		}
+		double time = elapsedMicroseconds(start, end);
+		formatStats[make_pair(target, format)].addSample(time, error);
+		pnameStats[pname].addSample(time, error);
+	}
+
+	struct rankedStats
+	{
+		string name;
+		const glQueryStats* stats;
+	};
+
+	void writeRanking(stringstream& ss, string caption, vector<rankedStats>& ranking, bool errorsOnly)
+	{
+		if (errorsOnly) {
+			ranking.erase(remove_if(ranking.begin(), ranking.end(), [](const rankedStats& r) { return r.stats->errors == 0; }), ranking.end());
+			sort(ranking.begin(), ranking.end(), [](const rankedStats& a, const rankedStats& b) {
+				return (a.stats->errorRate() != b.stats->errorRate()) ? a.stats->errorRate() > b.stats->errorRate() : a.stats->errors > b.stats->errors;
+			});
+		}
+		else {
+			sort(ranking.begin(), ranking.end(), [](const rankedStats& a, const rankedStats& b) { return a.stats->totalTime > b.stats->totalTime; });
+		}
+
+		ss << caption << " (" << ranking.size() << ")\n";
+		ss << left << setw(6) << "rank" << setw(56) << "name" << right << setw(8) << "calls" << setw(12) << "total us" << setw(10) << "mean us" << setw(10) << "max us" << setw(8) << "errors" << setw(8) << "rate" << "  histogram\n";
+		int rank = 1;
+		for (auto& entry : ranking) {
+			const glQueryStats& stats = *entry.stats;
+			ss << left << setw(6) << rank++ << setw(56) << entry.name << right << setw(8) << stats.calls;
+			ss << fixed << setprecision(1) << setw(12) << stats.totalTime << setw(10) << stats.meanTime() << setw(10) << stats.maxTime;
+			ss << setw(8) << stats.errors << setw(7) << setprecision(0) << stats.errorRate() * 100.0 << "%";
+			ss << "  " << stats.histogramToString() << "\n";
+		}
+		ss << "\n";
+	}
+
+	/// <summary>
+	/// Generates a ranked text report of all recorded queries
+	/// </summary>
+	/// <param name="getEnumName">Function used to resolve OpenGL enum names</param>
+	/// <returns>Report with rankings by total time per capability, internal format and pname, and by error rate</returns>
+	string glQueryProfiler::reportToText(function<string(GLint)> getEnumName)
+	{
+		vector<rankedStats> caps;
+		for (auto& stats : capStats) {
+			caps.push_back({ stats.first, &stats.second });
+		}
+		vector<rankedStats> formats;
+		for (auto& stats : formatStats) {
+			formats.push_back({ getEnumName(stats.first.first) + " " + getEnumName(stats.first.second), &stats.second });
+		}
+		vector<rankedStats> pnames;
+		for (auto& stats : pnameStats) {
+			pnames.push_back({ getEnumName(stats.first), &stats.second });
+		}
+
+		int totalCalls = 0;
+		int totalErrors = 0;
+		double totalTime = 0.0;
+		for (auto& stats : pnameStats) {
+			totalCalls += stats.second.calls;
+			totalErrors += stats.second.errors;
+			totalTime += stats.second.totalTime;
+		}
+
+		stringstream ss;
+		ss << "glCapsViewer OpenGL query profile\n\n";
+		ss << "Queries : " << totalCalls << "\n";
+		ss << "Errors  : " << totalErrors << "\n";
+		ss << "Time    : " << fixed << setprecision(3) << totalTime / 1000.0 << " ms\n\n";
+
+		writeRanking(ss, "Capabilities by total time", caps, false);
+		writeRanking(ss, "Internal formats by total time", formats, false);
+		writeRanking(ss, "Pnames by total time", pnames, false);
+		vector<rankedStats> failedCaps = caps;
+		writeRanking(ss, "Capabilities by error rate", failedCaps, true);
+		vector<rankedStats> failedPnames = pnames;
+		writeRanking(ss, "Pnames by error rate", failedPnames, true);
+
+		return ss.str();
+	}
+
+	void glQueryProfiler::exportReport(string fileName, function<string(GLint)> getEnumName)
+	{
+		ofstream destfile;
+		destfile.open(fileName);
+		destfile << reportToText(getEnumName);
+		destfile.close();
+	}
+
+}
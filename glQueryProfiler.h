@@ -0,0 +1,101 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* OpenGL query profiler
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <GL/glew.h>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class glQueryStats
+	{
+	public:
+		// Latency histogram with power of two buckets in microseconds (<1, 1-2, 2-4, ...)
+		static const int histogramBuckets = 16;
+		int calls = 0;
+		int errors = 0;
+		GLenum lastError = GL_NO_ERROR;
+		double totalTime = 0.0;
+		double maxTime = 0.0;
+		int histogram[histogramBuckets] = {};
+		void addSample(double time, GLenum error);
+		double meanTime() const;
+		double errorRate() const;
+		string histogramToString() const;
+	};
+
+	class glQueryProfiler
+	{
+	public:
+		typedef chrono::high_resolution_clock clock;
+		bool enabled = false;
+		// Stats per capability name (e.g. GL_MAX_TEXTURE_SIZE)
+		map<string, glQueryStats> capStats;
+		// Stats per internal format query (target, format)
+		map<pair<GLenum, GLenum>, glQueryStats> formatStats;
+		// Stats per queried pname
+		map<GLenum, glQueryStats> pnameStats;
+		static clock::time_point now();
+		void clear();
+		void recordCap(const string& capName, GLenum pname, clock::time_point start, clock::time_point end, GLenum error);
+		void recordInternalFormat(GLenum target, GLenum format, GLenum pname, clock::time_point start, clock::time_point end, GLenum error);
+		/// <summary>
+		/// Issues a query, the time stamps immediately around it are only taken if profiling is enabled
+		/// </summary>
+		template<typename Query> static void timeQuery(const glQueryProfiler* profiler, clock::time_point& start, clock::time_point& end, Query query)
+		{
+			if ((profiler == nullptr) || (!profiler->enabled)) {
+				query();
+				return;
+			}
+			start = now();
+			query();
+			end = now();
+		}
+		/// <summary>
+		/// Issues a capability query, the error state is only flushed and checked if profiling is enabled
+		/// </summary>
+		template<typename Query> void queryCap(const string& capName, GLenum pname, Query query)
+		{
+			if (!enabled) {
+				query();
+				return;
+			}
+			// Flush OpenGL error state, so the profile records the error of the query itself
+			glGetError();
+			clock::time_point start;
+			clock::time_point end;
+			timeQuery(this, start, end, query);
+			recordCap(capName, pname, start, end, glGetError());
+		}
+		string reportToText(function<string(GLint)> getEnumName);
+		void exportReport(string fileName, function<string(GLint)> getEnumName);
+	};
+
+}
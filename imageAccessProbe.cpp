@@ -0,0 +1,202 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Image load/store and atomic throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "imageAccessProbe.h"
+#include "glCapsViewerCore.h"
+#include <sstream>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string imageAccessProbe::name() const
+	{
+		return "imageaccess";
+	}
+
+	bool imageAccessProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if ((!GLEW_VERSION_4_3) && ((!GLEW_VERSION_4_2) || (!GLEW_ARB_compute_shader))) {
+			reason = "requires OpenGL 4.3 or OpenGL 4.2 with GL_ARB_compute_shader";
+			return false;
+		}
+		return true;
+	}
+
+	vector<imageAccessFormat> imageAccessProbe::imageFormats()
+	{
+		imageAccessFormat formats[] = {
+			{ GL_RGBA32F, "rgba32f", "", 16 },
+			{ GL_RGBA16F, "rgba16f", "", 8 },
+			{ GL_RG32F, "rg32f", "", 8 },
+			{ GL_R32F, "r32f", "", 4 },
+			{ GL_R11F_G11F_B10F, "r11f_g11f_b10f", "", 4 },
+			{ GL_RGBA16, "rgba16", "", 8 },
+			{ GL_RGB10_A2, "rgb10_a2", "", 4 },
+			{ GL_RGBA8, "rgba8", "", 4 },
+			{ GL_RGBA32UI, "rgba32ui", "u", 16 },
+			{ GL_RGBA8UI, "rgba8ui", "u", 4 },
+			{ GL_R32UI, "r32ui", "u", 4 },
+			{ GL_R32I, "r32i", "i", 4 },
+		};
+		return vector<imageAccessFormat>(formats, formats + sizeof(formats) / sizeof(formats[0]));
+	}
+
+	/// <summary>
+	/// Version, work group size and the image declaration shared by all kernels of a format
+	/// </summary>
+	string imageAccessProbe::shaderHeader(const imageAccessFormat& format)
+	{
+		stringstream ss;
+		if (GLEW_VERSION_4_3) {
+			ss << "#version 430\n";
+		}
+		else {
+			ss << "#version 420\n"
+				<< "#extension GL_ARB_compute_shader : require\n";
+		}
+		ss << "layout(local_size_x = 8, local_size_y = 8) in;\n"
+			<< "layout(" << format.layout << ", binding = 0) uniform " << format.typePrefix << "image2D image;\n"
+			<< "const ivec2 size = ivec2(" << imageSize << ");\n";
+		return ss.str();
+	}
+
+	/// <returns>Median time of a dispatch over the whole image in microseconds</returns>
+	double imageAccessProbe::measureKernel(glPerformanceProbes& probes, GLuint program)
+	{
+		glUseProgram(program);
+		double time = probes.medianTime([&]() {
+			for (int i = 0; i < dispatchesPerSample; i++) {
+				glDispatchCompute(imageSize / 8, imageSize / 8, 1);
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+			}
+		});
+		return time / dispatchesPerSample;
+	}
+
+	/// <summary>
+	/// Support reported for an operation as value: 1 full support, 0.5 supported with caveats, 0 not supported
+	/// </summary>
+	double supportValue(GLint support)
+	{
+		switch (support) {
+		case GL_FULL_SUPPORT:
+			return 1.0;
+		case GL_CAVEAT_SUPPORT:
+			return 0.5;
+		}
+		return 0.0;
+	}
+
+	void imageAccessProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		double invocations = (double)imageSize * imageSize;
+		for (auto& format : imageFormats()) {
+			string formatName = core.getEnumName(format.format);
+			string vectorType = format.typePrefix + "vec4";
+			// Operations are tried if support can't be queried
+			GLint loadSupport = glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format.format, GL_SHADER_IMAGE_LOAD, GL_FULL_SUPPORT);
+			GLint storeSupport = glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format.format, GL_SHADER_IMAGE_STORE, GL_FULL_SUPPORT);
+			bool atomicFormat = ((format.format == GL_R32UI) || (format.format == GL_R32I));
+			GLint atomicSupport = atomicFormat ? glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format.format, GL_SHADER_IMAGE_ATOMIC, GL_FULL_SUPPORT) : GL_NONE;
+			probes.addValue(name(), formatName, "load_support", supportValue(loadSupport));
+			probes.addValue(name(), formatName, "store_support", supportValue(storeSupport));
+			if (atomicFormat) {
+				probes.addValue(name(), formatName, "atomic_support", supportValue(atomicSupport));
+			}
+			if ((loadSupport == GL_NONE) && (storeSupport == GL_NONE) && (atomicSupport == GL_NONE)) {
+				continue;
+			}
+
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glPerformanceProbes::clearErrors();
+			glTexStorage2D(GL_TEXTURE_2D, 1, format.format, imageSize, imageSize);
+			glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_READ_WRITE, format.format);
+			if (glGetError() != GL_NO_ERROR) {
+				probes.addMessage(name(), formatName + " skipped, image could not be created");
+				glDeleteTextures(1, &texture);
+				continue;
+			}
+
+			// Kernel names and the body of their main function
+			vector<pair<string, string>> kernels;
+			if (storeSupport != GL_NONE) {
+				kernels.push_back(make_pair("store",
+					"	imageStore(image, coord, " + vectorType + "(coord.xyxy));\n"));
+			}
+			if (loadSupport != GL_NONE) {
+				// Loaded values are only stored if they match a value the image doesn't contain, so the loads can't be optimized away
+				kernels.push_back(make_pair("load",
+					"	" + vectorType + " sum = " + vectorType + "(0);\n"
+					"	for (int i = 0; i < " + to_string(loadsPerInvocation) + "; i++) {\n"
+					"		sum += imageLoad(image, (coord + ivec2(i * 17, i * 31)) % size);\n"
+					"	}\n"
+					"	if (sum == " + vectorType + "(" + ((format.typePrefix == "") ? "-1.0e30" : "-7") + ")) {\n"
+					"		imageStore(image, coord, sum);\n"
+					"	}\n"));
+			}
+			if (atomicSupport != GL_NONE) {
+				string one = (format.typePrefix == "u") ? "1u" : "1";
+				kernels.push_back(make_pair("atomic", "	imageAtomicAdd(image, coord, " + one + ");\n"));
+				kernels.push_back(make_pair("atomic_contended", "	imageAtomicAdd(image, ivec2(0), " + one + ");\n"));
+			}
+
+			for (auto& kernel : kernels) {
+				string source = shaderHeader(format) +
+					"void main()\n"
+					"{\n"
+					"	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);\n" +
+					kernel.second +
+					"}\n";
+				vector<pair<GLenum, string>> stages;
+				stages.push_back(make_pair((GLenum)GL_COMPUTE_SHADER, source));
+				string log;
+				GLuint program = glPerformanceProbes::createProgram(stages, log);
+				if (program == 0) {
+					probes.addMessage(name(), formatName + " " + kernel.first + " skipped, program failed: " + log);
+					continue;
+				}
+				glPerformanceProbes::clearErrors();
+				double time = measureKernel(probes, program);
+				glDeleteProgram(program);
+				if ((glGetError() != GL_NO_ERROR) || (time <= 0.0)) {
+					probes.addMessage(name(), formatName + " " + kernel.first + " skipped, dispatch failed");
+					continue;
+				}
+				if (kernel.first == "store") {
+					probes.addValue(name(), formatName, "store_mbps", invocations * format.texelSize / time);
+				}
+				else if (kernel.first == "load") {
+					probes.addValue(name(), formatName, "load_mbps", invocations * loadsPerInvocation * format.texelSize / time);
+				}
+				else {
+					probes.addValue(name(), formatName, kernel.first + "_mops_per_s", invocations / time);
+				}
+			}
+
+			glDeleteTextures(1, &texture);
+		}
+	}
+
+}
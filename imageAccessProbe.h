@@ -0,0 +1,71 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Image load/store and atomic throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Image format with its GLSL layout qualifier
+	/// </summary>
+	class imageAccessFormat
+	{
+	public:
+		GLenum format;
+		string layout;
+		// GLSL type prefix, "" for float and normalized formats, "u" and "i" for integer formats
+		string typePrefix;
+		int texelSize;
+	};
+
+	/// <summary>
+	/// Measures imageLoad and imageStore bandwidth of compute shaders for common image formats,
+	/// and the throughput of imageAtomicAdd on distinct texels (uncontended) and on a single texel (contended) for GL_R32UI and GL_R32I
+	/// Each operation is only measured for formats that report support for it (GL_SHADER_IMAGE_LOAD, GL_SHADER_IMAGE_STORE, GL_SHADER_IMAGE_ATOMIC),
+	/// the support is recorded with the results
+	/// </summary>
+	class imageAccessProbe : public glPerformanceProbe
+	{
+	private:
+		string shaderHeader(const imageAccessFormat& format);
+		double measureKernel(glPerformanceProbes& probes, GLuint program);
+	public:
+		// Width and height of the image
+		int imageSize = 1024;
+		// Loads per invocation, must match the load kernel
+		int loadsPerInvocation = 4;
+		// Dispatches over the whole image per timed sample
+		int dispatchesPerSample = 4;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static vector<imageAccessFormat> imageFormats();
+	};
+
+}
@@ -38,4 +38,19 @@ namespace capsViewer {
 		formatInfoValues.push_back(value);
 	}
 
+	/// <summary>
+	/// Returns a queried value of the format
+	/// </summary>
+	/// <returns>false if the value has not been queried (e.g. format not supported)</returns>
+	bool internalFormatInfo::getValue(GLenum infoenum, GLint& value) const
+	{
+		for (auto& formatInfoValue : formatInfoValues) {
+			if (formatInfoValue.infoEnum == infoenum) {
+				value = formatInfoValue.infoValue;
+				return true;
+			}
+		}
+		return false;
+	}
+
 }
\ No newline at end of file
@@ -48,6 +48,7 @@ namespace capsViewer {
 		vector<internalFormatInfoValue> formatInfoValues;
 		internalFormatInfo(GLenum format);
 		void addValueInfo(internalFormatInfoType type, GLenum infoenum, string infostring);
+		bool getValue(GLenum infoenum, GLint& value) const;
 	};
 
 }
@@ -41,6 +41,27 @@ namespace capsViewer {
 		}
 	}
 
+	/// <summary>
+	/// Queries a single internal format value, timing and error checking it if profiling is enabled
+	/// </summary>
+	/// <param name="format">Internal format to query</param>
+	/// <param name="pname">OpenGL enum of the value to query</param>
+	/// <param name="value">Receives the queried value</param>
+	void internalFormatTarget::queryInternalFormat(GLenum format, GLenum pname, GLint* value)
+	{
+		if ((profiler == nullptr) || (!profiler->enabled)) {
+			glGetInternalformativ(target, format, pname, 1, value);
+			return;
+		}
+		// Flush OpenGL error state
+		glGetError();
+		glQueryProfiler::clock::time_point queryStart = glQueryProfiler::now();
+		glGetInternalformativ(target, format, pname, 1, value);
+		glQueryProfiler::clock::time_point queryEnd = glQueryProfiler::now();
+		GLenum glerr = glGetError();
+		profiler->recordInternalFormat(target, format, pname, queryStart, queryEnd, glerr);
+	}
+
 	void internalFormatTarget::getInternalFormatInfo(bool internalformatquery2)
 	{
 		// TODO : List of internalFormats from xml
@@ -53,7 +74,7 @@ namespace capsViewer {
 
 			// Check if internal format is supported
 			GLint formatSupported;
-			glGetInternalformativ(target, textureFormat.textureFormat, GL_INTERNALFORMAT_SUPPORTED, 1, &formatSupported);
+			queryInternalFormat(textureFormat.textureFormat, GL_INTERNALFORMAT_SUPPORTED, &formatSupported);
 			textureFormat.supported = (formatSupported == GL_TRUE);
 
 			if (!textureFormat.supported) {
@@ -73,7 +94,7 @@ namespace capsViewer {
 
 			// Compressed format block sizes
 			GLint compressedFormat;
-			glGetInternalformativ(target, textureFormat.textureFormat, GL_TEXTURE_COMPRESSED, 1, &compressedFormat);
+			queryInternalFormat(textureFormat.textureFormat, GL_TEXTURE_COMPRESSED, &compressedFormat);
 			if (compressedFormat == GL_TRUE) {
 				textureFormat.addValueInfo(infoTypeValue, GL_TEXTURE_COMPRESSED_BLOCK_WIDTH, "GL_TEXTURE_COMPRESSED_BLOCK_WIDTH");
 				textureFormat.addValueInfo(infoTypeValue, GL_TEXTURE_COMPRESSED_BLOCK_HEIGHT, "GL_TEXTURE_COMPRESSED_BLOCK_HEIGHT");
@@ -109,8 +130,8 @@ namespace capsViewer {
 
 			// Fetch values
 			for (auto& formatInfoValue : textureFormat.formatInfoValues) {
-				glGetInternalformativ(target, textureFormat.textureFormat, formatInfoValue.infoEnum, 1, &formatInfoValue.infoValue);
-				// TODO : Check glerror
+				// Errors are only checked (and recorded) when profiling
+				queryInternalFormat(textureFormat.textureFormat, formatInfoValue.infoEnum, &formatInfoValue.infoValue);
 			}
 
 		}
@@ -27,6 +27,7 @@
 #include <GL/glew.h>
 #include <vector>
 #include "internalFormatInfo.h"
+#include "glQueryProfiler.h"
 
 
 #pragma once
@@ -39,8 +40,11 @@ namespace capsViewer {
 	public:
 		GLenum target;
 		vector<capsViewer::internalFormatInfo> textureFormats;
+		glQueryProfiler* profiler = nullptr;
 		internalFormatTarget(GLenum target, vector<GLint> compressedFormats);
 		void getInternalFormatInfo(bool internalformatquery2);
+	private:
+		void queryInternalFormat(GLenum format, GLenum pname, GLint* value);
 	};
 
 }
@@ -21,20 +21,33 @@
 #include "glCapsViewer.h"
 #include "glCapsViewerCore.h"
 #include "glCapsViewerHttp.h"
+#include "reportAggregator.h"
+#include "reportColumnStore.h"
+#include "reportFetcher.h"
+#include "driverTimeline.h"
+#include "reportArchive.h"
+#include "mappedReportArchive.h"
+#include "settings.h"
 #include <sstream>  
 #include <fstream>
+#include <iostream>
 #include <GL/glew.h>
 #ifdef _WIN32
 	#include <GL/wglew.h>
 #endif
 #include <GLFW/glfw3.h>
 #include <QtWidgets/QApplication>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QElapsedTimer>
 #include <QTreeWidgetItem>
 #include <QListWidgetItem>
 #include <QTableWidgetItem>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QFileInfo>
+#include <QEventLoop>
+#include <QDir>
 
 void glfw_error_callback(int error, const char* description)
 {
@@ -58,11 +71,455 @@ void glfw_error_callback(int error, const char* description)
 	QMessageBox::critical(NULL, "glCapsViewer - Error", QString::fromStdString(errorStr.str()));
 }
 
+/// <summary>
+/// glcapsviewer aggregate <dir> [--threads <n>] [--out <file>]
+/// Statistics over all report files of a directory, runs without a window or OpenGL context
+/// </summary>
+int aggregateReports(QStringList args)
+{
+	string directory;
+	string outFile;
+	capsViewer::reportAggregator aggregator;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--threads") && hasValue) {
+			aggregator.threadCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--out") && hasValue) {
+			outFile = args[++i].toStdString();
+		}
+		else if ((!args[i].startsWith("-")) && (directory.empty())) {
+			directory = args[i].toStdString();
+		}
+		else {
+			directory = "";
+			break;
+		}
+	}
+	if (directory.empty()) {
+		cerr << "Usage: glcapsviewer aggregate <dir> [--threads <n>] [--out <file>]\n";
+		return -1;
+	}
+
+	vector<string> fileNames = capsViewer::reportAggregator::findReports(directory);
+	if (fileNames.empty()) {
+		cerr << "No reports found in " << directory << "\n";
+		return -1;
+	}
+	aggregator.aggregateFiles(fileNames);
+
+	// Compressed formats are listed by name if the enum list is available
+	glCapsViewerCore core;
+	core.loadEnumList();
+	string text = aggregator.toText([&core](GLint glenum) { return core.getEnumName(glenum); });
+	if (outFile.empty()) {
+		cout << text;
+	}
+	else {
+		std::ofstream destfile(outFile);
+		destfile << text;
+	}
+	return 0;
+}
+
+/// <summary>
+/// glcapsviewer query <dir> <query> [--threads <n>] [--capslist <file>]
+/// Lists all reports of a directory matching a query like "GL_MAX_TEXTURE_SIZE >= 16384 and GL_ARB_bindless_texture"
+/// </summary>
+int queryReports(QStringList args)
+{
+	string directory;
+	string query;
+	string capsListFile = "capslist.xml";
+	int threadCount = 0;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--threads") && hasValue) {
+			threadCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else if (directory.empty()) {
+			directory = args[i].toStdString();
+		}
+		else if (query.empty()) {
+			query = args[i].toStdString();
+		}
+		else {
+			query = "";
+			break;
+		}
+	}
+	if (query.empty()) {
+		cerr << "Usage: glcapsviewer query <dir> <query> [--threads <n>] [--capslist <file>]\n";
+		return -1;
+	}
+
+	capsViewer::capsList caps;
+	if (!caps.loadFromFile(capsListFile)) {
+		cerr << "Could not load capability list " << capsListFile << "\n";
+		return -1;
+	}
+	capsViewer::reportColumnStore store;
+	store.createSchema(caps);
+	QElapsedTimer timer;
+	timer.start();
+	store.importFiles(capsViewer::reportAggregator::findReports(directory), threadCount);
+	qint64 importTime = timer.elapsed();
+
+	string error;
+	timer.restart();
+	vector<size_t> rows = store.query(query, error);
+	qint64 queryTime = timer.nsecsElapsed() / 1000;
+	if (!error.empty()) {
+		cerr << error << "\n";
+		return -1;
+	}
+	for (auto row : rows) {
+		cout << store.descriptions[row] << "\n";
+	}
+	cerr << rows.size() << " of " << store.rowCount << " reports match (import " << importTime << " ms, " << store.memoryUsage() / 1024 << " KB, query " << queryTime << " us)\n";
+	return 0;
+}
+
+/// <summary>
+/// glcapsviewer timeline <device> [--concurrency <n>] [--out <file>] [-database <url>]
+/// Changes of all caps, extensions and compressed formats across the report versions of a device (GL_RENDERER) in the database
+/// </summary>
+int deviceTimeline(QStringList args)
+{
+	string device;
+	string outFile;
+	int concurrency = 4;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--concurrency") && hasValue) {
+			concurrency = max(1, args[++i].toInt());
+		}
+		else if ((args[i] == "--out") && hasValue) {
+			outFile = args[++i].toStdString();
+		}
+		else if ((args[i] == "-database") && hasValue) {
+			// Applied by the settings
+			i++;
+		}
+		else if ((!args[i].startsWith("-")) && (device.empty())) {
+			device = args[i].toStdString();
+		}
+		else {
+			device = "";
+			break;
+		}
+	}
+	if (device.empty()) {
+		cerr << "Usage: glcapsviewer timeline <device> [--concurrency <n>] [--out <file>] [-database <url>]\n";
+		return -1;
+	}
+
+	capsViewer::settings appSettings;
+	appSettings.restore();
+	QElapsedTimer timer;
+	timer.start();
+	glCapsViewerHttp glchttp;
+	vector<reportInfo> reportList = glchttp.fetchDeviceReports(device);
+	if (reportList.empty()) {
+		cerr << "No reports found for " << device << "\n";
+		return -1;
+	}
+	vector<int> reportIds;
+	for (auto& report : reportList) {
+		reportIds.push_back(report.reportId);
+	}
+	capsViewer::reportCache cache;
+	capsViewer::reportFetcher fetcher(&cache);
+	fetcher.maxConcurrent = concurrency;
+	QEventLoop loop;
+	QObject::connect(&fetcher, SIGNAL(finished()), &loop, SLOT(quit()));
+	fetcher.fetch(reportIds);
+	loop.exec();
+
+	capsViewer::driverTimeline timeline;
+	for (auto& info : reportList) {
+		auto xml = fetcher.reports.find(info.reportId);
+		capsViewer::reportData report;
+		if ((xml != fetcher.reports.end()) && (report.fromXml(xml->second))) {
+			timeline.addReport(info.reportId, info.version, info.operatingSystem, report);
+		}
+	}
+	timeline.build();
+
+	glCapsViewerCore core;
+	core.loadEnumList();
+	string text = timeline.toText([&core](GLint glenum) { return core.getEnumName(glenum); });
+	if (outFile.empty()) {
+		cout << text;
+	}
+	else {
+		std::ofstream destfile(outFile);
+		destfile << text;
+	}
+	cerr << reportList.size() << " reports (" << fetcher.downloaded << " fetched, " << fetcher.cacheHits << " cached, " << fetcher.failedReports.size() << " failed) in " << timer.elapsed() << " ms\n";
+	return (fetcher.failedReports.empty()) ? 0 : -1;
+}
+
+/// <summary>
+/// glcapsviewer archive <dir> <file> [--threads <n>] [--capslist <file>] [--uncompressed]
+/// Stores all reports of a directory in a deduplicated archive and compares its size to the report files
+/// </summary>
+int archiveReports(QStringList args)
+{
+	string directory;
+	string archiveFile;
+	string capsListFile = "capslist.xml";
+	int threadCount = 0;
+	capsViewer::reportArchive archive;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--threads") && hasValue) {
+			threadCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else if (args[i] == "--uncompressed") {
+			archive.compressChunks = false;
+		}
+		else if (directory.empty()) {
+			directory = args[i].toStdString();
+		}
+		else if (archiveFile.empty()) {
+			archiveFile = args[i].toStdString();
+		}
+		else {
+			archiveFile = "";
+			break;
+		}
+	}
+	if (archiveFile.empty()) {
+		cerr << "Usage: glcapsviewer archive <dir> <file> [--threads <n>] [--capslist <file>] [--uncompressed]\n";
+		return -1;
+	}
+
+	// Caps are chunked per caps group if the capability list is available, otherwise all caps of a report are one chunk
+	capsViewer::capsList caps;
+	if (caps.loadFromFile(capsListFile)) {
+		archive.createSchema(caps);
+	}
+	QElapsedTimer timer;
+	timer.start();
+	archive.importFiles(capsViewer::reportAggregator::findReports(directory), threadCount);
+	if (archive.reports.empty()) {
+		cerr << "No reports found in " << directory << "\n";
+		return -1;
+	}
+	if (!archive.save(archiveFile, threadCount)) {
+		cerr << "Could not write " << archiveFile << "\n";
+		return -1;
+	}
+
+	cout << archive.reports.size() << " reports, " << archive.chunks.size() << " unique of " << archive.chunkReferences() << " chunks (" << archive.chunkBytes() / 1024 << " of " << archive.referencedBytes() / 1024 << " KB)\n";
+	cout << "xml files            " << archive.xmlBytes / 1024 << " KB\n";
+	cout << "zlib per file        " << archive.compressedXmlBytes / 1024 << " KB\n";
+	cout << "archive              " << archive.fileSize / 1024 << " KB\n";
+	cout << "ratio to xml         " << (double)archive.xmlBytes / archive.fileSize << "\n";
+	cout << "ratio to zlib        " << (double)archive.compressedXmlBytes / archive.fileSize << "\n";
+	cerr << "Archived in " << timer.elapsed() << " ms\n";
+	return 0;
+}
+
+/// <summary>
+/// glcapsviewer extract <file> <dir> [--filter <text>]
+/// Writes the reports of an archive (or those whose description contains the filter text) as xml files
+/// </summary>
+int extractReports(QStringList args)
+{
+	string archiveFile;
+	string directory;
+	string filter;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--filter") && hasValue) {
+			filter = args[++i].toStdString();
+		}
+		else if (archiveFile.empty()) {
+			archiveFile = args[i].toStdString();
+		}
+		else if (directory.empty()) {
+			directory = args[i].toStdString();
+		}
+		else {
+			directory = "";
+			break;
+		}
+	}
+	if (directory.empty()) {
+		cerr << "Usage: glcapsviewer extract <file> <dir> [--filter <text>]\n";
+		return -1;
+	}
+
+	capsViewer::mappedReportArchive archive;
+	if (!archive.open(archiveFile)) {
+		cerr << "Could not open archive " << archiveFile << "\n";
+		return -1;
+	}
+	QDir().mkpath(QString::fromStdString(directory));
+	vector<size_t> indices = archive.find(filter);
+	int failed = 0;
+	for (auto index : indices) {
+		capsViewer::reportData report;
+		if (!archive.readReport(index, report)) {
+			cerr << "Report " << index << " is corrupt\n";
+			failed++;
+			continue;
+		}
+		std::ofstream destfile(directory + "/report_" + to_string(index) + ".xml");
+		destfile << report.toXml();
+	}
+	cerr << indices.size() - failed << " of " << archive.reports.size << " reports extracted\n";
+	return (failed == 0) ? 0 : -1;
+}
+
+/// <summary>
+/// glcapsviewer probe [--samples <n>] [--out <file>] [--xml <file>]
+/// Runs the performance probes with a hidden window, e.g. in CI with Mesa llvmpipe (LIBGL_ALWAYS_SOFTWARE=1 xvfb-run glcapsviewer probe)
+/// </summary>
+int probePerformance(QStringList args)
+{
+	string outFile;
+	string xmlFile;
+	int sampleCount = 0;
+	for (int i = 2; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--samples") && hasValue) {
+			sampleCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--out") && hasValue) {
+			outFile = args[++i].toStdString();
+		}
+		else if ((args[i] == "--xml") && hasValue) {
+			xmlFile = args[++i].toStdString();
+		}
+		else {
+			cerr << "Usage: glcapsviewer probe [--samples <n>] [--out <file>] [--xml <file>]\n";
+			return -1;
+		}
+	}
+
+	if (!glfwInit()) {
+		cerr << "Could not initialize glfw\n";
+		return -1;
+	}
+	// Highest core profile available (compute probes need 4.3), the default context otherwise
+	const int versions[][2] = { { 4, 5 }, { 4, 3 }, { 3, 3 } };
+	GLFWwindow* window = NULL;
+	string contextType = "core";
+	for (auto& version : versions) {
+		glfwDefaultWindowHints();
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		window = glfwCreateWindow(320, 240, "glCapsViewer", NULL, NULL);
+		if (window) {
+			break;
+		}
+	}
+	if (!window) {
+		glfwDefaultWindowHints();
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+		window = glfwCreateWindow(320, 240, "glCapsViewer", NULL, NULL);
+		contextType = "default";
+	}
+	if (!window) {
+		cerr << "Could not create an OpenGL context\n";
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK) {
+		cerr << "Could not initialize GLEW\n";
+		glfwTerminate();
+		return -1;
+	}
+	// GLEW may leave an error behind with core profiles
+	glGetError();
+
+	glCapsViewerCore core;
+	core.contextType = contextType;
+	core.loadEnumList();
+	core.readExtensions();
+	core.readImplementation();
+	core.readCapabilities();
+	core.readCompressedFormats();
+	if (core.extensionSupported("GL_ARB_internalformat_query")) {
+		core.readInternalFormats();
+	}
+	core.performanceProbes.enabled = true;
+	if (sampleCount > 0) {
+		core.performanceProbes.sampleCount = sampleCount;
+	}
+	QElapsedTimer timer;
+	timer.start();
+	core.runPerformanceProbes();
+	qint64 probeTime = timer.elapsed();
+
+	if (outFile.empty()) {
+		cout << core.performanceProbes.reportToText();
+	}
+	else {
+		core.exportPerformanceReport(outFile);
+	}
+	if (!xmlFile.empty()) {
+		core.exportXml(xmlFile);
+	}
+	cerr << core.description << " (" << core.contextType << ") : " << core.performanceProbes.values.size() << " values, " << core.performanceProbes.messages.size() << " messages in " << probeTime << " ms\n";
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return (core.performanceProbes.values.empty()) ? -1 : 0;
+}
+
 int main(int argc, char *argv[])
 {
+	if ((argc > 1) && (string(argv[1]) == "aggregate")) {
+		QCoreApplication app(argc, argv);
+		return aggregateReports(app.arguments());
+	}
+	if ((argc > 1) && (string(argv[1]) == "query")) {
+		QCoreApplication app(argc, argv);
+		return queryReports(app.arguments());
+	}
+	if ((argc > 1) && (string(argv[1]) == "timeline")) {
+		QCoreApplication app(argc, argv);
+		return deviceTimeline(app.arguments());
+	}
+	if ((argc > 1) && (string(argv[1]) == "archive")) {
+		QCoreApplication app(argc, argv);
+		return archiveReports(app.arguments());
+	}
+	if ((argc > 1) && (string(argv[1]) == "extract")) {
+		QCoreApplication app(argc, argv);
+		return extractReports(app.arguments());
+	}
+	if ((argc > 1) && (string(argv[1]) == "probe")) {
+		QCoreApplication app(argc, argv);
+		return probePerformance(app.arguments());
+	}
+
 	QApplication a(argc, argv);
 	glCapsViewer capsViewer;
 	capsViewer.ui.labelReportPresent->setText("...");
+	// Record timing and errors of all OpenGL queries issued during report generation
+	if (a.arguments().contains("-profilequeries")) {
+		capsViewer.core.queryProfiler.enabled = true;
+	}
+	// Measure upload, readback and rendering performance after the report has been generated
+	if (a.arguments().contains("-probeperformance")) {
+		capsViewer.core.performanceProbes.enabled = true;
+	}
 	capsViewer.show();
 
 	// Check for capability list xml
@@ -142,5 +599,10 @@ int main(int argc, char *argv[])
 
 	capsViewer.generateReport();
 
+	// Queue the report for submission, e.g. for machines that capture without connection to the database
+	if (a.arguments().contains("-queueupload")) {
+		capsViewer.queueReport();
+	}
+
 	return a.exec();
 }
@@ -0,0 +1,361 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Memory mapped read only access to report archives
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "mappedReportArchive.h"
+#include <QByteArray>
+#include <QString>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	// Payload values are not aligned, so they are copied out of the mapping instead of being accessed in place
+
+	bool readMappedUint32(const stringView& data, size_t& position, uint32_t& value)
+	{
+		if (position + sizeof(value) > data.size) {
+			return false;
+		}
+		memcpy(&value, data.data + position, sizeof(value));
+		position += sizeof(value);
+		return true;
+	}
+
+	bool readMappedString(const stringView& data, size_t& position, stringView& value)
+	{
+		uint32_t size;
+		if ((!readMappedUint32(data, position, size)) || (position + size > data.size)) {
+			return false;
+		}
+		value = stringView(data.data + position, size);
+		position += size;
+		return true;
+	}
+
+	mappedReportArchive::~mappedReportArchive()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// Maps the whole archive file, the time needed does not depend on the size of the archive
+	/// </summary>
+	/// <returns>false if the file could not be mapped or is no report archive</returns>
+	bool mappedReportArchive::open(const string& fileName)
+	{
+		close();
+		file.setFileName(QString::fromStdString(fileName));
+		if ((!file.open(QIODevice::ReadOnly)) || ((uint64_t)file.size() < sizeof(archiveHeader))) {
+			close();
+			return false;
+		}
+		mappedSize = file.size();
+		mapping = file.map(0, mappedSize);
+		if (mapping == nullptr) {
+			close();
+			return false;
+		}
+
+		// Mappings are page aligned and all sections start at 8 byte boundaries, so records can be used in place
+		const archiveHeader* header = reinterpret_cast<const archiveHeader*>(mapping);
+		uint64_t sectionTableSize = (uint64_t)header->sectionCount * sizeof(archiveSection);
+		if ((memcmp(header->magic, "GLCA", 4) != 0) || (header->version != reportArchive::fileVersion) || (sizeof(archiveHeader) + sectionTableSize > mappedSize)) {
+			close();
+			return false;
+		}
+		const archiveSection* sections = reinterpret_cast<const archiveSection*>(mapping + sizeof(archiveHeader));
+		for (uint32_t i = 0; i < header->sectionCount; i++) {
+			const archiveSection& section = sections[i];
+			if ((section.offset > mappedSize) || (section.size > mappedSize - section.offset) || ((section.offset % 8) != 0)) {
+				close();
+				return false;
+			}
+			const uchar* data = mapping + section.offset;
+			switch (section.type) {
+			case sectionStrings:
+				strings = stringView(reinterpret_cast<const char*>(data), section.size);
+				break;
+			case sectionChunks:
+				chunks = arraySpan<archiveChunkRecord>(reinterpret_cast<const archiveChunkRecord*>(data), section.size / sizeof(archiveChunkRecord));
+				break;
+			case sectionChunkData:
+				chunkData = stringView(reinterpret_cast<const char*>(data), section.size);
+				break;
+			case sectionReports:
+				reports = arraySpan<archiveReportRecord>(reinterpret_cast<const archiveReportRecord*>(data), section.size / sizeof(archiveReportRecord));
+				break;
+			case sectionChunkRefs:
+				chunkRefs = arraySpan<uint32_t>(reinterpret_cast<const uint32_t*>(data), section.size / sizeof(uint32_t));
+				break;
+			}
+		}
+		return true;
+	}
+
+	void mappedReportArchive::close()
+	{
+		if (mapping != nullptr) {
+			file.unmap(const_cast<uchar*>(mapping));
+		}
+		file.close();
+		mapping = nullptr;
+		mappedSize = 0;
+		strings = stringView();
+		chunkData = stringView();
+		chunks = arraySpan<archiveChunkRecord>();
+		reports = arraySpan<archiveReportRecord>();
+		chunkRefs = arraySpan<uint32_t>();
+		lock_guard<mutex> guard(cacheLock);
+		uncompressedChunks.clear();
+		uncompressedBytes = 0;
+	}
+
+	bool mappedReportArchive::isOpen() const
+	{
+		return mapping != nullptr;
+	}
+
+	/// <returns>Empty view if the report index or the string reference is out of range</returns>
+	stringView mappedReportArchive::field(size_t report, archiveReportField field) const
+	{
+		if (report >= reports.size) {
+			return stringView();
+		}
+		const archiveStringRef& ref = reports[report].fields[field];
+		if ((uint64_t)ref.offset + ref.size > strings.size) {
+			return stringView();
+		}
+		return stringView(strings.data + ref.offset, ref.size);
+	}
+
+	/// <summary>
+	/// Chunk indices of a report in report order, references to chunks that don't exist are not returned
+	/// </summary>
+	arraySpan<uint32_t> mappedReportArchive::reportChunks(size_t report) const
+	{
+		if (report >= reports.size) {
+			return arraySpan<uint32_t>();
+		}
+		const archiveReportRecord& record = reports[report];
+		if ((uint64_t)record.firstChunk + record.chunkCount > chunkRefs.size) {
+			return arraySpan<uint32_t>();
+		}
+		size_t count = 0;
+		while ((count < record.chunkCount) && (chunkRefs[record.firstChunk + count] < chunks.size)) {
+			count++;
+		}
+		return arraySpan<uint32_t>(chunkRefs.data + record.firstChunk, count);
+	}
+
+	/// <summary>
+	/// Uncompressed payload of a chunk, valid until the archive is closed
+	/// </summary>
+	/// <returns>Empty view with a null pointer if the chunk is out of range or can't be uncompressed</returns>
+	stringView mappedReportArchive::payload(uint32_t chunk) const
+	{
+		if (chunk >= chunks.size) {
+			return stringView();
+		}
+		const archiveChunkRecord& record = chunks[chunk];
+		if ((record.offset > chunkData.size) || (record.storedSize > chunkData.size - record.offset)) {
+			return stringView();
+		}
+		stringView stored(chunkData.data + record.offset, record.storedSize);
+		if (record.compressed == 0) {
+			return stored;
+		}
+		lock_guard<mutex> guard(cacheLock);
+		auto cached = uncompressedChunks.find(chunk);
+		if (cached == uncompressedChunks.end()) {
+			QByteArray uncompressed = qUncompress(QByteArray::fromRawData(stored.data, (int)stored.size));
+			if ((size_t)uncompressed.size() != record.size) {
+				return stringView();
+			}
+			cached = uncompressedChunks.emplace(chunk, string(uncompressed.constData(), uncompressed.size())).first;
+			uncompressedBytes += record.size;
+		}
+		return stringView(cached->second.data(), cached->second.size());
+	}
+
+	/// <summary>
+	/// Lists the entries of a caps, extension or internal format chunk
+	/// </summary>
+	/// <returns>false for compressed format chunks and chunks that are corrupt</returns>
+	bool mappedReportArchive::entries(uint32_t chunk, vector<mappedEntry>& entries) const
+	{
+		stringView data = payload(chunk);
+		if ((data.data == nullptr) || (chunks[chunk].type == chunkCompressedFormats)) {
+			return false;
+		}
+		bool hasValues = (chunks[chunk].type != chunkExtensions);
+		size_t position = 0;
+		uint32_t count;
+		if (!readMappedUint32(data, position, count)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			mappedEntry entry;
+			if ((!readMappedString(data, position, entry.key)) || ((hasValues) && (!readMappedString(data, position, entry.value)))) {
+				return false;
+			}
+			entries.push_back(entry);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Returns the value of a cap, empty if the cap is not present or has no value
+	/// </summary>
+	stringView mappedReportArchive::getCap(size_t report, const string& name) const
+	{
+		vector<mappedEntry> capEntries;
+		for (auto& chunk : reportChunks(report)) {
+			if (chunks[chunk].type != chunkCaps) {
+				continue;
+			}
+			capEntries.clear();
+			entries(chunk, capEntries);
+			for (auto& entry : capEntries) {
+				if (entry.key == name) {
+					return entry.value;
+				}
+			}
+		}
+		return stringView();
+	}
+
+	bool mappedReportArchive::hasExtension(size_t report, const string& name) const
+	{
+		vector<mappedEntry> extensionEntries;
+		for (auto& chunk : reportChunks(report)) {
+			if (chunks[chunk].type != chunkExtensions) {
+				continue;
+			}
+			extensionEntries.clear();
+			entries(chunk, extensionEntries);
+			for (auto& entry : extensionEntries) {
+				if (entry.key == name) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	vector<GLint> mappedReportArchive::compressedFormats(size_t report) const
+	{
+		vector<GLint> formats;
+		for (auto& chunk : reportChunks(report)) {
+			if (chunks[chunk].type != chunkCompressedFormats) {
+				continue;
+			}
+			stringView data = payload(chunk);
+			size_t position = 0;
+			uint32_t count;
+			uint32_t format;
+			if (!readMappedUint32(data, position, count)) {
+				continue;
+			}
+			for (uint32_t i = 0; (i < count) && (readMappedUint32(data, position, format)); i++) {
+				formats.push_back((GLint)format);
+			}
+		}
+		return formats;
+	}
+
+	/// <summary>
+	/// Copies a report out of the archive, e.g. for comparing or exporting it
+	/// </summary>
+	bool mappedReportArchive::readReport(size_t report, reportData& data) const
+	{
+		data.clear();
+		if (report >= reports.size) {
+			return false;
+		}
+		data.description = field(report, fieldDescription).toString();
+		data.operatingSystem = field(report, fieldOperatingSystem).toString();
+		data.contextType = field(report, fieldContextType).toString();
+		data.date = field(report, fieldDate).toString();
+		data.submitter = field(report, fieldSubmitter).toString();
+		data.comment = field(report, fieldComment).toString();
+		data.hasInternalFormats = (reports[report].hasInternalFormats != 0);
+		vector<mappedEntry> chunkEntries;
+		for (auto& chunk : reportChunks(report)) {
+			if (chunks[chunk].type == chunkCompressedFormats) {
+				continue;
+			}
+			chunkEntries.clear();
+			if (!entries(chunk, chunkEntries)) {
+				return false;
+			}
+			for (auto& entry : chunkEntries) {
+				switch (chunks[chunk].type) {
+				case chunkCaps:
+					data.caps.push_back(make_pair(entry.key.toString(), entry.value.toString()));
+					break;
+				case chunkExtensions:
+					data.extensions.push_back(entry.key.toString());
+					break;
+				case chunkInternalFormats:
+					data.internalFormats.push_back(make_pair(entry.key.toString(), entry.value.toString()));
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		data.compressedFormats = compressedFormats(report);
+		data.indexCaps();
+		return true;
+	}
+
+	/// <summary>
+	/// Returns the indices of all reports whose description contains the text (case insensitive), only the string section is touched
+	/// </summary>
+	vector<size_t> mappedReportArchive::find(const string& text) const
+	{
+		vector<size_t> indices;
+		QString searchText = QString::fromStdString(text);
+		for (size_t i = 0; i < reports.size; i++) {
+			stringView description = field(i, fieldDescription);
+			if (QString::fromUtf8(description.data, (int)description.size).contains(searchText, Qt::CaseInsensitive)) {
+				indices.push_back(i);
+			}
+		}
+		return indices;
+	}
+
+	uint64_t mappedReportArchive::fileSize() const
+	{
+		return mappedSize;
+	}
+
+	/// <summary>
+	/// Memory used by uncompressed copies of compressed chunks, the mapping itself is only resident where it has been accessed
+	/// </summary>
+	uint64_t mappedReportArchive::cachedBytes() const
+	{
+		lock_guard<mutex> guard(cacheLock);
+		return uncompressedBytes;
+	}
+
+}
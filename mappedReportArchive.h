@@ -0,0 +1,118 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Memory mapped read only access to report archives
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <QFile>
+#include <GL/glew.h>
+#include "reportArchive.h"
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Non owning reference to characters of the mapped archive
+	/// </summary>
+	class stringView
+	{
+	public:
+		const char* data = nullptr;
+		size_t size = 0;
+		stringView() {}
+		stringView(const char* data, size_t size) : data(data), size(size) {}
+		bool empty() const { return size == 0; }
+		string toString() const { return string(data, size); }
+		bool operator==(const string& other) const { return (size == other.size()) && ((size == 0) || (memcmp(data, other.data(), size) == 0)); }
+		bool operator!=(const string& other) const { return !(*this == other); }
+	};
+
+	/// <summary>
+	/// Non owning reference to consecutive records of the mapped archive
+	/// </summary>
+	template<typename T> class arraySpan
+	{
+	public:
+		const T* data = nullptr;
+		size_t size = 0;
+		arraySpan() {}
+		arraySpan(const T* data, size_t size) : data(data), size(size) {}
+		const T* begin() const { return data; }
+		const T* end() const { return data + size; }
+		const T& operator[](size_t index) const { return data[index]; }
+	};
+
+	/// <summary>
+	/// Key and value of a caps or internal format chunk entry (the value is empty for extensions)
+	/// </summary>
+	class mappedEntry
+	{
+	public:
+		stringView key;
+		stringView value;
+	};
+
+	/// <summary>
+	/// Maps an archive written by reportArchive and reads it in place
+	/// Opening only checks the header and the section table, record tables are used directly from the mapping
+	/// Chunks of archives written without compression are returned without copying, compressed chunks are uncompressed once on first access
+	/// </summary>
+	class mappedReportArchive
+	{
+	private:
+		QFile file;
+		const uchar* mapping = nullptr;
+		uint64_t mappedSize = 0;
+		stringView strings;
+		stringView chunkData;
+		mutable mutex cacheLock;
+		mutable unordered_map<uint32_t, string> uncompressedChunks;
+		mutable uint64_t uncompressedBytes = 0;
+	public:
+		arraySpan<archiveChunkRecord> chunks;
+		arraySpan<archiveReportRecord> reports;
+		arraySpan<uint32_t> chunkRefs;
+		~mappedReportArchive();
+		bool open(const string& fileName);
+		void close();
+		bool isOpen() const;
+		stringView field(size_t report, archiveReportField field) const;
+		arraySpan<uint32_t> reportChunks(size_t report) const;
+		stringView payload(uint32_t chunk) const;
+		bool entries(uint32_t chunk, vector<mappedEntry>& entries) const;
+		stringView getCap(size_t report, const string& name) const;
+		bool hasExtension(size_t report, const string& name) const;
+		vector<GLint> compressedFormats(size_t report) const;
+		bool readReport(size_t report, reportData& data) const;
+		vector<size_t> find(const string& text) const;
+		uint64_t fileSize() const;
+		uint64_t cachedBytes() const;
+	};
+
+}
@@ -0,0 +1,186 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Mipmap generation cost probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "mipmapGenerationProbe.h"
+#include "fillRateProbe.h"
+#include "glCapsViewerCore.h"
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string mipmapGenerationProbe::name() const
+	{
+		return "mipmapgeneration";
+	}
+
+	bool mipmapGenerationProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Renders every level from the previous one, the sampled level is isolated with the base and max level so it doesn't overlap the rendered level
+	/// </summary>
+	/// <returns>Median time to render all levels in microseconds</returns>
+	double mipmapGenerationProbe::measureReference(glPerformanceProbes& probes, GLuint texture, GLuint program, int size)
+	{
+		int levels = 0;
+		for (int levelSize = size; levelSize > 1; levelSize /= 2) {
+			levels++;
+		}
+		glUseProgram(program);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		GLint baseLevel;
+		GLint maxLevel;
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, &baseLevel);
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+		double time = probes.medianTime([&]() {
+			for (int level = 1; level <= levels; level++) {
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level - 1);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level - 1);
+				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, level);
+				glViewport(0, 0, max(size >> level, 1), max(size >> level, 1));
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+		});
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+		return time;
+	}
+
+	void mipmapGenerationProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// 2x2 box filter of the only accessible level (the base level)
+		string fragmentSource =
+			"#version 330\n"
+			"uniform sampler2D source;\n"
+			"out vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	ivec2 coord = ivec2(gl_FragCoord.xy) * 2;\n"
+			"	color = (texelFetch(source, coord, 0) + texelFetch(source, coord + ivec2(1, 0), 0) + texelFetch(source, coord + ivec2(0, 1), 0) + texelFetch(source, coord + ivec2(1, 1), 0)) * 0.25;\n"
+			"}\n";
+		string log;
+		GLuint program = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource, log);
+		if (program == 0) {
+			probes.addMessage(name(), "skipped, reference program failed: " + log);
+			return;
+		}
+
+		GLint viewport[4];
+		GLint unpackAlignment;
+		GLint maxTextureSize;
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// Level 0 is uploaded from client memory, the caller's bindings are restored by glPerformanceProbes
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		GLuint framebuffer;
+		GLuint vertexArray;
+		glGenFramebuffers(1, &framebuffer);
+		glGenVertexArrays(1, &vertexArray);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glBindVertexArray(vertexArray);
+
+		int maxSize = 0;
+		for (auto& size : sizes) {
+			if (size <= maxTextureSize) {
+				maxSize = max(maxSize, size);
+			}
+		}
+		// Level 0 content for all formats and sizes, converted by the driver
+		vector<unsigned char> data(maxSize * maxSize * 4);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = (unsigned char)(i * 7 + i / 251);
+		}
+
+		for (auto& format : fillRateProbe::colorFormats()) {
+			string formatName = core.getEnumName(format);
+			// Generation is tried if support can't be queried
+			if (glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format, GL_MANUAL_GENERATE_MIPMAP, GL_FULL_SUPPORT) == GL_NONE) {
+				probes.addMessage(name(), formatName + " skipped, GL_MANUAL_GENERATE_MIPMAP not supported");
+				continue;
+			}
+			for (auto& size : sizes) {
+				string caseName = formatName + " " + to_string(size);
+				if (size > maxTextureSize) {
+					probes.addMessage(name(), caseName + " skipped, exceeds GL_MAX_TEXTURE_SIZE");
+					continue;
+				}
+				GLuint texture;
+				glGenTextures(1, &texture);
+				glBindTexture(GL_TEXTURE_2D, texture);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				glPerformanceProbes::clearErrors();
+				glTexImage2D(GL_TEXTURE_2D, 0, format, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+				// The first generation allocates the levels the reference renders into and is the warm up of the measurement
+				double generateTime = probes.medianTime([&]() {
+					glGenerateMipmap(GL_TEXTURE_2D);
+				});
+				GLenum error = glGetError();
+				if (error != GL_NO_ERROR) {
+					probes.addMessage(name(), caseName + " skipped, " + ((error == GL_OUT_OF_MEMORY) ? "out of memory" : "glGenerateMipmap failed"));
+					glDeleteTextures(1, &texture);
+					continue;
+				}
+				probes.addValue(name(), caseName, "generate_us", generateTime);
+
+				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 1);
+				bool renderable = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+				if (!renderable) {
+					probes.addMessage(name(), caseName + " reference skipped, not renderable");
+				}
+				else {
+					glPerformanceProbes::clearErrors();
+					double referenceTime = measureReference(probes, texture, program, size);
+					if ((glGetError() != GL_NO_ERROR) || (referenceTime <= 0.0)) {
+						probes.addMessage(name(), caseName + " reference skipped, draw failed");
+					}
+					else {
+						double ratio = generateTime / referenceTime;
+						probes.addValue(name(), caseName, "reference_us", referenceTime);
+						probes.addValue(name(), caseName, "generate_ratio", ratio);
+						probes.addValue(name(), caseName, "software_path", (ratio >= softwareThreshold) ? 1.0 : 0.0);
+					}
+				}
+				glDeleteTextures(1, &texture);
+			}
+		}
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteProgram(program);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	}
+
+}
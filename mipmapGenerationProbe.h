@@ -0,0 +1,52 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Mipmap generation cost probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures glGenerateMipmap for color formats at several sizes against a reference that renders each level with a 2x2 box filter shader,
+	/// formats for which glGenerateMipmap is much slower than the reference probably use a CPU fallback
+	/// </summary>
+	class mipmapGenerationProbe : public glPerformanceProbe
+	{
+	private:
+		double measureReference(glPerformanceProbes& probes, GLuint texture, GLuint program, int size);
+	public:
+		// Sizes of level 0, sizes above GL_MAX_TEXTURE_SIZE are skipped
+		vector<int> sizes = { 256, 512, 1024, 2048, 4096 };
+		// glGenerateMipmap is flagged as a probable software path if it takes at least this many times as long as the reference
+		double softwareThreshold = 4.0;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+	};
+
+}
@@ -0,0 +1,316 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Framebuffer readback latency probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "readbackProbe.h"
+#include "textureUploadProbe.h"
+#include "glCapsViewerCore.h"
+#include <algorithm>
+#include <cstring>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string readbackProbe::name() const
+	{
+		return "readback";
+	}
+
+	bool readbackProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if ((!GLEW_VERSION_3_0) && (!GLEW_ARB_framebuffer_object)) {
+			reason = "requires OpenGL 3.0 or GL_ARB_framebuffer_object";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Format and type the preferred combination is compared against
+	/// </summary>
+	pair<GLenum, GLenum> readbackProbe::referenceFormat(GLenum internalFormat)
+	{
+		switch (internalFormat) {
+		case GL_RED:
+		case GL_RG:
+		case GL_RGB:
+		case GL_RGBA:
+			return make_pair((GLenum)GL_RGBA, (GLenum)GL_UNSIGNED_BYTE);
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT32F:
+			return make_pair((GLenum)GL_DEPTH_COMPONENT, (GLenum)GL_FLOAT);
+		case GL_DEPTH_STENCIL:
+			return make_pair((GLenum)GL_DEPTH_STENCIL, (GLenum)GL_UNSIGNED_INT_24_8);
+		case GL_STENCIL_INDEX:
+			return make_pair((GLenum)GL_STENCIL_INDEX, (GLenum)GL_UNSIGNED_BYTE);
+		}
+		return make_pair((GLenum)0, (GLenum)0);
+	}
+
+	/// <summary>
+	/// Reads the whole framebuffer back with one combination of format and type
+	/// Synchronous readbacks are timed until glReadPixels returns, asynchronous readbacks until the mapped pack buffer has been copied to client memory
+	/// The framebuffer is cleared before every readback, so the driver can't return a cached copy
+	/// </summary>
+	/// <param name="bandwidth">Receives the best median bandwidth of both paths in MB/s (10^6 bytes), 0 if the readback failed</param>
+	void readbackProbe::measureReadback(glPerformanceProbes& probes, const string& caseName, GLenum attachment, GLenum format, GLenum type, GLuint buffer, double& bandwidth)
+	{
+		bandwidth = 0.0;
+		size_t dataSize = glPerformanceProbes::pixelSize(format, type) * framebufferSize * framebufferSize;
+		if (dataSize == 0) {
+			probes.addMessage(name(), caseName + " skipped, unknown pixel size");
+			return;
+		}
+		vector<unsigned char> data(dataSize);
+		int sample = 0;
+		auto clearFramebuffer = [&]() {
+			float value = (float)(sample++ % 16) / 16.0f;
+			switch (attachment) {
+			case GL_COLOR_ATTACHMENT0:
+				glClearColor(value, 1.0f - value, value * 0.5f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				break;
+			case GL_DEPTH_ATTACHMENT:
+				glClearDepth(value);
+				glClear(GL_DEPTH_BUFFER_BIT);
+				break;
+			case GL_STENCIL_ATTACHMENT:
+				glClearStencil(sample);
+				glClear(GL_STENCIL_BUFFER_BIT);
+				break;
+			default:
+				glClearDepth(value);
+				glClearStencil(sample);
+				glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+				break;
+			}
+		};
+		auto readSync = [&]() {
+			glReadPixels(0, 0, framebufferSize, framebufferSize, format, type, data.data());
+		};
+
+		// Warm up, the first readback may include format conversion setup
+		glPerformanceProbes::clearErrors();
+		clearFramebuffer();
+		glPerformanceProbes::timeFinished(readSync);
+		if (glGetError() != GL_NO_ERROR) {
+			probes.addMessage(name(), caseName + " skipped, readback failed");
+			return;
+		}
+		int sampleCount = max(probes.sampleCount, minimumSamples);
+		probeSamples syncSamples;
+		for (int i = 0; i < sampleCount; i++) {
+			clearFramebuffer();
+			syncSamples.add(glPerformanceProbes::timeFinished(readSync));
+		}
+		double syncTime = syncSamples.median();
+		probes.addValue(name(), caseName, "sync_p50_us", syncTime);
+		probes.addValue(name(), caseName, "sync_p99_us", syncSamples.percentile(99.0));
+		probes.addValue(name(), caseName, "sync_mbps", (syncTime > 0.0) ? (double)dataSize / syncTime : 0.0);
+		bandwidth = (syncTime > 0.0) ? (double)dataSize / syncTime : 0.0;
+
+		if ((!GLEW_VERSION_3_2) && (!GLEW_ARB_sync)) {
+			return;
+		}
+
+		// Asynchronous readback, the time until glReadPixels returns is the stall the application sees
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, dataSize, nullptr, GL_STREAM_READ);
+		probeSamples issueSamples;
+		probeSamples asyncSamples;
+		bool failed = false;
+		for (int i = 0; (i <= sampleCount) && (!failed); i++) {
+			clearFramebuffer();
+			glFinish();
+			glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+			glReadPixels(0, 0, framebufferSize, framebufferSize, format, type, nullptr);
+			GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			glPerformanceProbes::clock::time_point issued = glPerformanceProbes::clock::now();
+			GLenum waitResult;
+			do {
+				waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (waitResult == GL_TIMEOUT_EXPIRED);
+			glDeleteSync(fence);
+			void* mapped = (waitResult != GL_WAIT_FAILED) ? glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, dataSize, GL_MAP_READ_BIT) : nullptr;
+			if (mapped == nullptr) {
+				failed = true;
+				break;
+			}
+			memcpy(data.data(), mapped, dataSize);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			glPerformanceProbes::clock::time_point finished = glPerformanceProbes::clock::now();
+			// First readback is the warm up
+			if (i > 0) {
+				issueSamples.add(chrono::duration<double, micro>(issued - start).count());
+				asyncSamples.add(chrono::duration<double, micro>(finished - start).count());
+			}
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if ((failed) || (glGetError() != GL_NO_ERROR)) {
+			probes.addMessage(name(), caseName + " asynchronous readback failed");
+			return;
+		}
+		double asyncTime = asyncSamples.median();
+		double asyncBandwidth = (asyncTime > 0.0) ? (double)dataSize / asyncTime : 0.0;
+		probes.addValue(name(), caseName, "async_issue_us", issueSamples.median());
+		probes.addValue(name(), caseName, "async_p50_us", asyncTime);
+		probes.addValue(name(), caseName, "async_p99_us", asyncSamples.percentile(99.0));
+		probes.addValue(name(), caseName, "async_mbps", asyncBandwidth);
+		bandwidth = max(bandwidth, asyncBandwidth);
+	}
+
+	void readbackProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		if ((!GLEW_VERSION_3_2) && (!GLEW_ARB_sync)) {
+			probes.addMessage(name(), "asynchronous readback skipped, requires OpenGL 3.2 or GL_ARB_sync");
+		}
+
+		// Base formats from the internal format sweep with their preferred readback format and type, if the driver reports them
+		vector<GLenum> internalFormats;
+		vector<pair<GLenum, GLenum>> preferredFormats;
+		const internalFormatTarget* target = core.getInternalFormatTarget(GL_TEXTURE_2D);
+		if (target != nullptr) {
+			for (auto& textureFormat : target->textureFormats) {
+				GLint readPixels = GL_FULL_SUPPORT;
+				textureFormat.getValue(GL_READ_PIXELS, readPixels);
+				if ((!textureFormat.supported) || (readPixels == GL_NONE) || (referenceFormat(textureFormat.textureFormat).first == 0)) {
+					continue;
+				}
+				GLint readFormat = 0;
+				GLint readType = 0;
+				textureFormat.getValue(GL_READ_PIXELS_FORMAT, readFormat);
+				textureFormat.getValue(GL_READ_PIXELS_TYPE, readType);
+				internalFormats.push_back(textureFormat.textureFormat);
+				preferredFormats.push_back(make_pair((GLenum)readFormat, (GLenum)readType));
+			}
+		}
+		else {
+			GLenum baseFormats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA, GL_DEPTH_COMPONENT, GL_DEPTH_STENCIL };
+			for (auto& baseFormat : baseFormats) {
+				internalFormats.push_back(baseFormat);
+				preferredFormats.push_back(make_pair(0, 0));
+			}
+		}
+
+		GLint packAlignment;
+		GLfloat clearColor[4];
+		GLfloat clearDepth;
+		GLint clearStencil;
+		glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+		glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+		glGetFloatv(GL_DEPTH_CLEAR_VALUE, &clearDepth);
+		glGetIntegerv(GL_STENCIL_CLEAR_VALUE, &clearStencil);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		// Synchronous readbacks write to client memory only without a bound pack buffer, the caller's binding is restored by glPerformanceProbes
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		GLuint framebuffer;
+		GLuint buffer;
+		glGenFramebuffers(1, &framebuffer);
+		glGenBuffers(1, &buffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+		for (size_t f = 0; f < internalFormats.size(); f++) {
+			GLenum internalFormat = internalFormats[f];
+			string formatName = core.getEnumName(internalFormat);
+			GLenum attachment = GL_COLOR_ATTACHMENT0;
+			switch (internalFormat) {
+			case GL_DEPTH_COMPONENT:
+			case GL_DEPTH_COMPONENT32F:
+				attachment = GL_DEPTH_ATTACHMENT;
+				break;
+			case GL_DEPTH_STENCIL:
+				attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+				break;
+			case GL_STENCIL_INDEX:
+				attachment = GL_STENCIL_ATTACHMENT;
+				break;
+			}
+
+			// Renderable formats are the ones that give a complete framebuffer
+			vector<pair<GLenum, GLenum>> allocationFormats = textureUploadProbe::uploadFormats(internalFormat);
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glPerformanceProbes::clearErrors();
+			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, framebufferSize, framebufferSize, 0, allocationFormats[0].first, allocationFormats[0].second, nullptr);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+			GLenum colorBuffer = (attachment == GL_COLOR_ATTACHMENT0) ? GL_COLOR_ATTACHMENT0 : GL_NONE;
+			glDrawBuffer(colorBuffer);
+			glReadBuffer(colorBuffer);
+			if ((glGetError() != GL_NO_ERROR) || (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)) {
+				probes.addMessage(name(), formatName + " skipped, not renderable");
+			}
+			else {
+				// The preferred combination can also be queried from the framebuffer if the sweep didn't report it
+				pair<GLenum, GLenum> preferred = preferredFormats[f];
+				if (((preferred.first == 0) || (preferred.second == 0)) && (attachment == GL_COLOR_ATTACHMENT0)) {
+					GLint readFormat = 0;
+					GLint readType = 0;
+					glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_FORMAT, &readFormat);
+					glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_TYPE, &readType);
+					preferred = make_pair((GLenum)readFormat, (GLenum)readType);
+				}
+				vector<pair<GLenum, GLenum>> formats;
+				formats.push_back(referenceFormat(internalFormat));
+				if ((preferred.first != 0) && (preferred.second != 0) && (preferred != formats[0])) {
+					formats.insert(formats.begin(), preferred);
+				}
+
+				double bestPreferred = 0.0;
+				double bestOther = 0.0;
+				for (auto& format : formats) {
+					string caseName = formatName + " " + core.getEnumName(format.first) + " " + core.getEnumName(format.second);
+					double bandwidth;
+					measureReadback(probes, caseName, attachment, format.first, format.second, buffer, bandwidth);
+					if (bandwidth == 0.0) {
+						continue;
+					}
+					bool isPreferred = (format == preferred);
+					probes.addValue(name(), caseName, "preferred", isPreferred ? 1.0 : 0.0);
+					if (isPreferred) {
+						bestPreferred = max(bestPreferred, bandwidth);
+					}
+					else {
+						bestOther = max(bestOther, bandwidth);
+					}
+				}
+				// Below 1 if reading back as RGBA/UNSIGNED_BYTE is faster than with the preferred combination
+				if ((bestPreferred > 0.0) && (bestOther > 0.0)) {
+					probes.addValue(name(), formatName, "preferred_ratio", bestPreferred / bestOther);
+				}
+			}
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, 0, 0);
+			glDeleteTextures(1, &texture);
+		}
+
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteBuffers(1, &buffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+		glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+		glClearDepth(clearDepth);
+		glClearStencil(clearStencil);
+	}
+
+}
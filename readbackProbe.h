@@ -0,0 +1,54 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Framebuffer readback latency probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures glReadPixels latency and bandwidth for every renderable base format on GL_TEXTURE_2D
+	/// Each format is read back with the format and type preferred by the driver (GL_READ_PIXELS_FORMAT/TYPE) and with RGBA/UNSIGNED_BYTE (or the base depth/stencil format),
+	/// synchronously into client memory and asynchronously into a pixel pack buffer that is mapped after its fence has been signaled
+	/// </summary>
+	class readbackProbe : public glPerformanceProbe
+	{
+	private:
+		void measureReadback(glPerformanceProbes& probes, const string& caseName, GLenum attachment, GLenum format, GLenum type, GLuint buffer, double& bandwidth);
+	public:
+		// Width and height of the framebuffer read back
+		int framebufferSize = 512;
+		// Minimum number of timed readbacks per case, percentiles above the median need more samples than the median
+		int minimumSamples = 20;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static pair<GLenum, GLenum> referenceFormat(GLenum internalFormat);
+	};
+
+}
@@ -0,0 +1,342 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Aggregated statistics over a set of report files
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportAggregator.h"
+#include "reportDiff.h"
+#include "workStealingPool.h"
+#include <QDir>
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <iomanip>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	int nameTable::intern(const string& name)
+	{
+		lock_guard<mutex> guard(lock);
+		auto id = ids.find(name);
+		if (id != ids.end()) {
+			return id->second;
+		}
+		int newId = (int)names.size();
+		ids.emplace(name, newId);
+		names.push_back(name);
+		return newId;
+	}
+
+	/// <summary>
+	/// Only valid while no names are interned concurrently
+	/// </summary>
+	const string& nameTable::name(int id) const
+	{
+		return names[id];
+	}
+
+	int nameTable::size() const
+	{
+		return (int)names.size();
+	}
+
+	void nameTable::clear()
+	{
+		lock_guard<mutex> guard(lock);
+		ids.clear();
+		names.clear();
+	}
+
+	/// <summary>
+	/// Per worker accumulation, merged after all reports have been parsed
+	/// Names are looked up in a local cache first, so the shared name tables are only locked for names a worker sees for the first time
+	/// </summary>
+	class aggregatorWorker
+	{
+	public:
+		unordered_map<string, int> capIds;
+		unordered_map<string, int> extensionIds;
+		vector<int> capReports;
+		vector<vector<double>> capValues;
+		vector<int> extensionReports;
+		unordered_map<GLint, int> formatReports;
+		int reports = 0;
+		int failed = 0;
+		int localId(unordered_map<string, int>& cache, nameTable& table, const string& name)
+		{
+			auto id = cache.find(name);
+			if (id != cache.end()) {
+				return id->second;
+			}
+			int newId = table.intern(name);
+			cache.emplace(name, newId);
+			return newId;
+		}
+	};
+
+	/// <summary>
+	/// Cap values are numeric if the whole value is a (signed) number, e.g. "16384" but not "1024 ,768" or a vendor string
+	/// </summary>
+	bool parseNumber(const string& value, double& number)
+	{
+		if ((value.empty()) || ((!isdigit((unsigned char)value[0])) && (value[0] != '-'))) {
+			return false;
+		}
+		char* end;
+		number = strtod(value.c_str(), &end);
+		return (*end == 0) && (std::isfinite(number));
+	}
+
+	/// <summary>
+	/// Nearest rank percentile of a sorted list
+	/// </summary>
+	double percentile(const vector<double>& sortedValues, double p)
+	{
+		size_t rank = (size_t)ceil(p / 100.0 * sortedValues.size());
+		return sortedValues[(rank > 0) ? min(rank - 1, sortedValues.size() - 1) : 0];
+	}
+
+	string formatNumber(double value)
+	{
+		stringstream ss;
+		if ((value == floor(value)) && (fabs(value) < 1e15)) {
+			ss << (long long)value;
+		}
+		else {
+			ss << setprecision(6) << value;
+		}
+		return ss.str();
+	}
+
+	/// <summary>
+	/// Lists all xml files of a directory (e.g. written by glcapsviewer_reportgen or exported from the viewer)
+	/// </summary>
+	vector<string> reportAggregator::findReports(const string& directory)
+	{
+		vector<string> fileNames;
+		QDir dir(QString::fromStdString(directory));
+		QStringList entries = dir.entryList(QStringList() << "*.xml", QDir::Files, QDir::Name);
+		for (auto& entry : entries) {
+			fileNames.push_back(dir.filePath(entry).toStdString());
+		}
+		return fileNames;
+	}
+
+	void reportAggregator::aggregateFiles(const vector<string>& fileNames)
+	{
+		aggregate(fileNames.size(), [&fileNames](size_t index, string& xml) {
+			ifstream file(fileNames[index], ios::binary);
+			if (!file.is_open()) {
+				return false;
+			}
+			xml.assign((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+			return true;
+		});
+	}
+
+	void reportAggregator::aggregateXml(const vector<string>& reports)
+	{
+		aggregate(reports.size(), [&reports](size_t index, string& xml) {
+			xml = reports[index];
+			return true;
+		});
+	}
+
+	/// <summary>
+	/// Parses all reports on a work stealing pool (one task per report) and merges the per worker results
+	/// </summary>
+	/// <param name="count">Number of reports</param>
+	/// <param name="load">Reads the xml of a report, called from the worker threads</param>
+	void reportAggregator::aggregate(size_t count, function<bool(size_t, string&)> load)
+	{
+		chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+
+		// Names of a previous run would show up with zero reports
+		capNames.clear();
+		extensionNames.clear();
+
+		vector<aggregatorWorker> workers;
+		{
+			workStealingPool pool(threadCount);
+			threadsUsed = pool.threadCount();
+			workers.resize(threadsUsed);
+			for (size_t i = 0; i < count; i++) {
+				pool.submit([this, i, &load, &workers](int workerIndex) {
+					aggregatorWorker& worker = workers[workerIndex];
+					string xml;
+					reportData report;
+					if ((!load(i, xml)) || (!report.fromXml(xml))) {
+						worker.failed++;
+						return;
+					}
+					// Other xml files (e.g. devices.xml) parse fine, but contain no report data
+					if ((report.caps.empty()) && (report.extensions.empty())) {
+						return;
+					}
+					worker.reports++;
+					for (auto& cap : report.caps) {
+						if (!reportData::isAvailable(cap.second)) {
+							continue;
+						}
+						size_t id = worker.localId(worker.capIds, capNames, cap.first);
+						if (id >= worker.capReports.size()) {
+							worker.capReports.resize(id + 1, 0);
+							worker.capValues.resize(id + 1);
+						}
+						worker.capReports[id]++;
+						double value;
+						if (parseNumber(cap.second, value)) {
+							worker.capValues[id].push_back(value);
+						}
+					}
+					for (auto& extension : report.extensions) {
+						size_t id = worker.localId(worker.extensionIds, extensionNames, extension);
+						if (id >= worker.extensionReports.size()) {
+							worker.extensionReports.resize(id + 1, 0);
+						}
+						worker.extensionReports[id]++;
+					}
+					for (auto& format : report.compressedFormats) {
+						worker.formatReports[format]++;
+					}
+				});
+			}
+			pool.wait();
+			steals = pool.steals;
+		}
+
+		// Merge
+		reportCount = 0;
+		failedCount = 0;
+		vector<int> capReports(capNames.size(), 0);
+		vector<vector<double>> capValues(capNames.size());
+		vector<int> extensionReports(extensionNames.size(), 0);
+		unordered_map<GLint, int> formatReports;
+		for (auto& worker : workers) {
+			reportCount += worker.reports;
+			failedCount += worker.failed;
+			for (size_t id = 0; id < worker.capReports.size(); id++) {
+				capReports[id] += worker.capReports[id];
+				capValues[id].insert(capValues[id].end(), worker.capValues[id].begin(), worker.capValues[id].end());
+			}
+			for (size_t id = 0; id < worker.extensionReports.size(); id++) {
+				extensionReports[id] += worker.extensionReports[id];
+			}
+			for (auto& format : worker.formatReports) {
+				formatReports[format.first] += format.second;
+			}
+		}
+
+		capDistributions.clear();
+		for (int id = 0; id < capNames.size(); id++) {
+			capDistribution distribution;
+			distribution.name = capNames.name(id);
+			distribution.reports = capReports[id];
+			vector<double>& values = capValues[id];
+			distribution.numericReports = (int)values.size();
+			if (!values.empty()) {
+				sort(values.begin(), values.end());
+				distribution.minValue = values.front();
+				distribution.maxValue = values.back();
+				double sum = 0.0;
+				for (auto value : values) {
+					sum += value;
+				}
+				distribution.meanValue = sum / values.size();
+				const double ranks[5] = { 5.0, 25.0, 50.0, 75.0, 95.0 };
+				for (int i = 0; i < 5; i++) {
+					distribution.percentiles[i] = percentile(values, ranks[i]);
+				}
+			}
+			capDistributions.push_back(distribution);
+		}
+		sort(capDistributions.begin(), capDistributions.end(), [](const capDistribution& a, const capDistribution& b) { return a.name < b.name; });
+
+		extensionAdoption.clear();
+		for (int id = 0; id < extensionNames.size(); id++) {
+			extensionAdoption.push_back(make_pair(extensionNames.name(id), extensionReports[id]));
+		}
+		sort(extensionAdoption.begin(), extensionAdoption.end(), [](const pair<string, int>& a, const pair<string, int>& b) {
+			return (a.second != b.second) ? (a.second > b.second) : (a.first < b.first);
+		});
+
+		compressedFormatCoverage.assign(formatReports.begin(), formatReports.end());
+		sort(compressedFormatCoverage.begin(), compressedFormatCoverage.end(), [](const pair<GLint, int>& a, const pair<GLint, int>& b) {
+			return (a.second != b.second) ? (a.second > b.second) : (a.first < b.first);
+		});
+
+		parseTime = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	}
+
+	/// <summary>
+	/// Parsing throughput normalized to a single core, comparable between machines with different core counts
+	/// </summary>
+	double reportAggregator::reportsPerSecondPerCore() const
+	{
+		if ((parseTime <= 0.0) || (threadsUsed == 0)) {
+			return 0.0;
+		}
+		return (reportCount + failedCount) / parseTime / threadsUsed;
+	}
+
+	string reportAggregator::toText(function<string(GLint)> getEnumName) const
+	{
+		stringstream ss;
+		ss << fixed << setprecision(1);
+		ss << "Reports: " << reportCount << " (" << failedCount << " failed)\n";
+		ss << "Parsing: " << setprecision(3) << parseTime << " s on " << threadsUsed << " threads (" << steals << " tasks stolen), ";
+		ss << setprecision(1) << ((parseTime > 0.0) ? (reportCount + failedCount) / parseTime : 0.0) << " reports/s, " << reportsPerSecondPerCore() << " reports/s/core\n";
+
+		ss << "\n[Caps] name, reports, numeric reports, min, p5, p25, p50, p75, p95, max, mean\n";
+		for (auto& distribution : capDistributions) {
+			ss << distribution.name << ", " << distribution.reports << ", " << distribution.numericReports;
+			if (distribution.numericReports > 0) {
+				ss << ", " << formatNumber(distribution.minValue);
+				for (int i = 0; i < 5; i++) {
+					ss << ", " << formatNumber(distribution.percentiles[i]);
+				}
+				ss << ", " << formatNumber(distribution.maxValue) << ", " << formatNumber(distribution.meanValue);
+			}
+			ss << "\n";
+		}
+
+		double reports = max(1, reportCount);
+		ss << "\n[Extensions] name, reports, adoption %\n";
+		for (auto& extension : extensionAdoption) {
+			ss << extension.first << ", " << extension.second << ", " << 100.0 * extension.second / reports << "\n";
+		}
+
+		ss << "\n[Compressed formats] name, reports, coverage %\n";
+		for (auto& format : compressedFormatCoverage) {
+			ss << getEnumName(format.first) << ", " << format.second << ", " << 100.0 * format.second / reports << "\n";
+		}
+
+		return ss.str();
+	}
+
+}
@@ -0,0 +1,92 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Aggregated statistics over a set of report files
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <GL/glew.h>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Interned names, every distinct name is stored once and referenced by its index
+	/// </summary>
+	class nameTable
+	{
+	private:
+		mutex lock;
+		unordered_map<string, int> ids;
+		vector<string> names;
+	public:
+		int intern(const string& name);
+		const string& name(int id) const;
+		int size() const;
+		void clear();
+	};
+
+	class capDistribution
+	{
+	public:
+		string name;
+		// Reports containing the cap with a value / with a numeric value
+		int reports = 0;
+		int numericReports = 0;
+		double minValue = 0.0;
+		double maxValue = 0.0;
+		double meanValue = 0.0;
+		// 5th, 25th, 50th, 75th and 95th percentile (nearest rank)
+		double percentiles[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+	};
+
+	class reportAggregator
+	{
+	private:
+		void aggregate(size_t count, function<bool(size_t, string&)> load);
+	public:
+		// Number of worker threads, 0 for one per hardware thread
+		int threadCount = 0;
+		nameTable capNames;
+		nameTable extensionNames;
+		int reportCount = 0;
+		int failedCount = 0;
+		int threadsUsed = 0;
+		size_t steals = 0;
+		// Parsing and aggregation time in seconds
+		double parseTime = 0.0;
+		vector<capDistribution> capDistributions;
+		// Number of reports per extension / compressed format, most common first
+		vector<pair<string, int>> extensionAdoption;
+		vector<pair<GLint, int>> compressedFormatCoverage;
+		static vector<string> findReports(const string& directory);
+		void aggregateFiles(const vector<string>& fileNames);
+		void aggregateXml(const vector<string>& reports);
+		double reportsPerSecondPerCore() const;
+		string toText(function<string(GLint)> getEnumName) const;
+	};
+
+}
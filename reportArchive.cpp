@@ -0,0 +1,671 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Content addressed report archive with deduplicated chunks
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportArchive.h"
+#include "workStealingPool.h"
+#include <QCryptographicHash>
+#include <QByteArray>
+#include <QString>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	static_assert(sizeof(archiveHeader) == 16, "archiveHeader must match the file layout");
+	static_assert(sizeof(archiveSection) == 24, "archiveSection must match the file layout");
+	static_assert(sizeof(archiveChunkRecord) == 48, "archiveChunkRecord must match the file layout");
+	static_assert(sizeof(archiveReportRecord) == 64, "archiveReportRecord must match the file layout");
+
+	// Chunk payloads are a 32 bit entry count followed by the entries, strings are stored with a 32 bit length prefix
+
+	void appendUint32(string& buffer, uint32_t value)
+	{
+		char bytes[sizeof(value)];
+		memcpy(bytes, &value, sizeof(value));
+		buffer.append(bytes, sizeof(value));
+	}
+
+	void appendString(string& buffer, const string& value)
+	{
+		appendUint32(buffer, (uint32_t)value.size());
+		buffer.append(value);
+	}
+
+	template<typename T> void appendRecord(string& buffer, const T& record)
+	{
+		buffer.append(reinterpret_cast<const char*>(&record), sizeof(T));
+	}
+
+	class payloadReader
+	{
+	public:
+		const string& data;
+		size_t position = 0;
+		payloadReader(const string& data) : data(data) {}
+		bool readUint32(uint32_t& value)
+		{
+			if (position + sizeof(value) > data.size()) {
+				return false;
+			}
+			memcpy(&value, data.data() + position, sizeof(value));
+			position += sizeof(value);
+			return true;
+		}
+		bool readString(string& value)
+		{
+			uint32_t size;
+			if ((!readUint32(size)) || (position + size > data.size())) {
+				return false;
+			}
+			value.assign(data, position, size);
+			position += size;
+			return true;
+		}
+	};
+
+	bool readPairs(const string& payload, vector<pair<string, string>>& pairs)
+	{
+		payloadReader reader(payload);
+		uint32_t count;
+		if (!reader.readUint32(count)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			pair<string, string> entry;
+			if ((!reader.readString(entry.first)) || (!reader.readString(entry.second))) {
+				return false;
+			}
+			pairs.push_back(entry);
+		}
+		return true;
+	}
+
+	void reportArchive::clear()
+	{
+		chunks.clear();
+		reports.clear();
+		chunkIndices.clear();
+		xmlBytes = 0;
+		compressedXmlBytes = 0;
+		fileSize = 0;
+		chunkDataOffset = 0;
+		lock_guard<mutex> guard(fileLock);
+		if (file.is_open()) {
+			file.close();
+		}
+	}
+
+	/// <summary>
+	/// Caps are chunked by the categories of the capability list (the caps groups of the viewer)
+	/// Without a schema all caps of a report form a single chunk
+	/// </summary>
+	void reportArchive::createSchema(const capsList& caps)
+	{
+		capCategories.clear();
+		for (uint32_t i = 0; i < caps.categories.size(); i++) {
+			for (auto& cap : caps.categories[i].caps) {
+				capCategories.emplace(cap.name, i);
+			}
+		}
+	}
+
+	string reportArchive::hashChunk(archiveChunkType type, const string& payload)
+	{
+		QCryptographicHash hash(QCryptographicHash::Sha1);
+		char typeByte = (char)type;
+		hash.addData(&typeByte, 1);
+		hash.addData(payload.data(), (int)payload.size());
+		QByteArray result = hash.result();
+		return string(result.constData(), result.size());
+	}
+
+	/// <summary>
+	/// Splits a report into its chunk payloads, the order of caps and internal formats is kept
+	/// Consecutive caps of the same caps group form a chunk, multi component caps (e.g. GL_MAX_VIEWPORT_DIMS[0]) belong to the group of their base cap
+	/// </summary>
+	vector<pair<archiveChunkType, string>> reportArchive::splitReport(const reportData& report) const
+	{
+		vector<pair<archiveChunkType, string>> payloads;
+		string entries;
+		uint32_t count = 0;
+		uint32_t runGroup = 0;
+		auto flush = [&](archiveChunkType type) {
+			if (count > 0) {
+				string payload;
+				appendUint32(payload, count);
+				payload += entries;
+				payloads.push_back(make_pair(type, payload));
+			}
+			entries.clear();
+			count = 0;
+		};
+
+		for (auto& cap : report.caps) {
+			auto category = capCategories.find(cap.first.substr(0, cap.first.find('[')));
+			uint32_t group = (category != capCategories.end()) ? category->second : UINT32_MAX;
+			if ((count > 0) && (group != runGroup)) {
+				flush(chunkCaps);
+			}
+			runGroup = group;
+			appendString(entries, cap.first);
+			appendString(entries, cap.second);
+			count++;
+		}
+		flush(chunkCaps);
+
+		for (auto& extension : report.extensions) {
+			appendString(entries, extension);
+			count++;
+		}
+		flush(chunkExtensions);
+
+		for (auto& compressedFormat : report.compressedFormats) {
+			appendUint32(entries, (uint32_t)compressedFormat);
+			count++;
+		}
+		flush(chunkCompressedFormats);
+
+		// One chunk per target, keys are "target/format/info"
+		string runTarget;
+		for (auto& internalFormat : report.internalFormats) {
+			string target = internalFormat.first.substr(0, internalFormat.first.find('/'));
+			if ((count > 0) && (target != runTarget)) {
+				flush(chunkInternalFormats);
+			}
+			runTarget = target;
+			appendString(entries, internalFormat.first);
+			appendString(entries, internalFormat.second);
+			count++;
+		}
+		flush(chunkInternalFormats);
+
+		return payloads;
+	}
+
+	uint32_t reportArchive::addChunk(archiveChunkType type, const string& payload, const string& hash)
+	{
+		auto chunkIndex = chunkIndices.find(hash);
+		if (chunkIndex != chunkIndices.end()) {
+			chunks[chunkIndex->second].references++;
+			return chunkIndex->second;
+		}
+		uint32_t index = (uint32_t)chunks.size();
+		archiveChunk chunk;
+		chunk.type = type;
+		chunk.hash = hash;
+		chunk.payload = payload;
+		chunk.loaded = true;
+		chunk.size = (uint32_t)payload.size();
+		chunk.references = 1;
+		chunks.push_back(chunk);
+		chunkIndices.emplace(hash, index);
+		return index;
+	}
+
+	/// <summary>
+	/// Adds a report whose chunk payloads and hashes have already been computed
+	/// </summary>
+	size_t reportArchive::addSplitReport(const reportData& report, const vector<pair<archiveChunkType, string>>& payloads, const vector<string>& hashes)
+	{
+		archivedReport archived;
+		archived.fields[fieldDescription] = report.description;
+		archived.fields[fieldOperatingSystem] = report.operatingSystem;
+		archived.fields[fieldContextType] = report.contextType;
+		archived.fields[fieldDate] = report.date;
+		archived.fields[fieldSubmitter] = report.submitter;
+		archived.fields[fieldComment] = report.comment;
+		archived.hasInternalFormats = report.hasInternalFormats;
+		for (size_t i = 0; i < payloads.size(); i++) {
+			archived.chunks.push_back(addChunk(payloads[i].first, payloads[i].second, hashes[i]));
+		}
+		reports.push_back(archived);
+		return reports.size() - 1;
+	}
+
+	/// <returns>Index of the new report</returns>
+	size_t reportArchive::addReport(const reportData& report)
+	{
+		vector<pair<archiveChunkType, string>> payloads = splitReport(report);
+		vector<string> hashes;
+		for (auto& payload : payloads) {
+			hashes.push_back(hashChunk(payload.first, payload.second));
+		}
+		return addSplitReport(report, payloads, hashes);
+	}
+
+	/// <summary>
+	/// Parses, splits and hashes report files on a work stealing pool, chunks are added in file order so archives are reproducible
+	/// Also sums up the size of the files and of the per file zlib compressed files for comparison
+	/// </summary>
+	/// <returns>Number of reports added</returns>
+	int reportArchive::importFiles(const vector<string>& fileNames, int threadCount)
+	{
+		class splitFile
+		{
+		public:
+			bool valid = false;
+			reportData report;
+			vector<pair<archiveChunkType, string>> payloads;
+			vector<string> hashes;
+			size_t xmlSize = 0;
+			size_t compressedSize = 0;
+		};
+
+		// Batches keep the parsed reports of only a part of the files in memory
+		const size_t batchSize = 256;
+		int imported = 0;
+		workStealingPool pool(threadCount);
+		for (size_t batchStart = 0; batchStart < fileNames.size(); batchStart += batchSize) {
+			vector<splitFile> files(min(batchSize, fileNames.size() - batchStart));
+			for (size_t i = 0; i < files.size(); i++) {
+				pool.submit([this, i, batchStart, &files, &fileNames](int) {
+					ifstream reportFile(fileNames[batchStart + i], ios::binary);
+					string xml((istreambuf_iterator<char>(reportFile)), istreambuf_iterator<char>());
+					splitFile& split = files[i];
+					if ((xml.empty()) || (!split.report.fromXml(xml)) || ((split.report.caps.empty()) && (split.report.extensions.empty()))) {
+						return;
+					}
+					split.valid = true;
+					split.xmlSize = xml.size();
+					split.compressedSize = qCompress(QByteArray::fromRawData(xml.data(), (int)xml.size()), 9).size();
+					split.payloads = splitReport(split.report);
+					for (auto& payload : split.payloads) {
+						split.hashes.push_back(hashChunk(payload.first, payload.second));
+					}
+				});
+			}
+			pool.wait();
+
+			for (auto& split : files) {
+				if (!split.valid) {
+					continue;
+				}
+				addSplitReport(split.report, split.payloads, split.hashes);
+				xmlBytes += split.xmlSize;
+				compressedXmlBytes += split.compressedSize;
+				imported++;
+			}
+		}
+		return imported;
+	}
+
+	/// <summary>
+	/// Writes the archive, chunks are compressed in parallel
+	/// </summary>
+	bool reportArchive::save(const string& fileName, int threadCount)
+	{
+		for (uint32_t i = 0; i < chunks.size(); i++) {
+			if ((!chunks[i].loaded) && (!loadChunk(i, chunks[i].payload))) {
+				return false;
+			}
+			chunks[i].loaded = true;
+		}
+
+		vector<QByteArray> storedChunks(chunks.size());
+		if (compressChunks) {
+			workStealingPool pool(threadCount);
+			for (size_t i = 0; i < chunks.size(); i++) {
+				pool.submit([this, i, &storedChunks](int) {
+					const string& payload = chunks[i].payload;
+					storedChunks[i] = qCompress(QByteArray::fromRawData(payload.data(), (int)payload.size()), 9);
+				});
+			}
+			pool.wait();
+		}
+
+		string strings;
+		string chunkRecords;
+		string chunkData;
+		string reportRecords;
+		string chunkRefs;
+		for (size_t i = 0; i < chunks.size(); i++) {
+			archiveChunk& chunk = chunks[i];
+			chunk.compressed = (compressChunks) && ((size_t)storedChunks[i].size() < chunk.payload.size());
+			chunk.offset = chunkData.size();
+			if (chunk.compressed) {
+				chunkData.append(storedChunks[i].constData(), storedChunks[i].size());
+			}
+			else {
+				chunkData.append(chunk.payload);
+			}
+			chunk.storedSize = (uint32_t)(chunkData.size() - chunk.offset);
+			archiveChunkRecord record;
+			memcpy(record.hash, chunk.hash.data(), sizeof(record.hash));
+			record.type = chunk.type;
+			record.offset = chunk.offset;
+			record.storedSize = chunk.storedSize;
+			record.size = chunk.size;
+			record.compressed = chunk.compressed ? 1 : 0;
+			record.references = chunk.references;
+			appendRecord(chunkRecords, record);
+		}
+		for (auto& report : reports) {
+			archiveReportRecord record;
+			for (int f = 0; f < fieldCount; f++) {
+				record.fields[f].offset = (uint32_t)strings.size();
+				record.fields[f].size = (uint32_t)report.fields[f].size();
+				strings += report.fields[f];
+			}
+			record.hasInternalFormats = report.hasInternalFormats ? 1 : 0;
+			record.firstChunk = (uint32_t)(chunkRefs.size() / sizeof(uint32_t));
+			record.chunkCount = (uint32_t)report.chunks.size();
+			record.reserved = 0;
+			for (auto& chunk : report.chunks) {
+				appendUint32(chunkRefs, chunk);
+			}
+			appendRecord(reportRecords, record);
+		}
+
+		const string* sectionData[] = { &strings, &chunkRecords, &chunkData, &reportRecords, &chunkRefs };
+		const uint32_t sectionCount = 5;
+		archiveHeader header;
+		memcpy(header.magic, "GLCA", 4);
+		header.version = fileVersion;
+		header.sectionCount = sectionCount;
+		header.flags = 0;
+		uint64_t offset = sizeof(archiveHeader) + sectionCount * sizeof(archiveSection);
+		uint64_t sectionOffsets[sectionCount];
+		string headerData;
+		appendRecord(headerData, header);
+		for (uint32_t i = 0; i < sectionCount; i++) {
+			offset = (offset + 7) & ~(uint64_t)7;
+			archiveSection section;
+			section.type = i;
+			section.reserved = 0;
+			section.offset = offset;
+			sectionOffsets[i] = offset;
+			section.size = sectionData[i]->size();
+			appendRecord(headerData, section);
+			if (i == sectionChunkData) {
+				chunkDataOffset = offset;
+			}
+			offset += section.size;
+		}
+
+		lock_guard<mutex> guard(fileLock);
+		if (file.is_open()) {
+			file.close();
+		}
+		ofstream destFile(fileName, ios::binary | ios::trunc);
+		if (!destFile.is_open()) {
+			return false;
+		}
+		destFile.write(headerData.data(), headerData.size());
+		uint64_t written = headerData.size();
+		for (uint32_t i = 0; i < sectionCount; i++) {
+			const char padding[8] = {};
+			destFile.write(padding, sectionOffsets[i] - written);
+			written = sectionOffsets[i] + sectionData[i]->size();
+			destFile.write(sectionData[i]->data(), sectionData[i]->size());
+		}
+		fileSize = offset;
+		return destFile.good();
+	}
+
+	/// <summary>
+	/// Reads the index (chunk table, reports and their chunk references) of an archive, chunk payloads are read on access
+	/// </summary>
+	bool reportArchive::open(const string& fileName)
+	{
+		clear();
+		lock_guard<mutex> guard(fileLock);
+		file.open(fileName, ios::binary);
+		if (!file.is_open()) {
+			return false;
+		}
+		file.seekg(0, ios::end);
+		fileSize = file.tellg();
+		file.seekg(0);
+
+		archiveHeader header;
+		if ((!file.read(reinterpret_cast<char*>(&header), sizeof(header))) || (memcmp(header.magic, "GLCA", 4) != 0) || (header.version != fileVersion)) {
+			file.close();
+			return false;
+		}
+		// The section count is checked against the file size before allocating, so corrupt archives can't force huge allocations
+		uint64_t sectionTableSize = (uint64_t)header.sectionCount * sizeof(archiveSection);
+		if (sizeof(archiveHeader) + sectionTableSize > fileSize) {
+			file.close();
+			return false;
+		}
+		vector<archiveSection> sections(header.sectionCount);
+		if (!file.read(reinterpret_cast<char*>(sections.data()), sections.size() * sizeof(archiveSection))) {
+			file.close();
+			return false;
+		}
+		string sectionData[sectionChunkRefs + 1];
+		for (auto& section : sections) {
+			if ((section.offset > fileSize) || (section.size > fileSize - section.offset)) {
+				file.close();
+				return false;
+			}
+			if (section.type == sectionChunkData) {
+				chunkDataOffset = section.offset;
+			}
+			else if (section.type <= sectionChunkRefs) {
+				sectionData[section.type].resize((size_t)section.size);
+				file.seekg(section.offset);
+				file.read(&sectionData[section.type][0], section.size);
+			}
+		}
+
+		const string& strings = sectionData[sectionStrings];
+		const string& chunkRecords = sectionData[sectionChunks];
+		const string& reportRecords = sectionData[sectionReports];
+		const string& chunkRefs = sectionData[sectionChunkRefs];
+		for (size_t offset = 0; offset + sizeof(archiveChunkRecord) <= chunkRecords.size(); offset += sizeof(archiveChunkRecord)) {
+			archiveChunkRecord record;
+			memcpy(&record, chunkRecords.data() + offset, sizeof(record));
+			archiveChunk chunk;
+			chunk.type = (archiveChunkType)record.type;
+			chunk.hash.assign(reinterpret_cast<const char*>(record.hash), sizeof(record.hash));
+			chunk.offset = record.offset;
+			chunk.storedSize = record.storedSize;
+			chunk.size = record.size;
+			chunk.compressed = (record.compressed != 0);
+			chunk.references = record.references;
+			chunkIndices.emplace(chunk.hash, (uint32_t)chunks.size());
+			chunks.push_back(chunk);
+		}
+		for (size_t offset = 0; offset + sizeof(archiveReportRecord) <= reportRecords.size(); offset += sizeof(archiveReportRecord)) {
+			archiveReportRecord record;
+			memcpy(&record, reportRecords.data() + offset, sizeof(record));
+			archivedReport report;
+			for (int f = 0; f < fieldCount; f++) {
+				if ((uint64_t)record.fields[f].offset + record.fields[f].size <= strings.size()) {
+					report.fields[f] = strings.substr(record.fields[f].offset, record.fields[f].size);
+				}
+			}
+			report.hasInternalFormats = (record.hasInternalFormats != 0);
+			for (uint32_t c = 0; c < record.chunkCount; c++) {
+				size_t refOffset = ((size_t)record.firstChunk + c) * sizeof(uint32_t);
+				uint32_t chunk;
+				if (refOffset + sizeof(chunk) > chunkRefs.size()) {
+					break;
+				}
+				memcpy(&chunk, chunkRefs.data() + refOffset, sizeof(chunk));
+				if (chunk < chunks.size()) {
+					report.chunks.push_back(chunk);
+				}
+			}
+			reports.push_back(report);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Returns the uncompressed payload of a chunk, reading it from the archive file if it has not been loaded yet
+	/// </summary>
+	bool reportArchive::loadChunk(uint32_t index, string& payload) const
+	{
+		const archiveChunk& chunk = chunks[index];
+		if (chunk.loaded) {
+			payload = chunk.payload;
+			return true;
+		}
+		// Chunks reaching past the end of the file are rejected before allocating, so corrupt records can't force huge allocations
+		if ((chunkDataOffset > fileSize) || (chunk.offset > fileSize - chunkDataOffset) || (chunk.storedSize > fileSize - chunkDataOffset - chunk.offset)) {
+			return false;
+		}
+		string stored(chunk.storedSize, '\0');
+		{
+			lock_guard<mutex> guard(fileLock);
+			if (!file.is_open()) {
+				return false;
+			}
+			file.clear();
+			file.seekg(chunkDataOffset + chunk.offset);
+			if ((chunk.storedSize > 0) && (!file.read(&stored[0], chunk.storedSize))) {
+				return false;
+			}
+		}
+		if (chunk.compressed) {
+			QByteArray uncompressed = qUncompress(QByteArray::fromRawData(stored.data(), (int)stored.size()));
+			payload.assign(uncompressed.constData(), uncompressed.size());
+		}
+		else {
+			payload = stored;
+		}
+		return (payload.size() == chunk.size) && (hashChunk(chunk.type, payload) == chunk.hash);
+	}
+
+	/// <summary>
+	/// Reassembles a report from its chunks, safe to call from multiple threads
+	/// </summary>
+	/// <returns>false if a chunk could not be read or is corrupt (content does not match the hash)</returns>
+	bool reportArchive::readReport(size_t index, reportData& report) const
+	{
+		report.clear();
+		if (index >= reports.size()) {
+			return false;
+		}
+		const archivedReport& archived = reports[index];
+		report.description = archived.fields[fieldDescription];
+		report.operatingSystem = archived.fields[fieldOperatingSystem];
+		report.contextType = archived.fields[fieldContextType];
+		report.date = archived.fields[fieldDate];
+		report.submitter = archived.fields[fieldSubmitter];
+		report.comment = archived.fields[fieldComment];
+		report.hasInternalFormats = archived.hasInternalFormats;
+		for (auto& chunkIndex : archived.chunks) {
+			string payload;
+			if (!loadChunk(chunkIndex, payload)) {
+				return false;
+			}
+			payloadReader reader(payload);
+			uint32_t count;
+			bool valid = true;
+			switch (chunks[chunkIndex].type) {
+			case chunkCaps:
+				valid = readPairs(payload, report.caps);
+				break;
+			case chunkInternalFormats:
+				valid = readPairs(payload, report.internalFormats);
+				break;
+			case chunkExtensions:
+				valid = reader.readUint32(count);
+				for (uint32_t i = 0; (valid) && (i < count); i++) {
+					string extension;
+					valid = reader.readString(extension);
+					report.extensions.push_back(extension);
+				}
+				break;
+			case chunkCompressedFormats:
+				valid = reader.readUint32(count);
+				for (uint32_t i = 0; (valid) && (i < count); i++) {
+					uint32_t compressedFormat;
+					valid = reader.readUint32(compressedFormat);
+					report.compressedFormats.push_back((GLint)compressedFormat);
+				}
+				break;
+			}
+			if (!valid) {
+				return false;
+			}
+		}
+		report.indexCaps();
+		return true;
+	}
+
+	/// <summary>
+	/// Returns a report in the layout of exported reports, empty if the report could not be read
+	/// </summary>
+	string reportArchive::exportXml(size_t index) const
+	{
+		reportData report;
+		return readReport(index, report) ? report.toXml() : "";
+	}
+
+	/// <summary>
+	/// Returns the indices of all reports whose description contains the text (case insensitive)
+	/// </summary>
+	vector<size_t> reportArchive::find(const string& text) const
+	{
+		vector<size_t> indices;
+		QString searchText = QString::fromStdString(text);
+		for (size_t i = 0; i < reports.size(); i++) {
+			if (QString::fromStdString(reports[i].fields[fieldDescription]).contains(searchText, Qt::CaseInsensitive)) {
+				indices.push_back(i);
+			}
+		}
+		return indices;
+	}
+
+	size_t reportArchive::chunkReferences() const
+	{
+		size_t references = 0;
+		for (auto& report : reports) {
+			references += report.chunks.size();
+		}
+		return references;
+	}
+
+	/// <summary>
+	/// Uncompressed size of all unique chunks
+	/// </summary>
+	uint64_t reportArchive::chunkBytes() const
+	{
+		uint64_t bytes = 0;
+		for (auto& chunk : chunks) {
+			bytes += chunk.size;
+		}
+		return bytes;
+	}
+
+	/// <summary>
+	/// Uncompressed size of all chunks referenced by the reports, i.e. the size without deduplication
+	/// </summary>
+	uint64_t reportArchive::referencedBytes() const
+	{
+		uint64_t bytes = 0;
+		for (auto& report : reports) {
+			for (auto& chunk : report.chunks) {
+				bytes += chunks[chunk].size;
+			}
+		}
+		return bytes;
+	}
+
+}
@@ -0,0 +1,164 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Content addressed report archive with deduplicated chunks
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include "capsList.h"
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	enum archiveChunkType { chunkCaps, chunkExtensions, chunkCompressedFormats, chunkInternalFormats };
+
+	enum archiveSectionType { sectionStrings, sectionChunks, sectionChunkData, sectionReports, sectionChunkRefs };
+
+	// Fixed size records of the archive file, all values are little endian and sections start at 8 byte boundaries
+	// File layout : header, section table, sections
+
+	class archiveHeader
+	{
+	public:
+		char magic[4];
+		uint32_t version;
+		uint32_t sectionCount;
+		uint32_t flags;
+	};
+
+	class archiveSection
+	{
+	public:
+		uint32_t type;
+		uint32_t reserved;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	class archiveChunkRecord
+	{
+	public:
+		// SHA-1 of the chunk type and the uncompressed payload
+		uint8_t hash[20];
+		uint32_t type;
+		// Offset relative to the chunk data section
+		uint64_t offset;
+		uint32_t storedSize;
+		uint32_t size;
+		uint32_t compressed;
+		uint32_t references;
+	};
+
+	// Range of the string section
+	class archiveStringRef
+	{
+	public:
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	enum archiveReportField { fieldDescription, fieldOperatingSystem, fieldContextType, fieldDate, fieldSubmitter, fieldComment, fieldCount };
+
+	class archiveReportRecord
+	{
+	public:
+		archiveStringRef fields[fieldCount];
+		uint32_t hasInternalFormats;
+		// Range of the chunk reference section
+		uint32_t firstChunk;
+		uint32_t chunkCount;
+		uint32_t reserved;
+	};
+
+	class archiveChunk
+	{
+	public:
+		archiveChunkType type;
+		string hash;
+		// Uncompressed payload, chunks of an opened archive are only loaded on access
+		string payload;
+		bool loaded = false;
+		uint64_t offset = 0;
+		uint32_t storedSize = 0;
+		uint32_t size = 0;
+		bool compressed = false;
+		uint32_t references = 0;
+	};
+
+	class archivedReport
+	{
+	public:
+		string fields[fieldCount];
+		bool hasInternalFormats = false;
+		vector<uint32_t> chunks;
+	};
+
+	/// <summary>
+	/// Reports are split into chunks (one per caps group, the extension list, the compressed formats and one per internal format target)
+	/// Chunks are identified by their content hash and stored only once, so reports of the same driver family mostly share their chunks
+	/// </summary>
+	class reportArchive
+	{
+	private:
+		unordered_map<string, uint32_t> chunkIndices;
+		// Caps group (capability list category) of each cap
+		unordered_map<string, uint32_t> capCategories;
+		mutable mutex fileLock;
+		mutable ifstream file;
+		uint64_t chunkDataOffset = 0;
+		uint32_t addChunk(archiveChunkType type, const string& payload, const string& hash);
+		size_t addSplitReport(const reportData& report, const vector<pair<archiveChunkType, string>>& payloads, const vector<string>& hashes);
+		bool loadChunk(uint32_t index, string& payload) const;
+	public:
+		static const uint32_t fileVersion = 1;
+		vector<archiveChunk> chunks;
+		vector<archivedReport> reports;
+		// Chunks are stored zlib compressed if that makes them smaller
+		bool compressChunks = true;
+		// Size of the imported report files, uncompressed and zlib compressed per file
+		uint64_t xmlBytes = 0;
+		uint64_t compressedXmlBytes = 0;
+		// Size of the last saved or opened archive file
+		uint64_t fileSize = 0;
+		void clear();
+		void createSchema(const capsList& caps);
+		vector<pair<archiveChunkType, string>> splitReport(const reportData& report) const;
+		size_t addReport(const reportData& report);
+		int importFiles(const vector<string>& fileNames, int threadCount = 0);
+		bool save(const string& fileName, int threadCount = 0);
+		bool open(const string& fileName);
+		bool readReport(size_t index, reportData& report) const;
+		string exportXml(size_t index) const;
+		vector<size_t> find(const string& text) const;
+		size_t chunkReferences() const;
+		uint64_t chunkBytes() const;
+		uint64_t referencedBytes() const;
+		static string hashChunk(archiveChunkType type, const string& payload);
+	};
+
+}
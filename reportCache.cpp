@@ -0,0 +1,119 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Local copies of database reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportCache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	reportCache::reportCache(string directory)
+	{
+		this->directory = directory;
+		QDir().mkpath(QString::fromStdString(directory));
+	}
+
+	string reportCache::defaultDirectory()
+	{
+		return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString() + "/reports";
+	}
+
+	/// <summary>
+	/// Database id of a cached report
+	/// </summary>
+	/// <returns>-1 for imported reports</returns>
+	int reportCache::reportId(const string& fileName)
+	{
+		QString baseName = QFileInfo(QString::fromStdString(fileName)).completeBaseName();
+		if (!baseName.startsWith("report_")) {
+			return -1;
+		}
+		bool ok;
+		int id = baseName.mid(7).toInt(&ok);
+		return ok ? id : -1;
+	}
+
+	string reportCache::fileName(int reportId)
+	{
+		return directory + "/report_" + to_string(reportId) + ".xml";
+	}
+
+	bool reportCache::contains(int reportId)
+	{
+		return QFile::exists(QString::fromStdString(fileName(reportId)));
+	}
+
+	bool reportCache::store(int reportId, const string& xml)
+	{
+		QFile file(QString::fromStdString(fileName(reportId)));
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			return false;
+		}
+		file.write(xml.c_str(), xml.size());
+		file.close();
+		return true;
+	}
+
+	/// <summary>
+	/// Copies a report file into the cache, named by the hash of its contents
+	/// Importing the same report again returns the same file, different reports with the same file name are kept apart
+	/// </summary>
+	/// <returns>Name of the cached file, empty if the file could not be read or copied</returns>
+	string reportCache::importFile(const string& fileName)
+	{
+		QFile source(QString::fromStdString(fileName));
+		if (!source.open(QIODevice::ReadOnly)) {
+			return "";
+		}
+		QByteArray contents = source.readAll();
+		source.close();
+		QString hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha1).toHex();
+		QString destination = QString::fromStdString(directory) + "/import_" + hash + ".xml";
+		if (!QFile::exists(destination)) {
+			QFile file(destination);
+			if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+				return "";
+			}
+			file.write(contents);
+			file.close();
+		}
+		return destination.toStdString();
+	}
+
+	vector<string> reportCache::fileNames()
+	{
+		vector<string> files;
+		QDir dir(QString::fromStdString(directory));
+		QStringList entries = dir.entryList(QStringList() << "*.xml", QDir::Files, QDir::Name);
+		for (auto& entry : entries) {
+			files.push_back(dir.filePath(entry).toStdString());
+		}
+		return files;
+	}
+
+}
@@ -0,0 +1,49 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Local copies of database reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Reports fetched from the database are stored as report_<id>.xml, imported reports as import_<sha1 of the contents>.xml
+	/// </summary>
+	class reportCache
+	{
+	public:
+		string directory;
+		reportCache(string directory = defaultDirectory());
+		static string defaultDirectory();
+		static int reportId(const string& fileName);
+		string fileName(int reportId);
+		bool contains(int reportId);
+		bool store(int reportId, const string& xml);
+		string importFile(const string& fileName);
+		vector<string> fileNames();
+	};
+
+}
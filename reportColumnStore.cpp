@@ -0,0 +1,278 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Columnar in-memory store for querying large numbers of reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportColumnStore.h"
+#include "workStealingPool.h"
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <QString>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void reportColumnStore::clear()
+	{
+		rowCount = 0;
+		descriptions.clear();
+		renderers.clear();
+		columns.clear();
+		columnIndices.clear();
+		extensionNames.clear();
+		extensionBits.clear();
+		extensionIndices.clear();
+	}
+
+	/// <summary>
+	/// Creates one column per integer cap of the capability list
+	/// </summary>
+	void reportColumnStore::createSchema(const capsList& caps)
+	{
+		clear();
+		for (auto& name : caps.integerCapNames()) {
+			if (columnIndices.count(name) == 0) {
+				columnIndices[name] = columns.size();
+				storeColumn column;
+				column.name = name;
+				columns.push_back(column);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Appends a report as a new row, caps that are not part of the schema are ignored
+	/// </summary>
+	/// <returns>Index of the new row</returns>
+	size_t reportColumnStore::addReport(const reportData& report)
+	{
+		size_t row = rowCount++;
+		size_t word = row / 64;
+		uint64_t bit = (uint64_t)1 << (row % 64);
+		descriptions.push_back(report.description);
+		renderers.push_back(report.getCap("GL_RENDERER"));
+		for (auto& column : columns) {
+			column.values.push_back(0);
+			if (column.valid.size() <= word) {
+				column.valid.push_back(0);
+			}
+		}
+		for (auto& cap : report.caps) {
+			auto columnIndex = columnIndices.find(cap.first);
+			int64_t value;
+			if ((columnIndex != columnIndices.end()) && (reportQuery::parseValue(cap.second, value))) {
+				storeColumn& column = columns[columnIndex->second];
+				column.values[row] = value;
+				column.valid[word] |= bit;
+			}
+		}
+		for (auto& extension : report.extensions) {
+			auto extensionIndex = extensionIndices.find(extension);
+			if (extensionIndex == extensionIndices.end()) {
+				extensionIndex = extensionIndices.emplace(extension, extensionNames.size()).first;
+				extensionNames.push_back(extension);
+				extensionBits.push_back(vector<uint64_t>());
+			}
+			vector<uint64_t>& bits = extensionBits[extensionIndex->second];
+			if (bits.size() <= word) {
+				bits.resize(word + 1, 0);
+			}
+			bits[word] |= bit;
+		}
+		return row;
+	}
+
+	/// <summary>
+	/// Parses report files on a work stealing pool and adds them to the store
+	/// </summary>
+	/// <returns>Number of reports added</returns>
+	int reportColumnStore::importFiles(const vector<string>& fileNames, int threadCount)
+	{
+		mutex storeLock;
+		int imported = 0;
+		workStealingPool pool(threadCount);
+		for (auto& fileName : fileNames) {
+			pool.submit([this, &fileName, &storeLock, &imported](int) {
+				ifstream file(fileName, ios::binary);
+				string xml((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+				reportData report;
+				if ((xml.empty()) || (!report.fromXml(xml)) || ((report.caps.empty()) && (report.extensions.empty()))) {
+					return;
+				}
+				lock_guard<mutex> guard(storeLock);
+				addReport(report);
+				imported++;
+			});
+		}
+		pool.wait();
+		return imported;
+	}
+
+	/// <summary>
+	/// Compares 64 values per mask word, the inner loop has no branches so it's vectorized by the compiler
+	/// Words without remaining candidates are skipped
+	/// </summary>
+	template<typename Compare> void scanColumn(const storeColumn& column, int64_t reference, size_t rowCount, vector<uint64_t>& mask, Compare compare)
+	{
+		const int64_t* values = column.values.data();
+		for (size_t w = 0; w < mask.size(); w++) {
+			if (mask[w] == 0) {
+				continue;
+			}
+			size_t base = w * 64;
+			size_t count = min((size_t)64, rowCount - base);
+			uint64_t bits = 0;
+			for (size_t i = 0; i < count; i++) {
+				bits |= (uint64_t)compare(values[base + i], reference) << i;
+			}
+			mask[w] &= bits & column.valid[w];
+		}
+	}
+
+	/// <summary>
+	/// Evaluates a query to a row bitmask
+	/// </summary>
+	/// <returns>false if the query references a cap that is not stored</returns>
+	bool reportColumnStore::select(const reportQuery& query, vector<uint64_t>& mask, string& error) const
+	{
+		size_t words = (rowCount + 63) / 64;
+		mask.assign(words, ~(uint64_t)0);
+		if ((rowCount % 64) != 0) {
+			mask[words - 1] = ((uint64_t)1 << (rowCount % 64)) - 1;
+		}
+
+		for (auto& term : query.terms) {
+			if (term.type == queryCompare) {
+				auto columnIndex = columnIndices.find(term.name);
+				if (columnIndex == columnIndices.end()) {
+					error = term.name + " is not a numeric cap of the capability list";
+					return false;
+				}
+				const storeColumn& column = columns[columnIndex->second];
+				switch (term.op) {
+				case queryLess:
+					scanColumn(column, term.value, rowCount, mask, less<int64_t>());
+					break;
+				case queryLessEqual:
+					scanColumn(column, term.value, rowCount, mask, less_equal<int64_t>());
+					break;
+				case queryEqual:
+					scanColumn(column, term.value, rowCount, mask, equal_to<int64_t>());
+					break;
+				case queryNotEqual:
+					scanColumn(column, term.value, rowCount, mask, not_equal_to<int64_t>());
+					break;
+				case queryGreaterEqual:
+					scanColumn(column, term.value, rowCount, mask, greater_equal<int64_t>());
+					break;
+				case queryGreater:
+					scanColumn(column, term.value, rowCount, mask, greater<int64_t>());
+					break;
+				}
+				continue;
+			}
+
+			if (term.type == queryRenderer) {
+				QString text = QString::fromStdString(term.name);
+				for (size_t row = 0; row < rowCount; row++) {
+					if ((mask[row / 64] & ((uint64_t)1 << (row % 64))) && (!QString::fromStdString(renderers[row]).contains(text, Qt::CaseInsensitive))) {
+						mask[row / 64] &= ~((uint64_t)1 << (row % 64));
+					}
+				}
+				continue;
+			}
+
+			if (term.type == queryFormat) {
+				error = "Compressed formats are not stored in the column store";
+				return false;
+			}
+
+			// Extensions no report supports have no bitset
+			auto extensionIndex = extensionIndices.find(term.name);
+			const vector<uint64_t>* bits = (extensionIndex != extensionIndices.end()) ? &extensionBits[extensionIndex->second] : nullptr;
+			for (size_t w = 0; w < words; w++) {
+				uint64_t supported = ((bits) && (w < bits->size())) ? (*bits)[w] : 0;
+				mask[w] &= (term.type == queryExtension) ? supported : ~supported;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Parses and evaluates a query
+	/// </summary>
+	/// <returns>Indices of all matching rows</returns>
+	vector<size_t> reportColumnStore::query(const string& query, string& error) const
+	{
+		reportQuery parsedQuery;
+		vector<uint64_t> mask;
+		if (!parsedQuery.parse(query)) {
+			error = parsedQuery.error;
+			return vector<size_t>();
+		}
+		if (!select(parsedQuery, mask, error)) {
+			return vector<size_t>();
+		}
+		return maskToRows(mask);
+	}
+
+	size_t reportColumnStore::memoryUsage() const
+	{
+		size_t bytes = 0;
+		for (auto& column : columns) {
+			bytes += column.values.capacity() * sizeof(int64_t) + column.valid.capacity() * sizeof(uint64_t);
+		}
+		for (auto& bits : extensionBits) {
+			bytes += bits.capacity() * sizeof(uint64_t);
+		}
+		return bytes;
+	}
+
+	size_t reportColumnStore::countRows(const vector<uint64_t>& mask)
+	{
+		size_t count = 0;
+		for (auto word : mask) {
+			while (word != 0) {
+				word &= word - 1;
+				count++;
+			}
+		}
+		return count;
+	}
+
+	vector<size_t> reportColumnStore::maskToRows(const vector<uint64_t>& mask)
+	{
+		vector<size_t> rows;
+		for (size_t w = 0; w < mask.size(); w++) {
+			uint64_t word = mask[w];
+			for (size_t i = 0; word != 0; i++, word >>= 1) {
+				if (word & 1) {
+					rows.push_back(w * 64 + i);
+				}
+			}
+		}
+		return rows;
+	}
+
+}
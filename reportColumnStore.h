@@ -0,0 +1,74 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Columnar in-memory store for querying large numbers of reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "capsList.h"
+#include "reportDiff.h"
+#include "reportQuery.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Dense values of one numeric cap for all rows, rows without a value are cleared in the valid bitmap
+	/// </summary>
+	class storeColumn
+	{
+	public:
+		string name;
+		vector<int64_t> values;
+		vector<uint64_t> valid;
+	};
+
+	/// <summary>
+	/// One row per report, numeric caps are stored in columns defined by the capability list, extensions as one bitset per extension
+	/// Queries are evaluated as word wise scans producing a row bitmask (64 rows per word)
+	/// </summary>
+	class reportColumnStore
+	{
+	public:
+		size_t rowCount = 0;
+		vector<string> descriptions;
+		vector<string> renderers;
+		vector<storeColumn> columns;
+		unordered_map<string, size_t> columnIndices;
+		vector<string> extensionNames;
+		vector<vector<uint64_t>> extensionBits;
+		unordered_map<string, size_t> extensionIndices;
+		void clear();
+		void createSchema(const capsList& caps);
+		size_t addReport(const reportData& report);
+		int importFiles(const vector<string>& fileNames, int threadCount = 0);
+		bool select(const reportQuery& query, vector<uint64_t>& mask, string& error) const;
+		vector<size_t> query(const string& query, string& error) const;
+		size_t memoryUsage() const;
+		static size_t countRows(const vector<uint64_t>& mask);
+		static vector<size_t> maskToRows(const vector<uint64_t>& mask);
+	};
+
+}
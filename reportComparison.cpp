@@ -0,0 +1,222 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Side by side comparison of multiple reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportComparison.h"
+#include <algorithm>
+#include <cctype>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	reportComparison::reportComparison()
+	{
+		getEnumName = [](GLint glenum) { return to_string(glenum); };
+		clear();
+	}
+
+	void reportComparison::clear()
+	{
+		reference.clear();
+		formatReference.clear();
+		for (auto& indices : rowIndices) {
+			indices.clear();
+		}
+		for (auto& rows : sectionRows) {
+			rows.clear();
+		}
+		valueIndices.clear();
+		titles.clear();
+		rowSections.clear();
+		rowNames.clear();
+		rowDiffers.clear();
+		values.assign(1, "");
+		columns.clear();
+	}
+
+	/// <summary>
+	/// Returns the row for a key, rows are added on first use
+	/// </summary>
+	/// <param name="key">Name used by the diff (compressed formats by value)</param>
+	/// <param name="name">Name shown in the table</param>
+	uint32_t reportComparison::addRow(diffSection section, const string& key, const string& name)
+	{
+		auto rowIndex = rowIndices[section].find(key);
+		if (rowIndex != rowIndices[section].end()) {
+			return rowIndex->second;
+		}
+		uint32_t row = (uint32_t)rowNames.size();
+		rowIndices[section].emplace(key, row);
+		rowSections.push_back(section);
+		rowNames.push_back(name);
+		rowDiffers.push_back(0);
+		sectionRows[section].push_back(row);
+		return row;
+	}
+
+	uint32_t reportComparison::addValue(const string& value)
+	{
+		if (value.empty()) {
+			return 0;
+		}
+		auto valueIndex = valueIndices.find(value);
+		if (valueIndex != valueIndices.end()) {
+			return valueIndex->second;
+		}
+		uint32_t index = (uint32_t)values.size();
+		valueIndices.emplace(value, index);
+		values.push_back(value);
+		return index;
+	}
+
+	/// <summary>
+	/// Flags the rows of all diff entries
+	/// </summary>
+	void reportComparison::markDifferences(const reportDiff& diff)
+	{
+		for (auto& entry : diff.entries) {
+			auto rowIndex = rowIndices[entry.section].find(entry.name);
+			if (rowIndex != rowIndices[entry.section].end()) {
+				rowDiffers[rowIndex->second] = 1;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Adds a report as a new column
+	/// </summary>
+	/// <param name="title">Column caption (e.g. renderer and driver version)</param>
+	void reportComparison::addReport(const reportData& report, const string& title)
+	{
+		size_t column = columns.size();
+		titles.push_back(title);
+		columns.push_back(vector<uint32_t>(rowNames.size(), 0));
+		vector<uint32_t>& cells = columns.back();
+		auto setCell = [this, &cells](uint32_t row, uint32_t value) {
+			if (row >= cells.size()) {
+				cells.resize(row + 1, 0);
+			}
+			cells[row] = value;
+		};
+
+		for (auto& cap : report.caps) {
+			setCell(addRow(diffSectionCaps, cap.first, cap.first), addValue(cap.second));
+		}
+		uint32_t supported = addValue("true");
+		for (auto& extension : report.extensions) {
+			setCell(addRow(diffSectionExtensions, extension, extension), supported);
+		}
+		for (auto& format : report.compressedFormats) {
+			setCell(addRow(diffSectionCompressedFormats, to_string(format), getEnumName(format)), supported);
+		}
+		for (auto& internalFormat : report.internalFormats) {
+			setCell(addRow(diffSectionInternalFormats, internalFormat.first, internalFormat.first), addValue(internalFormat.second));
+		}
+		// Rows added by this report are not present in the other reports
+		for (auto& otherCells : columns) {
+			otherCells.resize(rowNames.size(), 0);
+		}
+
+		if (column == 0) {
+			reference = report;
+		}
+		else {
+			reportDiff diff;
+			diff.compare(reference, report);
+			markDifferences(diff);
+		}
+		// The diff skips internal formats if one of the reports has none (e.g. database reports), so those are compared against the first report that has them
+		if ((report.hasInternalFormats) && (!reference.hasInternalFormats)) {
+			if (formatReference.hasInternalFormats) {
+				reportDiff diff;
+				diff.compare(formatReference, report);
+				markDifferences(diff);
+			}
+			else {
+				formatReference = report;
+			}
+		}
+	}
+
+	size_t reportComparison::rowCount() const
+	{
+		return rowNames.size();
+	}
+
+	size_t reportComparison::columnCount() const
+	{
+		return columns.size();
+	}
+
+	size_t reportComparison::differenceCount() const
+	{
+		return count(rowDiffers.begin(), rowDiffers.end(), 1);
+	}
+
+	const string& reportComparison::value(size_t row, size_t column) const
+	{
+		return values[columns[column][row]];
+	}
+
+	/// <summary>
+	/// Checks if a cell differs from the same row of the first report
+	/// </summary>
+	bool reportComparison::valueDiffers(size_t row, size_t column) const
+	{
+		return (rowDiffers[row] != 0) && (columns[column][row] != columns[0][row]);
+	}
+
+	bool containsText(const string& str, const string& text)
+	{
+		auto position = search(str.begin(), str.end(), text.begin(), text.end(), [](char a, char b) {
+			return tolower((unsigned char)a) == tolower((unsigned char)b);
+		});
+		return position != str.end();
+	}
+
+	/// <summary>
+	/// Returns the rows to display, ordered by section
+	/// </summary>
+	/// <param name="text">Case insensitive part of the row name, all rows if empty</param>
+	/// <param name="section">Section to show (diffSection), -1 for all sections</param>
+	/// <param name="differencesOnly">Only rows with different values</param>
+	vector<uint32_t> reportComparison::filter(const string& text, int section, bool differencesOnly) const
+	{
+		vector<uint32_t> rows;
+		for (int s = 0; s < 4; s++) {
+			if ((section > -1) && (section != s)) {
+				continue;
+			}
+			for (auto row : sectionRows[s]) {
+				if ((differencesOnly) && (rowDiffers[row] == 0)) {
+					continue;
+				}
+				if ((!text.empty()) && (!containsText(rowNames[row], text))) {
+					continue;
+				}
+				rows.push_back(row);
+			}
+		}
+		return rows;
+	}
+
+}
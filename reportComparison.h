@@ -0,0 +1,78 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Side by side comparison of multiple reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <GL/glew.h>
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Merged table of any number of reports with one row per cap, extension, compressed format and internal format value
+	/// Every report is a column of indices into a shared value table, so columns of 20 reports with full internal format data stay small
+	/// Rows are flagged as different with the structured diff of every report against the first report
+	/// </summary>
+	class reportComparison
+	{
+	private:
+		// First report, and first report with internal format information (if the first report has none)
+		reportData reference;
+		reportData formatReference;
+		unordered_map<string, uint32_t> rowIndices[4];
+		unordered_map<string, uint32_t> valueIndices;
+		uint32_t addRow(diffSection section, const string& key, const string& name);
+		uint32_t addValue(const string& value);
+		void markDifferences(const reportDiff& diff);
+	public:
+		// Column captions
+		vector<string> titles;
+		vector<diffSection> rowSections;
+		vector<string> rowNames;
+		vector<uint8_t> rowDiffers;
+		// Rows of every section in the order they were added
+		vector<uint32_t> sectionRows[4];
+		// Distinct values, index 0 is used for values not present in a report
+		vector<string> values;
+		// One value index per row for every report
+		vector<vector<uint32_t>> columns;
+		// Used to show compressed formats by name
+		function<string(GLint)> getEnumName;
+		reportComparison();
+		void clear();
+		void addReport(const reportData& report, const string& title);
+		size_t rowCount() const;
+		size_t columnCount() const;
+		size_t differenceCount() const;
+		const string& value(size_t row, size_t column) const;
+		bool valueDiffers(size_t row, size_t column) const;
+		vector<uint32_t> filter(const string& text, int section, bool differencesOnly) const;
+	};
+
+}
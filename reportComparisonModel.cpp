@@ -0,0 +1,134 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Table model for the report comparison
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportComparisonModel.h"
+#include <QColor>
+#include <QFont>
+
+namespace capsViewer {
+
+	reportComparisonModel::reportComparisonModel(QObject *parent) : QAbstractTableModel(parent)
+	{
+	}
+
+	void reportComparisonModel::setComparison(const reportComparison* comparison)
+	{
+		beginResetModel();
+		this->comparison = comparison;
+		visibleRows = comparison->filter("", -1, false);
+		endResetModel();
+	}
+
+	/// <summary>
+	/// Selects the rows to display
+	/// </summary>
+	/// <param name="section">Section to show (diffSection), -1 for all sections</param>
+	void reportComparisonModel::setFilter(const QString& text, int section, bool differencesOnly)
+	{
+		if (comparison == nullptr) {
+			return;
+		}
+		beginResetModel();
+		visibleRows = comparison->filter(text.toStdString(), section, differencesOnly);
+		endResetModel();
+	}
+
+	int reportComparisonModel::rowCount(const QModelIndex &parent) const
+	{
+		return (parent.isValid()) ? 0 : (int)visibleRows.size();
+	}
+
+	int reportComparisonModel::columnCount(const QModelIndex &parent) const
+	{
+		return ((parent.isValid()) || (comparison == nullptr)) ? 0 : (int)comparison->columnCount() + 1;
+	}
+
+	QVariant reportComparisonModel::data(const QModelIndex &index, int role) const
+	{
+		if ((!index.isValid()) || (comparison == nullptr) || (index.row() >= (int)visibleRows.size())) {
+			return QVariant();
+		}
+		uint32_t row = visibleRows[index.row()];
+		diffSection section = comparison->rowSections[row];
+		// Extensions and compressed formats only list supported entries
+		bool isSet = (section == diffSectionExtensions) || (section == diffSectionCompressedFormats);
+		size_t column = (size_t)index.column() - 1;
+
+		switch (role) {
+		case Qt::DisplayRole:
+		{
+			if (index.column() == 0) {
+				return QString::fromStdString(comparison->rowNames[row]);
+			}
+			const string& value = comparison->value(row, column);
+			if (value.empty()) {
+				return isSet ? "false" : "n/a";
+			}
+			return QString::fromStdString(value);
+		}
+		case Qt::ToolTipRole:
+			if (index.column() == 0) {
+				return QString::fromStdString(reportDiff::sectionName(section) + " " + comparison->rowNames[row]);
+			}
+			return QString::fromStdString(comparison->titles[column]);
+		case Qt::BackgroundRole:
+			if (comparison->rowDiffers[row] != 0) {
+				return QColor::fromRgb(255, 243, 205);
+			}
+			break;
+		case Qt::ForegroundRole:
+			if (index.column() == 0) {
+				break;
+			}
+			if (comparison->value(row, column).empty()) {
+				return isSet ? QColor(Qt::red) : QColor::fromRgb(100, 100, 100);
+			}
+			if ((column > 0) && (comparison->valueDiffers(row, column))) {
+				return QColor::fromRgb(0, 0, 255);
+			}
+			break;
+		case Qt::FontRole:
+			if ((index.column() > 1) && (comparison->valueDiffers(row, column))) {
+				QFont font;
+				font.setBold(true);
+				return font;
+			}
+			break;
+		}
+		return QVariant();
+	}
+
+	QVariant reportComparisonModel::headerData(int section, Qt::Orientation orientation, int role) const
+	{
+		if ((orientation != Qt::Horizontal) || (comparison == nullptr)) {
+			return QAbstractTableModel::headerData(section, orientation, role);
+		}
+		if (role == Qt::DisplayRole) {
+			return (section == 0) ? QString("Name") : QString::fromStdString(comparison->titles[section - 1]);
+		}
+		if ((role == Qt::ToolTipRole) && (section > 0)) {
+			return QString::fromStdString(comparison->titles[section - 1]);
+		}
+		return QVariant();
+	}
+
+}
@@ -0,0 +1,52 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Table model for the report comparison
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <vector>
+#include <cstdint>
+#include "reportComparison.h"
+
+namespace capsViewer {
+
+	/// <summary>
+	/// Exposes a report comparison as a table with the row name in the first column and one column per report
+	/// Cells are read from the comparison on demand and filtering only rebuilds the list of visible rows,
+	/// so unlike a QStandardItemModel with a proxy filter no items are created per cell
+	/// </summary>
+	class reportComparisonModel : public QAbstractTableModel
+	{
+	private:
+		const reportComparison* comparison = nullptr;
+		std::vector<uint32_t> visibleRows;
+	public:
+		reportComparisonModel(QObject *parent = NULL);
+		void setComparison(const reportComparison* comparison);
+		void setFilter(const QString& text, int section, bool differencesOnly);
+		int rowCount(const QModelIndex &parent = QModelIndex()) const;
+		int columnCount(const QModelIndex &parent = QModelIndex()) const;
+		QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+		QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	};
+
+}
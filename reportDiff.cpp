@@ -0,0 +1,541 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Structured comparison of two reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportDiff.h"
+#include "glCapsViewerCore.h"
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <unordered_map>
+#include <unordered_set>
+#include <sstream>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void reportData::clear()
+	{
+		description = "";
+		operatingSystem = "";
+		contextType = "";
+		date = "";
+		submitter = "";
+		comment = "";
+		caps.clear();
+		extensions.clear();
+		compressedFormats.clear();
+		internalFormats.clear();
+		hasInternalFormats = false;
+		performance.clear();
+		capIndices.clear();
+		indexedCaps = 0;
+	}
+
+	/// <summary>
+	/// Reads the report data from a capture
+	/// </summary>
+	void reportData::fromCore(glCapsViewerCore& core)
+	{
+		clear();
+		description = core.description;
+		operatingSystem = core.implementation["Operating system"];
+		contextType = core.contextType;
+		submitter = core.submitter;
+		comment = core.comment;
+		for (auto& group : core.capgroups) {
+			for (auto& cap : group.capabilities) {
+				caps.push_back(make_pair(cap.first, cap.second));
+			}
+		}
+		extensions = core.extensions;
+		extensions.insert(extensions.end(), core.osextensions.begin(), core.osextensions.end());
+		compressedFormats = core.compressedFormats;
+		hasInternalFormats = !core.internalFormatTargets.empty();
+		for (auto& formatTarget : core.internalFormatTargets) {
+			string targetName = core.getEnumName(formatTarget.target);
+			for (auto& textureFormat : formatTarget.textureFormats) {
+				string key = targetName + "/" + core.getEnumName(textureFormat.textureFormat) + "/";
+				internalFormats.push_back(make_pair(key + "supported", textureFormat.supported ? "true" : "false"));
+				for (auto& formatInfoValue : textureFormat.formatInfoValues) {
+					internalFormats.push_back(make_pair(key + formatInfoValue.infoString, to_string(formatInfoValue.infoValue)));
+				}
+			}
+		}
+		for (auto& value : core.performanceProbes.values) {
+			performance.push_back(make_pair(value.probe + "/" + value.name + "/" + value.metric, capsViewer::glPerformanceProbes::formatValue(value.value)));
+		}
+		indexCaps();
+	}
+
+	/// <summary>
+	/// Reads the report data from an exported report (glCapsViewerCore::reportToXml) or a database report (gl_getreport.php)
+	/// </summary>
+	/// <param name="xml">Report xml in either layout</param>
+	/// <returns>false if the xml could not be parsed</returns>
+	bool reportData::fromXml(const string& xml)
+	{
+		clear();
+		QXmlStreamReader xmlReader(QByteArray(xml.c_str(), (int)xml.size()));
+		string targetName;
+		string formatKey;
+		string probeName;
+		string caseKey;
+		while (!xmlReader.atEnd()) {
+			xmlReader.readNext();
+			if (!xmlReader.isStartElement()) {
+				continue;
+			}
+			if (xmlReader.name() == "cap") {
+				// Exported reports store the value in a child element, database reports as the element text
+				string id = xmlReader.attributes().value("id").toString().toStdString();
+				string value = xmlReader.readElementText(QXmlStreamReader::IncludeChildElements).trimmed().toStdString();
+				caps.push_back(make_pair(id, value));
+			}
+			else if (xmlReader.name() == "extension") {
+				extensions.push_back(xmlReader.readElementText().toStdString());
+			}
+			else if (xmlReader.name() == "compressedtextureformat") {
+				compressedFormats.push_back(xmlReader.readElementText().toInt());
+			}
+			else if (xmlReader.name() == "description") {
+				description = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "os") {
+				operatingSystem = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "contexttype") {
+				contextType = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "date") {
+				date = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "submitter") {
+				submitter = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "comment") {
+				comment = xmlReader.readElementText().toStdString();
+			}
+			else if (xmlReader.name() == "internalformatinformation") {
+				hasInternalFormats = true;
+			}
+			else if (xmlReader.name() == "target") {
+				targetName = xmlReader.attributes().value("name").toString().toStdString();
+			}
+			else if (xmlReader.name() == "format") {
+				QXmlStreamAttributes attributes = xmlReader.attributes();
+				formatKey = targetName + "/" + attributes.value("name").toString().toStdString() + "/";
+				internalFormats.push_back(make_pair(formatKey + "supported", attributes.value("supported").toString().toStdString()));
+			}
+			else if (xmlReader.name() == "probe") {
+				probeName = xmlReader.attributes().value("name").toString().toStdString();
+			}
+			else if (xmlReader.name() == "case") {
+				caseKey = probeName + "/" + xmlReader.attributes().value("name").toString().toStdString() + "/";
+			}
+			else if ((xmlReader.name() == "value") && (!caseKey.empty())) {
+				string key = caseKey + xmlReader.attributes().value("name").toString().toStdString();
+				performance.push_back(make_pair(key, xmlReader.readElementText().toStdString()));
+			}
+			else if ((xmlReader.name() == "value") && (!formatKey.empty())) {
+				string key = formatKey + xmlReader.attributes().value("name").toString().toStdString();
+				internalFormats.push_back(make_pair(key, xmlReader.readElementText().toStdString()));
+			}
+		}
+		indexCaps();
+		return (!xmlReader.hasError());
+	}
+
+	/// <summary>
+	/// Writes the report in the layout of exported reports (glCapsViewerCore::reportToXml)
+	/// Cap values are written as read (including "n/a" and empty values), internal formats only if the report has internal format information
+	/// </summary>
+	string reportData::toXml() const
+	{
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.setAutoFormatting(true);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("implementationinfo");
+		xmlWriter.writeTextElement("fileversion", "4.0");
+		xmlWriter.writeTextElement("description", QString::fromStdString(description));
+		xmlWriter.writeTextElement("contexttype", QString::fromStdString(contextType));
+		xmlWriter.writeTextElement("date", QString::fromStdString(date));
+		xmlWriter.writeTextElement("submitter", QString::fromStdString(submitter));
+		xmlWriter.writeTextElement("os", QString::fromStdString(operatingSystem));
+		xmlWriter.writeTextElement("comment", QString::fromStdString(comment));
+
+		xmlWriter.writeStartElement("extensions");
+		for (auto& extension : extensions) {
+			xmlWriter.writeTextElement("extension", QString::fromStdString(extension));
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("caps");
+		for (auto& cap : caps) {
+			xmlWriter.writeStartElement("cap");
+			xmlWriter.writeAttribute("id", QString::fromStdString(cap.first));
+			xmlWriter.writeTextElement("value", QString::fromStdString(cap.second));
+			xmlWriter.writeEndElement();
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("compressedtextureformats");
+		for (auto& compressedFormat : compressedFormats) {
+			xmlWriter.writeTextElement("compressedtextureformat", QString::number(compressedFormat));
+		}
+		xmlWriter.writeEndElement();
+
+		if (hasInternalFormats) {
+			// Keys are "target/format/info", consecutive keys of the same target and format are written as one element
+			xmlWriter.writeStartElement("internalformatinformation");
+			string currentTarget;
+			string currentFormat;
+			for (auto& internalFormat : internalFormats) {
+				size_t targetEnd = internalFormat.first.find('/');
+				size_t formatEnd = internalFormat.first.find('/', targetEnd + 1);
+				if ((targetEnd == string::npos) || (formatEnd == string::npos)) {
+					continue;
+				}
+				string target = internalFormat.first.substr(0, targetEnd);
+				string format = internalFormat.first.substr(targetEnd + 1, formatEnd - targetEnd - 1);
+				string info = internalFormat.first.substr(formatEnd + 1);
+				if ((target != currentTarget) || (format != currentFormat)) {
+					if (!currentFormat.empty()) {
+						xmlWriter.writeEndElement(); // format
+					}
+					if (target != currentTarget) {
+						if (!currentTarget.empty()) {
+							xmlWriter.writeEndElement(); // target
+						}
+						xmlWriter.writeStartElement("target");
+						xmlWriter.writeAttribute("name", QString::fromStdString(target));
+						currentTarget = target;
+					}
+					xmlWriter.writeStartElement("format");
+					xmlWriter.writeAttribute("name", QString::fromStdString(format));
+					currentFormat = format;
+				}
+				if (info == "supported") {
+					xmlWriter.writeAttribute("supported", QString::fromStdString(internalFormat.second));
+				}
+				else {
+					xmlWriter.writeStartElement("value");
+					xmlWriter.writeAttribute("name", QString::fromStdString(info));
+					xmlWriter.writeCharacters(QString::fromStdString(internalFormat.second));
+					xmlWriter.writeEndElement();
+				}
+			}
+			if (!currentFormat.empty()) {
+				xmlWriter.writeEndElement(); // format
+			}
+			if (!currentTarget.empty()) {
+				xmlWriter.writeEndElement(); // target
+			}
+			xmlWriter.writeEndElement();
+		}
+
+		if (!performance.empty()) {
+			// Keys are "probe/case/metric", case names don't contain slashes
+			xmlWriter.writeStartElement("performance");
+			string currentProbe;
+			string currentCase;
+			for (auto& value : performance) {
+				size_t probeEnd = value.first.find('/');
+				size_t caseEnd = value.first.rfind('/');
+				if ((probeEnd == string::npos) || (caseEnd <= probeEnd)) {
+					continue;
+				}
+				string probe = value.first.substr(0, probeEnd);
+				string caseName = value.first.substr(probeEnd + 1, caseEnd - probeEnd - 1);
+				if ((probe != currentProbe) || (caseName != currentCase)) {
+					if (!currentCase.empty()) {
+						xmlWriter.writeEndElement(); // case
+					}
+					if (probe != currentProbe) {
+						if (!currentProbe.empty()) {
+							xmlWriter.writeEndElement(); // probe
+						}
+						xmlWriter.writeStartElement("probe");
+						xmlWriter.writeAttribute("name", QString::fromStdString(probe));
+						currentProbe = probe;
+					}
+					xmlWriter.writeStartElement("case");
+					xmlWriter.writeAttribute("name", QString::fromStdString(caseName));
+					currentCase = caseName;
+				}
+				xmlWriter.writeStartElement("value");
+				xmlWriter.writeAttribute("name", QString::fromStdString(value.first.substr(caseEnd + 1)));
+				xmlWriter.writeCharacters(QString::fromStdString(value.second));
+				xmlWriter.writeEndElement();
+			}
+			if (!currentCase.empty()) {
+				xmlWriter.writeEndElement(); // case
+				xmlWriter.writeEndElement(); // probe
+			}
+			xmlWriter.writeEndElement();
+		}
+
+		xmlWriter.writeEndElement(); // root
+		return xmlStr.toStdString();
+	}
+
+	/// <summary>
+	/// Indexes the caps by name for getCap, has to be called again if caps are added by hand
+	/// </summary>
+	void reportData::indexCaps()
+	{
+		for (; indexedCaps < caps.size(); indexedCaps++) {
+			capIndices.emplace(caps[indexedCaps].first, indexedCaps);
+		}
+	}
+
+	/// <summary>
+	/// Returns the value of a cap, empty if the cap is not present
+	/// </summary>
+	string reportData::getCap(const string& name) const
+	{
+		if (indexedCaps == caps.size()) {
+			auto capIndex = capIndices.find(name);
+			return (capIndex != capIndices.end()) ? caps[capIndex->second].second : "";
+		}
+		for (auto& cap : caps) {
+			if (cap.first == name) {
+				return cap.second;
+			}
+		}
+		return "";
+	}
+
+	/// <summary>
+	/// Checks if a cap value has been reported, i.e. is neither empty nor "n/a"
+	/// </summary>
+	bool reportData::isAvailable(const string& value)
+	{
+		return (!value.empty()) && (value != "n/a");
+	}
+
+	string entryName(const string& value)
+	{
+		return value;
+	}
+
+	string entryName(GLint value)
+	{
+		return to_string(value);
+	}
+
+	/// <summary>
+	/// Hash join of two name/value lists
+	/// </summary>
+	void compareValues(vector<reportDiffEntry>& entries, diffSection section, const vector<pair<string, string>>& base, const vector<pair<string, string>>& other)
+	{
+		unordered_map<string, size_t> baseIndices;
+		baseIndices.reserve(base.size());
+		for (size_t i = 0; i < base.size(); i++) {
+			baseIndices.emplace(base[i].first, i);
+		}
+		vector<bool> matched(base.size(), false);
+
+		for (auto& value : other) {
+			auto baseIndex = baseIndices.find(value.first);
+			if (baseIndex == baseIndices.end()) {
+				if (!value.second.empty()) {
+					entries.push_back({ section, diffAdded, value.first, "", value.second });
+				}
+				continue;
+			}
+			matched[baseIndex->second] = true;
+			const string& baseValue = base[baseIndex->second].second;
+			if (baseValue == value.second) {
+				continue;
+			}
+			diffType type = (baseValue.empty()) ? diffMissing : (value.second.empty()) ? diffRemoved : diffChanged;
+			entries.push_back({ section, type, value.first, baseValue, value.second });
+		}
+
+		for (size_t i = 0; i < base.size(); i++) {
+			if ((!matched[i]) && (!base[i].second.empty())) {
+				entries.push_back({ section, diffRemoved, base[i].first, base[i].second, "" });
+			}
+		}
+	}
+
+	/// <summary>
+	/// Removes duplicates (e.g. extensions listed twice by a driver), keeping the order of the first occurrences
+	/// </summary>
+	/// <param name="set">Receives the distinct values</param>
+	template<typename T> vector<T> uniqueValues(const vector<T>& values, unordered_set<T>& set)
+	{
+		vector<T> unique;
+		unique.reserve(values.size());
+		set.reserve(values.size());
+		for (auto& value : values) {
+			if (set.insert(value).second) {
+				unique.push_back(value);
+			}
+		}
+		return unique;
+	}
+
+	/// <summary>
+	/// Hash join of two sets (extensions, compressed formats), duplicates are removed first so every value is listed once
+	/// </summary>
+	template<typename T> void compareSets(vector<reportDiffEntry>& entries, diffSection section, const vector<T>& base, const vector<T>& other)
+	{
+		unordered_set<T> baseSet;
+		unordered_set<T> otherSet;
+		vector<T> uniqueBase = uniqueValues(base, baseSet);
+		vector<T> uniqueOther = uniqueValues(other, otherSet);
+		for (auto& value : uniqueOther) {
+			if (baseSet.count(value) == 0) {
+				entries.push_back({ section, diffAdded, entryName(value), "", "" });
+			}
+		}
+		for (auto& value : uniqueBase) {
+			if (otherSet.count(value) == 0) {
+				entries.push_back({ section, diffRemoved, entryName(value), "", "" });
+			}
+		}
+	}
+
+	/// <summary>
+	/// Compares two reports
+	/// </summary>
+	/// <param name="base">Report to compare against (e.g. the database report)</param>
+	/// <param name="other">Report compared to the base report (e.g. the local capture)</param>
+	void reportDiff::compare(const reportData& base, const reportData& other)
+	{
+		entries.clear();
+		compareValues(entries, diffSectionCaps, base.caps, other.caps);
+		compareSets(entries, diffSectionExtensions, base.extensions, other.extensions);
+		compareSets(entries, diffSectionCompressedFormats, base.compressedFormats, other.compressedFormats);
+		// Reports without internal format information (e.g. all database reports) are not compared against the matrix
+		if ((base.hasInternalFormats) && (other.hasInternalFormats)) {
+			compareValues(entries, diffSectionInternalFormats, base.internalFormats, other.internalFormats);
+		}
+	}
+
+	int reportDiff::count(diffSection section, diffType type) const
+	{
+		int count = 0;
+		for (auto& entry : entries) {
+			if ((entry.section == section) && (entry.type == type)) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	vector<const reportDiffEntry*> reportDiff::select(diffSection section, diffType type) const
+	{
+		vector<const reportDiffEntry*> selection;
+		for (auto& entry : entries) {
+			if ((entry.section == section) && (entry.type == type)) {
+				selection.push_back(&entry);
+			}
+		}
+		return selection;
+	}
+
+	/// <summary>
+	/// Checks if the entry can be used to update the base report (database) with values from the other report (local capture)
+	/// </summary>
+	/// <returns>true for caps missing in the base report that are available in the other report, and compressed or internal formats only present in the other report</returns>
+	bool reportDiff::isUpdate(const reportDiffEntry& entry)
+	{
+		switch (entry.section) {
+		case diffSectionCaps:
+			return (entry.type == diffMissing) && (reportData::isAvailable(entry.otherValue));
+		case diffSectionCompressedFormats:
+			return (entry.type == diffAdded);
+		case diffSectionInternalFormats:
+			return (entry.type == diffAdded) || (entry.type == diffMissing);
+		default:
+			return false;
+		}
+	}
+
+	vector<const reportDiffEntry*> reportDiff::updates() const
+	{
+		vector<const reportDiffEntry*> selection;
+		for (auto& entry : entries) {
+			if (isUpdate(entry)) {
+				selection.push_back(&entry);
+			}
+		}
+		return selection;
+	}
+
+	bool reportDiff::canUpdate() const
+	{
+		for (auto& entry : entries) {
+			if (isUpdate(entry)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Returns a line per difference and a summary, e.g. "~ cap GL_MAX_TEXTURE_SIZE : 8192 -> 16384"
+	/// </summary>
+	/// <param name="getEnumName">Function used to resolve compressed format names</param>
+	string reportDiff::toText(function<string(GLint)> getEnumName) const
+	{
+		const char symbols[] = { '+', '-', '~', '?' };
+		int typeCounts[4] = {};
+		stringstream ss;
+		for (auto& entry : entries) {
+			typeCounts[entry.type]++;
+			string name = (entry.section == diffSectionCompressedFormats) ? getEnumName(atoi(entry.name.c_str())) : entry.name;
+			ss << symbols[entry.type] << " " << sectionName(entry.section) << " " << name;
+			switch (entry.type) {
+			case diffAdded:
+			case diffMissing:
+				ss << (entry.otherValue.empty() ? "" : " : " + entry.otherValue);
+				break;
+			case diffRemoved:
+				ss << (entry.baseValue.empty() ? "" : " : " + entry.baseValue);
+				break;
+			case diffChanged:
+				ss << " : " << entry.baseValue << " -> " << entry.otherValue;
+				break;
+			}
+			ss << "\n";
+		}
+		ss << typeCounts[diffAdded] << " added, " << typeCounts[diffRemoved] << " removed, " << typeCounts[diffChanged] << " changed, " << typeCounts[diffMissing] << " missing\n";
+		return ss.str();
+	}
+
+	string reportDiff::sectionName(diffSection section)
+	{
+		const char* names[] = { "cap", "extension", "compressedformat", "internalformat" };
+		return names[section];
+	}
+
+	string reportDiff::typeName(diffType type)
+	{
+		const char* names[] = { "added", "removed", "changed", "missing" };
+		return names[type];
+	}
+
+}
@@ -0,0 +1,110 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Structured comparison of two reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <GL/glew.h>
+
+class glCapsViewerCore;
+
+namespace capsViewer {
+
+	using namespace std;
+
+	enum diffSection { diffSectionCaps, diffSectionExtensions, diffSectionCompressedFormats, diffSectionInternalFormats };
+
+	enum diffType {
+		// Only present in the other report
+		diffAdded,
+		// Only present in the base report
+		diffRemoved,
+		// Present in both reports with different values
+		diffChanged,
+		// Present in both reports, but without a value in the base report (i.e. can be updated if the value is available in the other report)
+		diffMissing
+	};
+
+	/// <summary>
+	/// Flattened report contents, read from a capture, an exported report or a database report
+	/// </summary>
+	class reportData
+	{
+	private:
+		// Position of the first cap with a name, only used by getCap while it covers all caps
+		unordered_map<string, size_t> capIndices;
+		size_t indexedCaps = 0;
+	public:
+		string description;
+		string operatingSystem;
+		// Submission info of exported reports (empty for database reports)
+		string contextType;
+		string date;
+		string submitter;
+		string comment;
+		// Caps in report order, unsupported caps have the value "n/a", caps without a value (e.g. not yet updated in the database) are empty
+		vector<pair<string, string>> caps;
+		vector<string> extensions;
+		vector<GLint> compressedFormats;
+		// Internal format matrix flattened to "target/format/info" keys
+		vector<pair<string, string>> internalFormats;
+		bool hasInternalFormats = false;
+		// Results of the optional performance probes flattened to "probe/case/metric" keys, not compared
+		vector<pair<string, string>> performance;
+		void clear();
+		void fromCore(glCapsViewerCore& core);
+		bool fromXml(const string& xml);
+		string toXml() const;
+		void indexCaps();
+		string getCap(const string& name) const;
+		static bool isAvailable(const string& value);
+	};
+
+	class reportDiffEntry
+	{
+	public:
+		diffSection section;
+		diffType type;
+		string name;
+		string baseValue;
+		string otherValue;
+	};
+
+	class reportDiff
+	{
+	public:
+		vector<reportDiffEntry> entries;
+		void compare(const reportData& base, const reportData& other);
+		int count(diffSection section, diffType type) const;
+		vector<const reportDiffEntry*> select(diffSection section, diffType type) const;
+		vector<const reportDiffEntry*> updates() const;
+		bool canUpdate() const;
+		string toText(function<string(GLint)> getEnumName) const;
+		static bool isUpdate(const reportDiffEntry& entry);
+		static string sectionName(diffSection section);
+		static string typeName(diffType type);
+	};
+
+}
@@ -0,0 +1,134 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Concurrent download of database reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportFetcher.h"
+#include "glCapsViewerHttp.h"
+#include "reportDiff.h"
+#include <QUrl>
+#include <QTimer>
+#include <QNetworkRequest>
+#include <fstream>
+#include <iterator>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <param name="cache">Local report cache, can be NULL to always fetch from the database</param>
+	reportFetcher::reportFetcher(reportCache* cache, QObject* parent) : QObject(parent)
+	{
+		this->cache = cache;
+	}
+
+	/// <summary>
+	/// Starts fetching the reports, finished is emitted once all reports have been fetched or failed
+	/// </summary>
+	void reportFetcher::fetch(const vector<int>& reportIds)
+	{
+		reports.clear();
+		failedReports.clear();
+		cacheHits = 0;
+		downloaded = 0;
+		queue.insert(queue.end(), reportIds.begin(), reportIds.end());
+		started = true;
+		// Deferred, so finished is never emitted before the caller had a chance to wait for it
+		QTimer::singleShot(0, this, SLOT(startNext()));
+	}
+
+	bool reportFetcher::idle()
+	{
+		return (!started) && (inFlight == 0) && (queue.empty());
+	}
+
+	bool reportFetcher::isPending(int reportId)
+	{
+		for (auto& request : pendingRequests) {
+			if (request.second == reportId) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void reportFetcher::startNext()
+	{
+		while ((!queue.empty()) && (inFlight < maxConcurrent)) {
+			int reportId = queue.front();
+			queue.pop_front();
+			// Ids queued again (e.g. duplicates in the list) are only fetched once
+			if ((reports.count(reportId) > 0) || (isPending(reportId))) {
+				continue;
+			}
+			if ((cache != NULL) && (cache->contains(reportId))) {
+				ifstream file(cache->fileName(reportId), ios::binary);
+				string xml((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+				if (!xml.empty()) {
+					reports[reportId] = xml;
+					cacheHits++;
+					emit reportFetched(reportId, true);
+					continue;
+				}
+			}
+			QUrl url(QString::fromStdString(glCapsViewerHttp::getBaseUrl() + "services/gl_getreport.php?reportId=" + to_string(reportId)));
+			QNetworkReply* reply = manager.get(QNetworkRequest(url));
+			pendingRequests[reply] = reportId;
+			inFlight++;
+			connect(reply, SIGNAL(finished()), this, SLOT(slotRequestFinished()));
+			QTimer::singleShot(requestTimeout, reply, SLOT(abort()));
+		}
+		if ((started) && (queue.empty()) && (inFlight == 0)) {
+			started = false;
+			emit finished();
+		}
+	}
+
+	void reportFetcher::slotRequestFinished()
+	{
+		QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+		reply->deleteLater();
+		auto request = pendingRequests.find(reply);
+		if (request == pendingRequests.end()) {
+			return;
+		}
+		int reportId = request->second;
+		pendingRequests.erase(request);
+		inFlight--;
+
+		QByteArray replyData = reply->readAll();
+		string xml(replyData.constData(), replyData.size());
+		// Error pages are returned with status 200 too, they must never end up in the cache
+		reportData report;
+		if ((reply->error() != QNetworkReply::NoError) || (xml.empty()) || (!report.fromXml(xml)) || ((report.caps.empty()) && (report.extensions.empty()))) {
+			failedReports.push_back(reportId);
+		}
+		else {
+			reports[reportId] = xml;
+			downloaded++;
+			if (cache != NULL) {
+				cache->store(reportId, xml);
+			}
+			emit reportFetched(reportId, false);
+		}
+		startNext();
+	}
+
+}
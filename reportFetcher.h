@@ -0,0 +1,75 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Concurrent download of database reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <QObject>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include "reportCache.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Fetches reports (gl_getreport.php) with a limited number of concurrent requests
+	/// Reports available in the local report cache are not requested again, fetched reports are added to the cache
+	/// </summary>
+	class reportFetcher : public QObject
+	{
+		Q_OBJECT
+	private:
+		QNetworkAccessManager manager;
+		reportCache* cache;
+		deque<int> queue;
+		map<QNetworkReply*, int> pendingRequests;
+		int inFlight = 0;
+		bool started = false;
+		bool isPending(int reportId);
+	private slots:
+		void startNext();
+		void slotRequestFinished();
+	signals:
+		void reportFetched(int reportId, bool cached);
+		void finished();
+	public:
+		// Maximum number of reports requested at the same time
+		int maxConcurrent = 4;
+		// Timeout for single requests in ms
+		int requestTimeout = 30000;
+		// Xml of all reports fetched since the last call to fetch
+		map<int, string> reports;
+		vector<int> failedReports;
+		int cacheHits = 0;
+		int downloaded = 0;
+		reportFetcher(reportCache* cache, QObject* parent = 0);
+		void fetch(const vector<int>& reportIds);
+		bool idle();
+	};
+
+}
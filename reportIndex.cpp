@@ -0,0 +1,294 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Inverted index over locally available reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportIndex.h"
+#include "workStealingPool.h"
+#include <QString>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <memory>
+#include <deque>
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	reportIndex::reportIndex()
+	{
+		getEnumName = [](GLint glenum) { return to_string(glenum); };
+	}
+
+	void reportIndex::clear()
+	{
+		reports.clear();
+		extensionPostings.clear();
+		formatPostings.clear();
+		capPostings.clear();
+		reportIds.clear();
+		reportFiles.clear();
+	}
+
+	bool reportIndex::contains(int reportId) const
+	{
+		return reportIds.count(reportId) > 0;
+	}
+
+	bool reportIndex::containsFile(const string& fileName) const
+	{
+		return reportFiles.count(fileName) > 0;
+	}
+
+	/// <summary>
+	/// Reports are numbered in insertion order, so appending keeps all posting lists sorted
+	/// </summary>
+	void addPosting(vector<uint32_t>& postings, uint32_t document)
+	{
+		if ((postings.empty()) || (postings.back() != document)) {
+			postings.push_back(document);
+		}
+	}
+
+	/// <summary>
+	/// Adds a report to the index
+	/// </summary>
+	/// <param name="reportId">Database id of the report, -1 for reports not fetched from the database</param>
+	/// <param name="fileName">File the report has been read from</param>
+	/// <returns>Index of the report, -1 if a report with the same database id (or for imported reports the same file) is already indexed</returns>
+	int reportIndex::addReport(const reportData& report, int reportId, const string& fileName)
+	{
+		if ((reportId > -1) && (contains(reportId))) {
+			return -1;
+		}
+		if ((reportId == -1) && (!fileName.empty()) && (containsFile(fileName))) {
+			return -1;
+		}
+		uint32_t document = (uint32_t)reports.size();
+		indexedReport info;
+		info.reportId = reportId;
+		info.description = report.description;
+		info.renderer = report.getCap("GL_RENDERER");
+		info.rendererText = QString::fromStdString(info.renderer);
+		info.version = report.getCap("GL_VERSION");
+		info.operatingSystem = report.operatingSystem;
+		info.fileName = fileName;
+		reports.push_back(info);
+		if (reportId > -1) {
+			reportIds[reportId] = document;
+		}
+		else if (!fileName.empty()) {
+			reportFiles[fileName] = document;
+		}
+
+		for (auto& extension : report.extensions) {
+			addPosting(extensionPostings[extension], document);
+		}
+		for (auto& format : report.compressedFormats) {
+			addPosting(formatPostings[getEnumName(format)], document);
+		}
+		for (auto& cap : report.caps) {
+			int64_t value;
+			if (reportQuery::parseValue(cap.second, value)) {
+				addPosting(capPostings[cap.first][value], document);
+			}
+		}
+		return (int)document;
+	}
+
+	/// <summary>
+	/// Parses report files on a work stealing pool and adds them to the index
+	/// Reports are added in the order of the file names, so report indices don't depend on thread timing
+	/// </summary>
+	/// <param name="getReportId">Returns the database id for a file name (e.g. reportCache::reportId)</param>
+	/// <param name="added">Optional, called for every report added in file order (from the worker threads, but never concurrently)</param>
+	/// <returns>Number of reports added</returns>
+	int reportIndex::importFiles(const vector<string>& fileNames, function<int(const string&)> getReportId, function<void(const reportData&, const indexedReport&)> added, int threadCount)
+	{
+		mutex indexLock;
+		int imported = 0;
+		// Parsed reports wait here until all files before them have been added, unreadable files stay empty
+		vector<unique_ptr<reportData>> parsed(fileNames.size());
+		vector<int> reportIds(fileNames.size(), -1);
+		vector<bool> finished(fileNames.size(), false);
+		size_t nextFile = 0;
+		workStealingPool pool(threadCount);
+		for (size_t i = 0; i < fileNames.size(); i++) {
+			pool.submit([this, i, &fileNames, &getReportId, &added, &indexLock, &imported, &parsed, &reportIds, &finished, &nextFile](int) {
+				ifstream file(fileNames[i], ios::binary);
+				string xml((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+				unique_ptr<reportData> report(new reportData());
+				if ((xml.empty()) || (!report->fromXml(xml)) || ((report->caps.empty()) && (report->extensions.empty()))) {
+					report.reset();
+				}
+				int reportId = (report) ? getReportId(fileNames[i]) : -1;
+				lock_guard<mutex> guard(indexLock);
+				parsed[i] = move(report);
+				reportIds[i] = reportId;
+				finished[i] = true;
+				for (; (nextFile < fileNames.size()) && (finished[nextFile]); nextFile++) {
+					if (!parsed[nextFile]) {
+						continue;
+					}
+					int document = addReport(*parsed[nextFile], reportIds[nextFile], fileNames[nextFile]);
+					if (document > -1) {
+						imported++;
+						if (added) {
+							added(*parsed[nextFile], reports[document]);
+						}
+					}
+					parsed[nextFile].reset();
+				}
+			});
+		}
+		pool.wait();
+		return imported;
+	}
+
+	/// <summary>
+	/// Intersection of two sorted posting lists, binary searches the larger list if the sizes differ a lot
+	/// </summary>
+	vector<uint32_t> intersectPostings(const vector<uint32_t>& smaller, const vector<uint32_t>& larger)
+	{
+		vector<uint32_t> result;
+		if (smaller.size() * 16 < larger.size()) {
+			auto position = larger.begin();
+			for (auto document : smaller) {
+				position = lower_bound(position, larger.end(), document);
+				if (position == larger.end()) {
+					break;
+				}
+				if (*position == document) {
+					result.push_back(document);
+				}
+			}
+		}
+		else {
+			set_intersection(smaller.begin(), smaller.end(), larger.begin(), larger.end(), back_inserter(result));
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Evaluates a query to the sorted indices of all matching reports
+	/// </summary>
+	/// <returns>false if the query contains terms the index can't evaluate</returns>
+	bool reportIndex::select(const reportQuery& query, vector<uint32_t>& result, string& error) const
+	{
+		static const vector<uint32_t> emptyPostings;
+		// Posting lists computed for comparison and renderer terms
+		deque<vector<uint32_t>> computedPostings;
+		vector<const vector<uint32_t>*> includes;
+		vector<const vector<uint32_t>*> excludes;
+
+		for (auto& term : query.terms) {
+			switch (term.type) {
+			case queryExtension:
+			case queryNoExtension:
+			{
+				auto postings = extensionPostings.find(term.name);
+				const vector<uint32_t>* list = (postings != extensionPostings.end()) ? &postings->second : &emptyPostings;
+				if (term.type == queryExtension) {
+					includes.push_back(list);
+				}
+				else {
+					excludes.push_back(list);
+				}
+				break;
+			}
+			case queryFormat:
+			{
+				// Formats can also be given by value (format:0x83F3)
+				int64_t value;
+				auto postings = formatPostings.find((reportQuery::parseValue(term.name, value)) ? getEnumName((GLint)value) : term.name);
+				includes.push_back((postings != formatPostings.end()) ? &postings->second : &emptyPostings);
+				break;
+			}
+			case queryCompare:
+			{
+				computedPostings.push_back(vector<uint32_t>());
+				vector<uint32_t>& matches = computedPostings.back();
+				auto cap = capPostings.find(term.name);
+				if (cap != capPostings.end()) {
+					for (auto& value : cap->second) {
+						if (reportQuery::compare(value.first, term.op, term.value)) {
+							matches.insert(matches.end(), value.second.begin(), value.second.end());
+						}
+					}
+					sort(matches.begin(), matches.end());
+				}
+				includes.push_back(&matches);
+				break;
+			}
+			case queryRenderer:
+			{
+				computedPostings.push_back(vector<uint32_t>());
+				vector<uint32_t>& matches = computedPostings.back();
+				QString text = QString::fromStdString(term.name);
+				for (uint32_t document = 0; document < reports.size(); document++) {
+					if (reports[document].rendererText.contains(text, Qt::CaseInsensitive)) {
+						matches.push_back(document);
+					}
+				}
+				includes.push_back(&matches);
+				break;
+			}
+			default:
+				error = "Unsupported query term " + term.name;
+				return false;
+			}
+		}
+
+		if (includes.empty()) {
+			result.resize(reports.size());
+			for (uint32_t document = 0; document < reports.size(); document++) {
+				result[document] = document;
+			}
+		}
+		else {
+			sort(includes.begin(), includes.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+			result = *includes[0];
+			for (size_t i = 1; (i < includes.size()) && (!result.empty()); i++) {
+				result = intersectPostings(result, *includes[i]);
+			}
+		}
+		for (auto exclude : excludes) {
+			vector<uint32_t> remaining;
+			set_difference(result.begin(), result.end(), exclude->begin(), exclude->end(), back_inserter(remaining));
+			result.swap(remaining);
+		}
+		return true;
+	}
+
+	vector<uint32_t> reportIndex::query(const string& query, string& error) const
+	{
+		reportQuery parsedQuery;
+		vector<uint32_t> result;
+		if (!parsedQuery.parse(query)) {
+			error = parsedQuery.error;
+			return result;
+		}
+		select(parsedQuery, result, error);
+		return result;
+	}
+
+}
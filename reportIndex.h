@@ -0,0 +1,82 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Inverted index over locally available reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <QString>
+#include <GL/glew.h>
+#include "reportDiff.h"
+#include "reportQuery.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class indexedReport
+	{
+	public:
+		// Database id, -1 for imported reports
+		int reportId = -1;
+		string description;
+		string renderer;
+		// Renderer converted once when the report is added, for renderer: query terms
+		QString rendererText;
+		string version;
+		string operatingSystem;
+		// Report file in the local cache, empty if the report was added from memory
+		string fileName;
+	};
+
+	/// <summary>
+	/// Maps extensions, compressed formats and numeric cap values to sorted posting lists of report indices
+	/// Queries are evaluated by intersecting the posting lists of all terms, smallest first
+	/// </summary>
+	class reportIndex
+	{
+	public:
+		vector<indexedReport> reports;
+		unordered_map<string, vector<uint32_t>> extensionPostings;
+		unordered_map<string, vector<uint32_t>> formatPostings;
+		// Per cap one posting list per distinct value
+		unordered_map<string, map<int64_t, vector<uint32_t>>> capPostings;
+		unordered_map<int, uint32_t> reportIds;
+		// Reports without database id by file name (imports are cached by content hash), so importing the same reports again doesn't add duplicates
+		unordered_map<string, uint32_t> reportFiles;
+		// Used to store compressed formats by name
+		function<string(GLint)> getEnumName;
+		reportIndex();
+		void clear();
+		bool contains(int reportId) const;
+		bool containsFile(const string& fileName) const;
+		int addReport(const reportData& report, int reportId = -1, const string& fileName = "");
+		int importFiles(const vector<string>& fileNames, function<int(const string&)> getReportId, function<void(const reportData&, const indexedReport&)> added = nullptr, int threadCount = 0);
+		bool select(const reportQuery& query, vector<uint32_t>& result, string& error) const;
+		vector<uint32_t> query(const string& query, string& error) const;
+	};
+
+}
@@ -0,0 +1,187 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Query syntax for searching reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportQuery.h"
+#include <cstdlib>
+#include <cctype>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string trimTerm(const string& str)
+	{
+		size_t start = str.find_first_not_of(" \t\r\n");
+		if (start == string::npos) {
+			return "";
+		}
+		size_t end = str.find_last_not_of(" \t\r\n");
+		return str.substr(start, end - start + 1);
+	}
+
+	string lowerCase(const string& str)
+	{
+		string lower = str;
+		for (auto& c : lower) {
+			c = (char)tolower((unsigned char)c);
+		}
+		return lower;
+	}
+
+	/// <summary>
+	/// Splits the query at " and " (case insensitive) and "&&" outside of quotes
+	/// </summary>
+	vector<string> splitTerms(const string& query)
+	{
+		vector<string> terms;
+		string lower = lowerCase(query);
+		size_t start = 0;
+		size_t pos = 0;
+		bool quoted = false;
+		while (pos < query.size()) {
+			size_t separatorLength = 0;
+			if (query[pos] == '"') {
+				quoted = !quoted;
+			}
+			else if ((!quoted) && (query.compare(pos, 2, "&&") == 0)) {
+				separatorLength = 2;
+			}
+			else if ((!quoted) && (lower.compare(pos, 3, "and") == 0) && (pos > 0) && (isspace((unsigned char)query[pos - 1])) && ((pos + 3 == query.size()) || (isspace((unsigned char)query[pos + 3])))) {
+				separatorLength = 3;
+			}
+			if (separatorLength > 0) {
+				terms.push_back(trimTerm(query.substr(start, pos - start)));
+				pos += separatorLength;
+				start = pos;
+			}
+			else {
+				pos++;
+			}
+		}
+		terms.push_back(trimTerm(query.substr(start)));
+		return terms;
+	}
+
+	/// <summary>
+	/// Integer value (decimal or 0x hexadecimal), the whole string has to be a number
+	/// </summary>
+	bool reportQuery::parseValue(const string& str, int64_t& value)
+	{
+		if ((str.empty()) || ((!isdigit((unsigned char)str[0])) && (str[0] != '-'))) {
+			return false;
+		}
+		char* end;
+		value = strtoll(str.c_str(), &end, 0);
+		return (*end == 0);
+	}
+
+	bool reportQuery::compare(int64_t value, queryOperator op, int64_t reference)
+	{
+		switch (op) {
+		case queryLess:
+			return value < reference;
+		case queryLessEqual:
+			return value <= reference;
+		case queryEqual:
+			return value == reference;
+		case queryNotEqual:
+			return value != reference;
+		case queryGreaterEqual:
+			return value >= reference;
+		case queryGreater:
+			return value > reference;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Parses a query like "GL_MAX_TEXTURE_SIZE >= 16384 and GL_ARB_bindless_texture"
+	/// </summary>
+	/// <returns>false if the query is invalid, error contains the reason</returns>
+	bool reportQuery::parse(const string& query)
+	{
+		terms.clear();
+		error = "";
+		for (auto& termStr : splitTerms(query)) {
+			if (termStr.empty()) {
+				error = "Empty term";
+				return false;
+			}
+			queryTerm term;
+			size_t opStart = termStr.find_first_of("<>=!");
+			size_t prefixEnd = termStr.find(':');
+			string prefix = (prefixEnd != string::npos) ? lowerCase(trimTerm(termStr.substr(0, prefixEnd))) : "";
+			if ((prefix == "renderer") || (prefix == "format")) {
+				term.type = (prefix == "renderer") ? queryRenderer : queryFormat;
+				term.name = trimTerm(termStr.substr(prefixEnd + 1));
+				if ((term.name.size() >= 2) && (term.name.front() == '"') && (term.name.back() == '"')) {
+					term.name = term.name.substr(1, term.name.size() - 2);
+				}
+			}
+			else if ((opStart == 0) && (termStr.compare(0, 2, "!=") != 0)) {
+				// !GL_ARB_bindless_texture
+				term.type = queryNoExtension;
+				term.name = trimTerm(termStr.substr(1));
+			}
+			else if (opStart == string::npos) {
+				term.type = queryExtension;
+				term.name = termStr;
+				if ((termStr.size() > 4) && (termStr.compare(0, 4, "not ") == 0)) {
+					term.type = queryNoExtension;
+					term.name = trimTerm(termStr.substr(4));
+				}
+			}
+			else {
+				term.type = queryCompare;
+				term.name = trimTerm(termStr.substr(0, opStart));
+				size_t opLength = ((opStart + 1 < termStr.size()) && (termStr[opStart + 1] == '=')) ? 2 : 1;
+				string op = termStr.substr(opStart, opLength);
+				if (op == "=") {
+					op = "==";
+				}
+				// Same order as queryOperator
+				const string operators[] = { "<", "<=", "==", "!=", ">=", ">" };
+				int opIndex = 0;
+				while ((opIndex < 6) && (operators[opIndex] != op)) {
+					opIndex++;
+				}
+				if (opIndex == 6) {
+					error = "Unknown operator in \"" + termStr + "\"";
+					return false;
+				}
+				term.op = (queryOperator)opIndex;
+				string valueStr = trimTerm(termStr.substr(opStart + opLength));
+				if (!parseValue(valueStr, term.value)) {
+					error = "\"" + valueStr + "\" is not a number";
+					return false;
+				}
+			}
+			if (term.name.empty()) {
+				error = "Missing name in \"" + termStr + "\"";
+				return false;
+			}
+			terms.push_back(term);
+		}
+		return true;
+	}
+
+}
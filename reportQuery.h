@@ -0,0 +1,71 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Query syntax for searching reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	enum queryTermType {
+		// GL_ARB_bindless_texture
+		queryExtension,
+		// not GL_ARB_bindless_texture, !GL_ARB_bindless_texture
+		queryNoExtension,
+		// GL_MAX_TEXTURE_SIZE >= 16384
+		queryCompare,
+		// renderer:GeForce, renderer:"Radeon HD" (case insensitive substring)
+		queryRenderer,
+		// format:GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+		queryFormat
+	};
+
+	enum queryOperator { queryLess, queryLessEqual, queryEqual, queryNotEqual, queryGreaterEqual, queryGreater };
+
+	class queryTerm
+	{
+	public:
+		queryTermType type;
+		string name;
+		queryOperator op = queryEqual;
+		int64_t value = 0;
+	};
+
+	/// <summary>
+	/// Terms joined with "and" (or &&), all terms have to match
+	/// Values of renderer and format terms can be quoted to include spaces or "and"
+	/// </summary>
+	class reportQuery
+	{
+	public:
+		vector<queryTerm> terms;
+		string error;
+		bool parse(const string& query);
+		static bool compare(int64_t value, queryOperator op, int64_t reference);
+		static bool parseValue(const string& str, int64_t& value);
+	};
+
+}
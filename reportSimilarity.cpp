@@ -0,0 +1,249 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Nearest neighbour search for reports with similar capabilities
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportSimilarity.h"
+#include "reportQuery.h"
+#include <cmath>
+#include <queue>
+#include <algorithm>
+#include <functional>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	void reportSimilarity::clear()
+	{
+		means.clear();
+		deviations.clear();
+		capSums.assign(capNames.size(), 0.0);
+		capSquares.assign(capNames.size(), 0.0);
+		capCounts.assign(capNames.size(), 0);
+		pendingCaps.clear();
+		pendingExtensions.clear();
+		vectors.clear();
+		labels.clear();
+		built = false;
+	}
+
+	void reportSimilarity::createSchema(const capsList& caps)
+	{
+		capNames.clear();
+		capIndices.clear();
+		for (auto& name : caps.integerCapNames()) {
+			if (capIndices.count(name) == 0) {
+				capIndices[name] = capNames.size();
+				capNames.push_back(name);
+			}
+		}
+		dimensions = (capNames.size() + extensionBuckets + 15) / 16 * 16;
+		clear();
+	}
+
+	/// <summary>
+	/// FNV-1a, so extension buckets are the same on all platforms
+	/// </summary>
+	uint32_t extensionHash(const string& extension)
+	{
+		uint32_t hash = 2166136261u;
+		for (auto c : extension) {
+			hash = (hash ^ (uint8_t)c) * 16777619u;
+		}
+		return hash;
+	}
+
+	/// <summary>
+	/// Log scaled cap values (NAN if not present) and the sorted buckets of all extensions
+	/// </summary>
+	void reportSimilarity::readFeatures(const reportData& report, float* caps, vector<uint32_t>& buckets) const
+	{
+		fill(caps, caps + capNames.size(), NAN);
+		for (auto& cap : report.caps) {
+			auto capIndex = capIndices.find(cap.first);
+			int64_t value;
+			if ((capIndex != capIndices.end()) && (reportQuery::parseValue(cap.second, value))) {
+				// Limits mostly grow in powers of two, so differences are compared on a log scale
+				float magnitude = log2(1.0f + (float)llabs(value));
+				caps[capIndex->second] = (value < 0) ? -magnitude : magnitude;
+			}
+		}
+		buckets.clear();
+		for (auto& extension : report.extensions) {
+			buckets.push_back(extensionHash(extension) % extensionBuckets);
+		}
+		sort(buckets.begin(), buckets.end());
+		buckets.erase(unique(buckets.begin(), buckets.end()), buckets.end());
+	}
+
+	/// <summary>
+	/// Standardizes the cap values (missing caps are treated as average), weights caps and extensions equally and quantizes the unit length vector to 8 bit
+	/// </summary>
+	void reportSimilarity::encode(const float* caps, const vector<uint32_t>& buckets, int8_t* encoded) const
+	{
+		vector<float> values(dimensions, 0.0f);
+		float capNorm = 0.0f;
+		for (size_t i = 0; i < capNames.size(); i++) {
+			if (!std::isnan(caps[i])) {
+				// Outliers are clamped so single caps don't dominate the distance
+				float z = max(-3.0f, min(3.0f, (caps[i] - means[i]) / deviations[i]));
+				values[i] = z;
+				capNorm += z * z;
+			}
+		}
+		if (capNorm > 0.0f) {
+			float scale = sqrt(0.5f / capNorm);
+			for (size_t i = 0; i < capNames.size(); i++) {
+				values[i] *= scale;
+			}
+		}
+		if (!buckets.empty()) {
+			float weight = sqrt(0.5f / buckets.size());
+			for (auto bucket : buckets) {
+				values[capNames.size() + bucket] = weight;
+			}
+		}
+
+		float norm = 0.0f;
+		for (auto value : values) {
+			norm += value * value;
+		}
+		float scale = (norm > 0.0f) ? 127.0f / sqrt(norm) : 0.0f;
+		for (size_t i = 0; i < dimensions; i++) {
+			encoded[i] = (int8_t)lround(values[i] * scale);
+		}
+	}
+
+	/// <summary>
+	/// Adds a report to the cap statistics, it's encoded and can be found once build has been called
+	/// </summary>
+	/// <param name="label">Shown for matches (e.g. the renderer)</param>
+	void reportSimilarity::addReport(const reportData& report, const string& label)
+	{
+		vector<float> caps(capNames.size());
+		vector<uint32_t> buckets;
+		readFeatures(report, caps.data(), buckets);
+		for (size_t i = 0; i < capNames.size(); i++) {
+			if (!std::isnan(caps[i])) {
+				capSums[i] += caps[i];
+				capSquares[i] += caps[i] * caps[i];
+				capCounts[i]++;
+			}
+		}
+		labels.push_back(label);
+		pendingCaps.insert(pendingCaps.end(), caps.begin(), caps.end());
+		pendingExtensions.push_back(buckets);
+	}
+
+	/// <summary>
+	/// Updates the cap statistics to include all added reports and encodes the reports added since the last build
+	/// Reports encoded by earlier builds keep their vectors, their features are not kept to re-encode them
+	/// </summary>
+	void reportSimilarity::build()
+	{
+		size_t capCount = capNames.size();
+		means.assign(capCount, 0.0f);
+		deviations.assign(capCount, 1.0f);
+		for (size_t i = 0; i < capCount; i++) {
+			if (capCounts[i] > 0) {
+				double mean = capSums[i] / capCounts[i];
+				double variance = capSquares[i] / capCounts[i] - mean * mean;
+				means[i] = (float)mean;
+				// Caps with the same value everywhere still separate reports that don't have them
+				deviations[i] = (variance > 1e-6) ? (float)sqrt(variance) : 1.0f;
+			}
+		}
+
+		size_t encoded = vectors.size() / max(dimensions, (size_t)1);
+		vectors.resize(labels.size() * dimensions);
+		for (size_t r = 0; r < pendingExtensions.size(); r++) {
+			encode(&pendingCaps[r * capCount], pendingExtensions[r], &vectors[(encoded + r) * dimensions]);
+		}
+		vector<float>().swap(pendingCaps);
+		vector<vector<uint32_t>>().swap(pendingExtensions);
+		built = true;
+	}
+
+	/// <summary>
+	/// Number of reports that can be found, reports added after the last build are not included
+	/// </summary>
+	size_t reportSimilarity::size() const
+	{
+		return ((built) && (dimensions > 0)) ? vectors.size() / dimensions : 0;
+	}
+
+	/// <summary>
+	/// Vectors are padded to a multiple of 16, the fixed length inner loop is vectorized by the compiler (8 bit multiplies accumulated in 32 bit)
+	/// </summary>
+	int32_t dotProduct(const int8_t* a, const int8_t* b, size_t count)
+	{
+		int32_t sum = 0;
+		for (size_t i = 0; i < count; i += 16) {
+			for (size_t j = 0; j < 16; j++) {
+				sum += (int32_t)a[i + j] * (int32_t)b[i + j];
+			}
+		}
+		return sum;
+	}
+
+	/// <summary>
+	/// Returns the reports most similar to the given report, most similar first
+	/// </summary>
+	/// <param name="count">Maximum number of reports to return</param>
+	vector<similarReport> reportSimilarity::query(const reportData& report, size_t count) const
+	{
+		vector<similarReport> matches;
+		if ((size() == 0) || (count == 0)) {
+			return matches;
+		}
+		vector<float> caps(capNames.size());
+		vector<uint32_t> buckets;
+		readFeatures(report, caps.data(), buckets);
+		vector<int8_t> queryVector(dimensions);
+		encode(caps.data(), buckets, queryVector.data());
+
+		// Min heap of the best matches so far
+		typedef pair<int32_t, uint32_t> scoredReport;
+		priority_queue<scoredReport, vector<scoredReport>, greater<scoredReport>> best;
+		uint32_t reportCount = (uint32_t)size();
+		for (uint32_t r = 0; r < reportCount; r++) {
+			int32_t score = dotProduct(queryVector.data(), &vectors[r * dimensions], dimensions);
+			if (best.size() < count) {
+				best.push(make_pair(score, r));
+			}
+			else if (score > best.top().first) {
+				best.pop();
+				best.push(make_pair(score, r));
+			}
+		}
+
+		while (!best.empty()) {
+			similarReport match;
+			match.index = best.top().second;
+			match.similarity = best.top().first / (127.0f * 127.0f);
+			matches.push_back(match);
+			best.pop();
+		}
+		reverse(matches.begin(), matches.end());
+		return matches;
+	}
+
+}
@@ -0,0 +1,84 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Nearest neighbour search for reports with similar capabilities
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "capsList.h"
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class similarReport
+	{
+	public:
+		// Index of the report in the corpus
+		uint32_t index;
+		// Cosine similarity (1.0 = identical)
+		float similarity;
+	};
+
+	/// <summary>
+	/// Every report is encoded into a fixed length vector of unit length:
+	/// - Integer caps of the capability list, log scaled and standardized with the mean and deviation of the corpus
+	/// - Extensions hashed into a fixed number of buckets
+	/// Both halves are weighted equally and stored quantized to 8 bit, queries are a linear scan of integer dot products
+	/// </summary>
+	class reportSimilarity
+	{
+	private:
+		vector<string> capNames;
+		unordered_map<string, size_t> capIndices;
+		// Standardization of the log scaled cap values
+		vector<float> means;
+		vector<float> deviations;
+		// Running sums of the log scaled cap values of all added reports, so build doesn't need their features
+		vector<double> capSums;
+		vector<double> capSquares;
+		vector<uint32_t> capCounts;
+		// Features of the reports added since the last build, released once they have been encoded
+		vector<float> pendingCaps;
+		vector<vector<uint32_t>> pendingExtensions;
+		void readFeatures(const reportData& report, float* caps, vector<uint32_t>& buckets) const;
+		void encode(const float* caps, const vector<uint32_t>& buckets, int8_t* encoded) const;
+	public:
+		static const int extensionBuckets = 256;
+		// Vector length, padded to a multiple of 16
+		size_t dimensions = 0;
+		vector<int8_t> vectors;
+		// Label (e.g. renderer) of every report in the corpus, including reports not yet encoded by build
+		vector<string> labels;
+		bool built = false;
+		void clear();
+		void createSchema(const capsList& caps);
+		void addReport(const reportData& report, const string& label);
+		void build();
+		size_t size() const;
+		vector<similarReport> query(const reportData& report, size_t count) const;
+	};
+
+}
@@ -1,5 +1,8 @@
 #include "settings.h"
+#include "glCapsViewerHttp.h"
 #include "QNetworkProxy"
+#include <QCoreApplication>
+#include <QStringList>
 
 namespace capsViewer {
 
@@ -23,6 +26,15 @@ namespace capsViewer {
 		proxyUserName = settings.value("proxy/user", "").toString();
 		proxyUserPassword = settings.value("proxy/password", "").toString();
 		proxyEnabled = settings.value("proxy/enabled", "").toBool();
+		databaseUrl = settings.value("database/url", "").toString();
+
+		// Database url passed on the command line overrides the stored one
+		QStringList args = QCoreApplication::arguments();
+		int urlArg = args.indexOf("-database");
+		if ((urlArg > -1) && (urlArg + 1 < args.size())) {
+			databaseUrl = args[urlArg + 1];
+		}
+		glCapsViewerHttp::setBaseUrl(databaseUrl.toStdString());
 
 		// Apply proxy settings
 		if (proxyEnabled) {
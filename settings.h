@@ -17,6 +17,7 @@ namespace capsViewer {
 		QString proxyPort;
 		QString proxyUserName;
 		QString proxyUserPassword;
+		QString databaseUrl;
 		bool proxyEnabled;
 		void restore();
 	};
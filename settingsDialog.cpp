@@ -60,6 +60,13 @@ namespace capsViewer {
 		formLayout->addRow(labelCaption);
 		formLayout->addRow(tr("Submitter:"), createLineEdit("editSubmitterName"));
 
+		labelCaption = new QLabel();
+		labelCaption->setText("Database");
+		labelCaption->setStyleSheet("font: 75 11pt;");
+		formLayout->addRow(labelCaption);
+
+		formLayout->addRow(tr("Database url (empty for default):"), createLineEdit("editDatabaseUrl"));
+
 		labelCaption = new QLabel();
 		labelCaption->setText("Proxy Settings");
 		labelCaption->setStyleSheet("font: 75 11pt;");
@@ -84,6 +91,7 @@ namespace capsViewer {
 		QSettings settings("saschawillems", "glcapsviewer");
 		QLineEdit* edit;
 		findChild<QLineEdit*>("editSubmitterName", Qt::FindChildrenRecursively)->setText(settings.value("global/submitterName", "").toString());
+		findChild<QLineEdit*>("editDatabaseUrl", Qt::FindChildrenRecursively)->setText(settings.value("database/url", "").toString());
 		findChild<QLineEdit*>("editProxyDns", Qt::FindChildrenRecursively)->setText(settings.value("proxy/dns", "").toString());
 		findChild<QLineEdit*>("editProxyPort", Qt::FindChildrenRecursively)->setText(settings.value("proxy/port", "").toString());
 		findChild<QLineEdit*>("editProxyUser", Qt::FindChildrenRecursively)->setText(settings.value("proxy/user", "").toString());
@@ -103,6 +111,9 @@ namespace capsViewer {
 		edit = this->findChild<QLineEdit*>("editSubmitterName", Qt::FindChildrenRecursively);
 		settings.setValue("global/submitterName", edit->text());
 
+		edit = this->findChild<QLineEdit*>("editDatabaseUrl", Qt::FindChildrenRecursively);
+		settings.setValue("database/url", edit->text());
+
 		edit = this->findChild<QLineEdit*>("editProxyDns", Qt::FindChildrenRecursively);
 		settings.setValue("proxy/dns", edit->text());
 		edit = this->findChild<QLineEdit*>("editProxyPort", Qt::FindChildrenRecursively);
@@ -0,0 +1,325 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Shader compile and link latency probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "shaderCompileProbe.h"
+#include "glCapsViewerCore.h"
+#include <sstream>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string shaderCompileProbe::name() const
+	{
+		return "shadercompile";
+	}
+
+	bool shaderCompileProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Fullscreen vertex shader with a unique constant, comments are not enough as some caches hash the preprocessed source
+	/// </summary>
+	string shaderCompileProbe::vertexSource()
+	{
+		stringstream ss;
+		ss << "#version 330\n"
+			<< "out vec2 uv;\n"
+			<< "void main()\n"
+			<< "{\n"
+			<< "	uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+			<< "	gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0) + vec4(0.0, 0.0, 0.0, " << nonce << ".0 * 1e-30);\n"
+			<< "}\n";
+		return ss.str();
+	}
+
+	/// <summary>
+	/// Fragment shader with a mix of arithmetic, branches and texture fetches, as found in material shaders
+	/// Every statement depends on uniforms and the previous result, so the compiler can't fold it away
+	/// </summary>
+	string shaderCompileProbe::fragmentSource(int statements)
+	{
+		stringstream ss;
+		ss << "#version 330\n"
+			<< "uniform vec4 params[16];\n"
+			<< "uniform sampler2D source;\n"
+			<< "in vec2 uv;\n"
+			<< "out vec4 color;\n"
+			<< "vec4 shade(vec4 value, vec4 param)\n"
+			<< "{\n"
+			<< "	return normalize(value + param) * dot(value.xyz, param.zyx) + pow(abs(value), param.wzyx);\n"
+			<< "}\n"
+			<< "void main()\n"
+			<< "{\n"
+			<< "	vec4 value = texture(source, uv) + vec4(" << nonce << ".0 * 1e-30);\n";
+		for (int i = 0; i < statements; i++) {
+			int param = i % 16;
+			switch (i % 4) {
+			case 0:
+				ss << "	value = fract(value * params[" << param << "] + sin(value.wxyz) * " << (i + 1) << ".0);\n";
+				break;
+			case 1:
+				ss << "	if (value.x > params[" << param << "].y) { value = value.yzwx * params[" << param << "].x; } else { value += params[" << param << "]; }\n";
+				break;
+			case 2:
+				ss << "	value = shade(value, params[" << param << "]);\n";
+				break;
+			case 3:
+				ss << "	value += texture(source, value.xy * 0.5 + uv) * params[" << param << "].w;\n";
+				break;
+			}
+		}
+		ss << "	color = value;\n"
+			<< "}\n";
+		return ss.str();
+	}
+
+	/// <summary>
+	/// Compiles and links a new unique program, compile and link are timed separately if requested
+	/// Querying the status waits for the driver to finish, so it is part of the measured time
+	/// </summary>
+	/// <returns>Program name, 0 if compiling or linking failed</returns>
+	GLuint shaderCompileProbe::compileProgram(int statements, double* compileTime, double* linkTime, bool binaryRetrievable)
+	{
+		nonce++;
+		string sources[] = { vertexSource(), fragmentSource(statements) };
+		GLenum stages[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+		GLint status = GL_TRUE;
+		GLuint program = glCreateProgram();
+		glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+		for (int i = 0; i < 2; i++) {
+			GLuint shader = glCreateShader(stages[i]);
+			const char* source = sources[i].c_str();
+			glShaderSource(shader, 1, &source, nullptr);
+			glCompileShader(shader);
+			GLint compiled;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+			glAttachShader(program, shader);
+			glDeleteShader(shader);
+			if (compiled != GL_TRUE) {
+				status = GL_FALSE;
+			}
+		}
+		glPerformanceProbes::clock::time_point compiled = glPerformanceProbes::clock::now();
+		if (binaryRetrievable) {
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+		if (status == GL_TRUE) {
+			glLinkProgram(program);
+			glGetProgramiv(program, GL_LINK_STATUS, &status);
+		}
+		glPerformanceProbes::clock::time_point linked = glPerformanceProbes::clock::now();
+		if (status != GL_TRUE) {
+			glDeleteProgram(program);
+			return 0;
+		}
+		if (compileTime != nullptr) {
+			*compileTime = chrono::duration<double, micro>(compiled - start).count();
+		}
+		if (linkTime != nullptr) {
+			*linkTime = chrono::duration<double, micro>(linked - compiled).count();
+		}
+		return program;
+	}
+
+	void shaderCompileProbe::setCompilerThreads(glCapsViewerCore& core, GLuint count)
+	{
+		if (core.extensionSupported("GL_KHR_parallel_shader_compile")) {
+			glMaxShaderCompilerThreadsKHR(count);
+		}
+		else {
+			glMaxShaderCompilerThreadsARB(count);
+		}
+	}
+
+	/// <summary>
+	/// Compiles and links a batch of programs without querying their status in between and polls GL_COMPLETION_STATUS until all are done
+	/// </summary>
+	void shaderCompileProbe::measureParallel(glPerformanceProbes& probes, const string& caseName, int statements, double coldTime)
+	{
+		probeSamples samples;
+		for (int s = 0; s < probes.sampleCount; s++) {
+			vector<GLuint> programs;
+			vector<GLuint> shaders;
+			glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+			for (int p = 0; p < parallelPrograms; p++) {
+				nonce++;
+				string sources[] = { vertexSource(), fragmentSource(statements) };
+				GLenum stages[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+				GLuint program = glCreateProgram();
+				for (int i = 0; i < 2; i++) {
+					GLuint shader = glCreateShader(stages[i]);
+					const char* source = sources[i].c_str();
+					glShaderSource(shader, 1, &source, nullptr);
+					glCompileShader(shader);
+					glAttachShader(program, shader);
+					shaders.push_back(shader);
+				}
+				glLinkProgram(program);
+				programs.push_back(program);
+			}
+			bool failed = false;
+			for (auto& program : programs) {
+				GLint completed = GL_FALSE;
+				while (completed != GL_TRUE) {
+					glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+				}
+				GLint status;
+				glGetProgramiv(program, GL_LINK_STATUS, &status);
+				failed = failed || (status != GL_TRUE);
+			}
+			glPerformanceProbes::clock::time_point finished = glPerformanceProbes::clock::now();
+			for (auto& shader : shaders) {
+				glDeleteShader(shader);
+			}
+			for (auto& program : programs) {
+				glDeleteProgram(program);
+			}
+			if (failed) {
+				probes.addMessage(name(), caseName + " parallel compile failed");
+				return;
+			}
+			samples.add(chrono::duration<double, micro>(finished - start).count() / parallelPrograms);
+		}
+		double parallelTime = samples.median();
+		probes.addValue(name(), caseName, "parallel_us", parallelTime);
+		probes.addValue(name(), caseName, "parallel_speedup", (parallelTime > 0.0) ? coldTime / parallelTime : 0.0);
+	}
+
+	/// <summary>
+	/// Retrieves the binary of a linked program and times creating programs from it, as a program binary cache does at startup
+	/// </summary>
+	void shaderCompileProbe::measureBinary(glPerformanceProbes& probes, const string& caseName, int statements, double coldTime)
+	{
+		GLuint program = compileProgram(statements, nullptr, nullptr, true);
+		if (program == 0) {
+			return;
+		}
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		vector<unsigned char> binary(max(length, 1));
+		GLenum binaryFormat = 0;
+		GLsizei binaryLength = 0;
+		glGetProgramBinary(program, (GLsizei)binary.size(), &binaryLength, &binaryFormat, binary.data());
+		glDeleteProgram(program);
+		if (binaryLength <= 0) {
+			probes.addMessage(name(), caseName + " program binary not retrievable");
+			return;
+		}
+
+		probeSamples samples;
+		for (int s = 0; s < probes.sampleCount; s++) {
+			glPerformanceProbes::clock::time_point start = glPerformanceProbes::clock::now();
+			GLuint loaded = glCreateProgram();
+			glProgramBinary(loaded, binaryFormat, binary.data(), binaryLength);
+			GLint status;
+			glGetProgramiv(loaded, GL_LINK_STATUS, &status);
+			glPerformanceProbes::clock::time_point finished = glPerformanceProbes::clock::now();
+			glDeleteProgram(loaded);
+			// Drivers may reject their own binaries, applications have to fall back to compiling then
+			if (status != GL_TRUE) {
+				probes.addMessage(name(), caseName + " program binary rejected on reload");
+				return;
+			}
+			samples.add(chrono::duration<double, micro>(finished - start).count());
+		}
+		double binaryTime = samples.median();
+		probes.addValue(name(), caseName, "binary_bytes", binaryLength);
+		probes.addValue(name(), caseName, "binary_load_us", binaryTime);
+		probes.addValue(name(), caseName, "binary_speedup", (binaryTime > 0.0) ? coldTime / binaryTime : 0.0);
+	}
+
+	void shaderCompileProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// Start from a value unique to this run, so programs of earlier runs are not in the driver's disk cache
+		nonce = (unsigned int)(glPerformanceProbes::clock::now().time_since_epoch().count() & 0xFFFFF) * 1000;
+
+		bool parallelCompile = core.extensionSupported("GL_KHR_parallel_shader_compile") || core.extensionSupported("GL_ARB_parallel_shader_compile");
+		GLint binaryFormats = 0;
+		if ((GLEW_VERSION_4_1) || (GLEW_ARB_get_program_binary)) {
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+		}
+		if (!parallelCompile) {
+			probes.addMessage(name(), "parallel compile skipped, requires GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile");
+		}
+		if (binaryFormats == 0) {
+			probes.addMessage(name(), "program binary skipped, requires OpenGL 4.1 or GL_ARB_get_program_binary with at least one binary format");
+		}
+
+		// Let the driver use as many compiler threads as it likes, the previous limit is restored afterwards
+		GLint compilerThreads = 0;
+		if (parallelCompile) {
+			glGetIntegerv(GL_MAX_SHADER_COMPILER_THREADS_KHR, &compilerThreads);
+			setCompilerThreads(core, 0xFFFFFFFF);
+		}
+
+		// Warm up, the first program may include loading and initializing the compiler
+		GLuint warmup = compileProgram(16, nullptr, nullptr, false);
+		glDeleteProgram(warmup);
+
+		// Arithmetic statements in the fragment shader, from a simple post processing shader to a large uber shader
+		const int sizes[] = { 16, 128, 1024 };
+		for (auto& statements : sizes) {
+			string caseName = to_string(statements) + " statements";
+			probeSamples compileSamples;
+			probeSamples linkSamples;
+			probeSamples totalSamples;
+			for (int s = 0; s < probes.sampleCount; s++) {
+				double compileTime;
+				double linkTime;
+				GLuint program = compileProgram(statements, &compileTime, &linkTime, false);
+				if (program == 0) {
+					break;
+				}
+				glDeleteProgram(program);
+				compileSamples.add(compileTime);
+				linkSamples.add(linkTime);
+				totalSamples.add(compileTime + linkTime);
+			}
+			if ((int)totalSamples.samples.size() < probes.sampleCount) {
+				probes.addMessage(name(), caseName + " skipped, program failed to compile or link");
+				continue;
+			}
+			double coldTime = totalSamples.median();
+			probes.addValue(name(), caseName, "compile_us", compileSamples.median());
+			probes.addValue(name(), caseName, "link_us", linkSamples.median());
+			probes.addValue(name(), caseName, "cold_us", coldTime);
+			if (parallelCompile) {
+				measureParallel(probes, caseName, statements, coldTime);
+			}
+			if (binaryFormats > 0) {
+				measureBinary(probes, caseName, statements, coldTime);
+			}
+		}
+
+		if (parallelCompile) {
+			setCompilerThreads(core, (GLuint)compilerThreads);
+		}
+	}
+
+}
@@ -0,0 +1,58 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Shader compile and link latency probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures compile and link times of generated GLSL programs of increasing size, cold, in parallel (GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile)
+	/// and reloaded from a program binary (OpenGL 4.1 or GL_ARB_get_program_binary)
+	/// Every program is made unique, so the results are not skewed by in memory or on disk shader caches of the driver
+	/// </summary>
+	class shaderCompileProbe : public glPerformanceProbe
+	{
+	private:
+		// Makes generated sources unique across runs and programs
+		unsigned int nonce = 0;
+		string vertexSource();
+		string fragmentSource(int statements);
+		GLuint compileProgram(int statements, double* compileTime, double* linkTime, bool binaryRetrievable);
+		void setCompilerThreads(glCapsViewerCore& core, GLuint count);
+		void measureParallel(glPerformanceProbes& probes, const string& caseName, int statements, double coldTime);
+		void measureBinary(glPerformanceProbes& probes, const string& caseName, int statements, double coldTime);
+	public:
+		// Programs compiled at once when measuring parallel compilation
+		int parallelPrograms = 8;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+	};
+
+}
@@ -0,0 +1,262 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Texture sampling throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "textureSamplingProbe.h"
+#include "fillRateProbe.h"
+#include "glCapsViewerCore.h"
+#include <sstream>
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string textureSamplingProbe::name() const
+	{
+		return "texturesampling";
+	}
+
+	bool textureSamplingProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if (!GLEW_VERSION_3_3) {
+			reason = "requires OpenGL 3.3";
+			return false;
+		}
+		return true;
+	}
+
+	string textureSamplingProbe::modeName(samplingMode mode)
+	{
+		switch (mode) {
+		case samplingNearest:
+			return "nearest";
+		case samplingBilinear:
+			return "bilinear";
+		case samplingTrilinear:
+			return "trilinear";
+		case samplingAnisotropic:
+			return "anisotropic";
+		case samplingGather:
+			return "gather";
+		case samplingShadow:
+			return "shadow";
+		}
+		return "";
+	}
+
+	/// <summary>
+	/// Sets up the sampler state of a mode and times fullscreen passes with the program
+	/// Trilinear filtering minifies the texture so two mip levels are used, anisotropic filtering samples it stretched along one axis
+	/// </summary>
+	/// <returns>Median time of a pass in microseconds</returns>
+	double textureSamplingProbe::measureMode(glPerformanceProbes& probes, GLuint texture, GLuint program, samplingMode mode, GLfloat maxAnisotropy)
+	{
+		GLenum minFilter = GL_NEAREST;
+		GLenum magFilter = GL_NEAREST;
+		GLfloat scale[] = { 1.0f, 1.0f };
+		switch (mode) {
+		case samplingBilinear:
+		case samplingShadow:
+			minFilter = GL_LINEAR;
+			magFilter = GL_LINEAR;
+			break;
+		case samplingTrilinear:
+			minFilter = GL_LINEAR_MIPMAP_LINEAR;
+			magFilter = GL_LINEAR;
+			scale[0] = scale[1] = 2.5f;
+			break;
+		case samplingAnisotropic:
+			minFilter = GL_LINEAR_MIPMAP_LINEAR;
+			magFilter = GL_LINEAR;
+			scale[1] = 8.0f;
+			break;
+		default:
+			break;
+		}
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, (mode == samplingShadow) ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+		if (maxAnisotropy > 0.0f) {
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, (mode == samplingAnisotropic) ? maxAnisotropy : 1.0f);
+		}
+		glUseProgram(program);
+		glUniform2fv(glGetUniformLocation(program, "scale"), 1, scale);
+		double time = probes.medianTime([&]() {
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		});
+		return time;
+	}
+
+	void textureSamplingProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// One program per sampler type and fetch function, gather needs GLSL 4.00
+		auto fragmentSource = [&](const string& version, const string& sampler, const string& fetch) {
+			stringstream ss;
+			ss << "#version " << version << "\n"
+				<< "uniform " << sampler << " source;\n"
+				<< "uniform vec2 scale;\n"
+				<< "in vec2 uv;\n"
+				<< "out vec4 color;\n"
+				<< "void main()\n"
+				<< "{\n"
+				<< "	vec4 value = vec4(0.0);\n"
+				<< "	for (int i = 0; i < " << fetchesPerPixel << "; i++) {\n"
+				<< "		vec2 coord = uv * scale + vec2(i) * 0.0137;\n"
+				<< "		value += " << fetch << ";\n"
+				<< "	}\n"
+				<< "	color = value;\n"
+				<< "}\n";
+			return ss.str();
+		};
+		string log;
+		GLuint sampleProgram = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource("330", "sampler2D", "texture(source, coord)"), log);
+		if (sampleProgram == 0) {
+			probes.addMessage(name(), "skipped, program failed: " + log);
+			return;
+		}
+		GLuint shadowProgram = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource("330", "sampler2DShadow", "vec4(texture(source, vec3(coord, 0.5)))"), log);
+		GLuint gatherProgram = 0;
+		if (GLEW_VERSION_4_0) {
+			gatherProgram = glPerformanceProbes::createProgram(glPerformanceProbes::fullscreenVertexSource(), fragmentSource("400", "sampler2D", "textureGather(source, coord)"), log);
+		}
+		else {
+			probes.addMessage(name(), "gather skipped, requires OpenGL 4.0");
+		}
+		GLfloat maxAnisotropy = 0.0f;
+		if ((core.extensionSupported("GL_EXT_texture_filter_anisotropic")) || (core.extensionSupported("GL_ARB_texture_filter_anisotropic"))) {
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+		}
+		else {
+			probes.addMessage(name(), "anisotropic skipped, requires GL_EXT_texture_filter_anisotropic or GL_ARB_texture_filter_anisotropic");
+		}
+
+		GLint viewport[4];
+		GLint unpackAlignment;
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// Textures are filled from client memory, the caller's bindings are restored by glPerformanceProbes
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		GLuint framebuffer;
+		GLuint renderTarget;
+		GLuint vertexArray;
+		glGenFramebuffers(1, &framebuffer);
+		glGenTextures(1, &renderTarget);
+		glBindTexture(GL_TEXTURE_2D, renderTarget);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTarget, 0);
+		glGenVertexArrays(1, &vertexArray);
+		glBindVertexArray(vertexArray);
+		glViewport(0, 0, textureSize, textureSize);
+
+		// Render target formats and depth formats, the sweep only covers base formats
+		vector<GLenum> formats = fillRateProbe::colorFormats();
+		GLenum depthFormats[] = { GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT32F, GL_DEPTH24_STENCIL8 };
+		formats.insert(formats.end(), depthFormats, depthFormats + 4);
+		// Pattern used for all mip levels, large enough for level 0 of every format
+		vector<unsigned char> data(textureSize * textureSize * 4);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = (unsigned char)(i * 7 + i / 251);
+		}
+		double fetches = (double)textureSize * textureSize * fetchesPerPixel;
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			probes.addMessage(name(), "skipped, render target not complete");
+			formats.clear();
+		}
+		for (auto& format : formats) {
+			string formatName = core.getEnumName(format);
+			bool depth = (find(depthFormats, depthFormats + 4, format) != depthFormats + 4);
+			GLenum dataFormat = GL_RGBA;
+			GLenum dataType = GL_UNSIGNED_BYTE;
+			if (depth) {
+				dataFormat = (format == GL_DEPTH24_STENCIL8) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+				dataType = (format == GL_DEPTH24_STENCIL8) ? GL_UNSIGNED_INT_24_8 : GL_UNSIGNED_INT;
+			}
+			GLuint texture;
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glPerformanceProbes::clearErrors();
+			int levels = 0;
+			for (int size = textureSize; size > 0; size /= 2) {
+				glTexImage2D(GL_TEXTURE_2D, levels++, format, size, size, 0, dataFormat, dataType, data.data());
+			}
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+			if (glGetError() != GL_NO_ERROR) {
+				probes.addMessage(name(), formatName + " skipped, texture could not be created");
+				glDeleteTextures(1, &texture);
+				continue;
+			}
+
+			// Modes the format doesn't report support for are skipped, modes are tried if support can't be queried
+			bool filter = (glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format, GL_FILTER, GL_FULL_SUPPORT) != GL_NONE);
+			bool gather = (glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format, GL_TEXTURE_GATHER, GL_FULL_SUPPORT) != GL_NONE);
+			bool shadow = (depth) && (glPerformanceProbes::formatSupport(core, GL_TEXTURE_2D, format, GL_TEXTURE_SHADOW, GL_FULL_SUPPORT) != GL_NONE);
+			vector<pair<samplingMode, GLuint>> modes;
+			modes.push_back(make_pair(samplingNearest, sampleProgram));
+			if (filter) {
+				modes.push_back(make_pair(samplingBilinear, sampleProgram));
+				modes.push_back(make_pair(samplingTrilinear, sampleProgram));
+				if (maxAnisotropy > 0.0f) {
+					modes.push_back(make_pair(samplingAnisotropic, sampleProgram));
+				}
+			}
+			if ((gather) && (gatherProgram != 0)) {
+				modes.push_back(make_pair(samplingGather, gatherProgram));
+			}
+			if ((shadow) && (shadowProgram != 0)) {
+				modes.push_back(make_pair(samplingShadow, shadowProgram));
+			}
+
+			double nearestTime = 0.0;
+			for (auto& mode : modes) {
+				glPerformanceProbes::clearErrors();
+				double time = measureMode(probes, texture, mode.second, mode.first, maxAnisotropy);
+				if ((glGetError() != GL_NO_ERROR) || (time <= 0.0)) {
+					probes.addMessage(name(), formatName + " " + modeName(mode.first) + " skipped, draw failed");
+					continue;
+				}
+				if (mode.first == samplingNearest) {
+					nearestTime = time;
+				}
+				probes.addValue(name(), formatName, modeName(mode.first) + "_mfetches_per_s", fetches / time);
+				// Cost of a fetch relative to nearest sampling of the same format
+				if ((mode.first != samplingNearest) && (nearestTime > 0.0)) {
+					probes.addValue(name(), formatName, modeName(mode.first) + "_cost", time / nearestTime);
+				}
+			}
+			glDeleteTextures(1, &texture);
+		}
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteTextures(1, &renderTarget);
+		glDeleteProgram(sampleProgram);
+		glDeleteProgram(shadowProgram);
+		glDeleteProgram(gatherProgram);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	}
+
+}
@@ -0,0 +1,55 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Texture sampling throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	enum samplingMode { samplingNearest, samplingBilinear, samplingTrilinear, samplingAnisotropic, samplingGather, samplingShadow };
+
+	/// <summary>
+	/// Measures texture fetch throughput of fullscreen passes for common color and depth formats with nearest, bilinear, trilinear and anisotropic filtering,
+	/// textureGather and depth compares, each mode only for formats that report support for it (GL_FILTER, GL_TEXTURE_GATHER, GL_TEXTURE_SHADOW)
+	/// </summary>
+	class textureSamplingProbe : public glPerformanceProbe
+	{
+	private:
+		double measureMode(glPerformanceProbes& probes, GLuint texture, GLuint program, samplingMode mode, GLfloat maxAnisotropy);
+	public:
+		// Width and height of the sampled texture (with a full mip chain) and the render target
+		int textureSize = 1024;
+		// Texture fetches per pixel, must match the fetch loop of the shaders
+		int fetchesPerPixel = 8;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static string modeName(samplingMode mode);
+	};
+
+}
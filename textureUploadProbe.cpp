@@ -0,0 +1,217 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Texture upload throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "textureUploadProbe.h"
+#include "glCapsViewerCore.h"
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	string textureUploadProbe::name() const
+	{
+		return "textureupload";
+	}
+
+	bool textureUploadProbe::supported(glCapsViewerCore& core, string& reason) const
+	{
+		if ((!GLEW_VERSION_2_1) && (!GLEW_ARB_pixel_buffer_object)) {
+			reason = "requires OpenGL 2.1 or GL_ARB_pixel_buffer_object";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Client format and type combinations uploaded for an internal format, the preferred combination is added by the probe
+	/// </summary>
+	vector<pair<GLenum, GLenum>> textureUploadProbe::uploadFormats(GLenum internalFormat)
+	{
+		vector<pair<GLenum, GLenum>> formats;
+		switch (internalFormat) {
+		case GL_RED:
+		case GL_RG:
+		case GL_RGB:
+		case GL_RGBA:
+			formats.push_back(make_pair(internalFormat, GL_UNSIGNED_BYTE));
+			formats.push_back(make_pair(internalFormat, GL_FLOAT));
+			if ((internalFormat == GL_RGB) || (internalFormat == GL_RGBA)) {
+				formats.push_back(make_pair(GL_BGRA, GL_UNSIGNED_BYTE));
+				formats.push_back(make_pair(GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV));
+			}
+			break;
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT32F:
+			formats.push_back(make_pair(GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT));
+			formats.push_back(make_pair(GL_DEPTH_COMPONENT, GL_UNSIGNED_INT));
+			formats.push_back(make_pair(GL_DEPTH_COMPONENT, GL_FLOAT));
+			break;
+		case GL_DEPTH_STENCIL:
+			formats.push_back(make_pair(GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8));
+			formats.push_back(make_pair(GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV));
+			break;
+		case GL_STENCIL_INDEX:
+			formats.push_back(make_pair(GL_STENCIL_INDEX, GL_UNSIGNED_BYTE));
+			break;
+		}
+		return formats;
+	}
+
+	/// <summary>
+	/// Uploads the whole texture level a number of times per sample
+	/// Unpack buffer uploads orphan the buffer and copy the data into it before each upload, as streaming applications do
+	/// </summary>
+	/// <param name="buffer">Pixel unpack buffer to upload from, 0 for client memory</param>
+	/// <returns>Median throughput in MB/s (10^6 bytes), 0 if the upload failed</returns>
+	double textureUploadProbe::measureUpload(glPerformanceProbes& probes, GLenum format, GLenum type, const vector<unsigned char>& data, GLuint buffer)
+	{
+		auto upload = [&]() {
+			for (int i = 0; i < uploadsPerSample; i++) {
+				if (buffer != 0) {
+					glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+					glBufferData(GL_PIXEL_UNPACK_BUFFER, data.size(), nullptr, GL_STREAM_DRAW);
+					glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, data.size(), data.data());
+					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureSize, textureSize, format, type, nullptr);
+					glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				}
+				else {
+					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureSize, textureSize, format, type, data.data());
+				}
+			}
+		};
+
+		// Warm up, first uploads may include allocation and format conversion setup
+		glPerformanceProbes::clearErrors();
+		glPerformanceProbes::timeFinished(upload);
+		if (glGetError() != GL_NO_ERROR) {
+			return 0.0;
+		}
+		probeSamples samples;
+		for (int i = 0; i < probes.sampleCount; i++) {
+			samples.add(glPerformanceProbes::timeFinished(upload));
+		}
+		double time = samples.median();
+		return (time > 0.0) ? (double)data.size() * uploadsPerSample / time : 0.0;
+	}
+
+	void textureUploadProbe::run(glCapsViewerCore& core, glPerformanceProbes& probes)
+	{
+		// Supported uncompressed formats with the preferred client format and type, if the driver reports them
+		vector<GLenum> internalFormats;
+		vector<pair<GLenum, GLenum>> preferredFormats;
+		const internalFormatTarget* target = core.getInternalFormatTarget(GL_TEXTURE_2D);
+		if (target != nullptr) {
+			for (auto& textureFormat : target->textureFormats) {
+				GLint compressed = GL_FALSE;
+				textureFormat.getValue(GL_TEXTURE_COMPRESSED, compressed);
+				if ((!textureFormat.supported) || (compressed == GL_TRUE) || (uploadFormats(textureFormat.textureFormat).empty())) {
+					continue;
+				}
+				GLint imageFormat = 0;
+				GLint imageType = 0;
+				textureFormat.getValue(GL_TEXTURE_IMAGE_FORMAT, imageFormat);
+				textureFormat.getValue(GL_TEXTURE_IMAGE_TYPE, imageType);
+				internalFormats.push_back(textureFormat.textureFormat);
+				preferredFormats.push_back(make_pair((GLenum)imageFormat, (GLenum)imageType));
+			}
+		}
+		else {
+			// Without internal format information only the color formats every implementation supports are probed
+			GLenum colorFormats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+			for (auto& colorFormat : colorFormats) {
+				internalFormats.push_back(colorFormat);
+				preferredFormats.push_back(make_pair(0, 0));
+			}
+		}
+
+		GLint unpackAlignment;
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		GLuint texture;
+		GLuint buffer;
+		glGenTextures(1, &texture);
+		glGenBuffers(1, &buffer);
+		// Client memory uploads read from the pointer only without a bound unpack buffer, the caller's binding is restored by glPerformanceProbes
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		for (size_t f = 0; f < internalFormats.size(); f++) {
+			GLenum internalFormat = internalFormats[f];
+			pair<GLenum, GLenum> preferred = preferredFormats[f];
+			vector<pair<GLenum, GLenum>> formats = uploadFormats(internalFormat);
+			if ((preferred.first != 0) && (preferred.second != 0) && (find(formats.begin(), formats.end(), preferred) == formats.end())) {
+				formats.insert(formats.begin(), preferred);
+			}
+
+			double bestPreferred = 0.0;
+			double bestOther = 0.0;
+			for (auto& format : formats) {
+				string caseName = core.getEnumName(internalFormat) + " " + core.getEnumName(format.first) + " " + core.getEnumName(format.second);
+				size_t pixelSize = glPerformanceProbes::pixelSize(format.first, format.second);
+				if (pixelSize == 0) {
+					probes.addMessage(name(), caseName + " skipped, unknown pixel size");
+					continue;
+				}
+				glPerformanceProbes::clearErrors();
+				glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, textureSize, textureSize, 0, format.first, format.second, nullptr);
+				if (glGetError() != GL_NO_ERROR) {
+					probes.addMessage(name(), caseName + " skipped, texture could not be created");
+					continue;
+				}
+				// Pattern instead of zeros, so implementations can't take shortcuts for cleared data
+				vector<unsigned char> data(pixelSize * textureSize * textureSize);
+				for (size_t i = 0; i < data.size(); i++) {
+					data[i] = (unsigned char)(i * 7 + i / 251);
+				}
+				double direct = measureUpload(probes, format.first, format.second, data, 0);
+				double unpackBuffer = measureUpload(probes, format.first, format.second, data, buffer);
+				if ((direct == 0.0) || (unpackBuffer == 0.0)) {
+					probes.addMessage(name(), caseName + " skipped, upload failed");
+					continue;
+				}
+				bool isPreferred = (format == preferred);
+				probes.addValue(name(), caseName, "direct_mbps", direct);
+				probes.addValue(name(), caseName, "pbo_mbps", unpackBuffer);
+				probes.addValue(name(), caseName, "preferred", isPreferred ? 1.0 : 0.0);
+				double best = max(direct, unpackBuffer);
+				if (isPreferred) {
+					bestPreferred = max(bestPreferred, best);
+				}
+				else {
+					bestOther = max(bestOther, best);
+				}
+			}
+			// Below 1 if a non preferred combination uploads faster than the preferred one
+			if ((bestPreferred > 0.0) && (bestOther > 0.0)) {
+				probes.addValue(name(), core.getEnumName(internalFormat), "preferred_ratio", bestPreferred / bestOther);
+			}
+		}
+
+		glDeleteTextures(1, &texture);
+		glDeleteBuffers(1, &buffer);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	}
+
+}
@@ -0,0 +1,54 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Texture upload throughput probe
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "glPerformanceProbe.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Measures glTexSubImage2D throughput on GL_TEXTURE_2D for every supported uncompressed format
+	/// Each format is uploaded with the format and type preferred by the driver (GL_TEXTURE_IMAGE_FORMAT/TYPE) and with common alternatives,
+	/// both from client memory and from a pixel unpack buffer
+	/// </summary>
+	class textureUploadProbe : public glPerformanceProbe
+	{
+	private:
+		double measureUpload(glPerformanceProbes& probes, GLenum format, GLenum type, const vector<unsigned char>& data, GLuint buffer);
+	public:
+		// Width and height of the uploaded texture
+		int textureSize = 512;
+		// Uploads per timed sample
+		int uploadsPerSample = 4;
+		string name() const;
+		bool supported(glCapsViewerCore& core, string& reason) const;
+		void run(glCapsViewerCore& core, glPerformanceProbes& probes);
+		static vector<pair<GLenum, GLenum>> uploadFormats(GLenum internalFormat);
+	};
+
+}
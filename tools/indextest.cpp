@@ -0,0 +1,152 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Report index import test, importing the same reports twice must not add duplicates and different reports with the same file name must not be lost
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <iostream>
+
+#include "reportGenerator.h"
+#include "reportAggregator.h"
+#include "reportCache.h"
+#include "reportIndex.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_indextest [options]\n\n";
+	cout << "Imports a directory of synthetic reports into the report index twice (like the import button of the database tab)\n\n";
+	cout << "  --reports <n>          Number of reports to import (default 50)\n";
+	cout << "  --capslist <file>      Capability list (default capslist.xml)\n";
+}
+
+/// <summary>
+/// Copies all reports of a directory to the cache and indexes them, same as glCapsViewer::slotImportReports
+/// </summary>
+int importDirectory(reportCache& cache, reportIndex& index, const string& directory)
+{
+	vector<string> cachedFiles;
+	for (auto& fileName : reportAggregator::findReports(directory)) {
+		string cachedFile = cache.importFile(fileName);
+		if (!cachedFile.empty()) {
+			cachedFiles.push_back(cachedFile);
+		}
+	}
+	return index.importFiles(cachedFiles, reportCache::reportId);
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	int reportCount = 50;
+	string capsListFile = "capslist.xml";
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--reports") && hasValue) {
+			reportCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+
+	reportGeneratorSettings settings;
+	settings.deviceCount = reportCount;
+	settings.reportsPerDevice = 1.0;
+	reportGenerator generator(settings);
+	if (!generator.capDefinitions.loadFromFile(capsListFile)) {
+		cerr << "Could not load capability list " << capsListFile << "\n";
+		return -1;
+	}
+	generator.generateDevices();
+
+	QTemporaryDir reportDir;
+	QTemporaryDir cacheDir;
+	int written = generator.writeReports(reportDir.path().toStdString(), reportCount);
+	reportCache cache(cacheDir.path().toStdString());
+	reportIndex index;
+
+	int firstImport = importDirectory(cache, index, reportDir.path().toStdString());
+	int secondImport = importDirectory(cache, index, reportDir.path().toStdString());
+	cout << "Imported " << firstImport << " of " << written << " reports, " << secondImport << " on the second import, " << index.reports.size() << " reports indexed\n";
+
+	bool passed = true;
+	if (firstImport != written) {
+		cerr << "FAILED: first import added " << firstImport << " of " << written << " reports\n";
+		passed = false;
+	}
+	if (secondImport != 0) {
+		cerr << "FAILED: second import added " << secondImport << " duplicate reports\n";
+		passed = false;
+	}
+	if (index.reports.size() != (size_t)written) {
+		cerr << "FAILED: index contains " << index.reports.size() << " reports instead of " << written << "\n";
+		passed = false;
+	}
+
+	// Different reports with the same file names (another generator seed) must be added, not mistaken for the already imported ones
+	reportGeneratorSettings otherSettings = settings;
+	otherSettings.seed = settings.seed + 1;
+	reportGenerator otherGenerator(otherSettings);
+	otherGenerator.capDefinitions = generator.capDefinitions;
+	otherGenerator.generateDevices();
+	QTemporaryDir otherReportDir;
+	int otherWritten = otherGenerator.writeReports(otherReportDir.path().toStdString(), reportCount);
+	int otherImport = importDirectory(cache, index, otherReportDir.path().toStdString());
+	cout << "Imported " << otherImport << " of " << otherWritten << " different reports with the same file names\n";
+	if ((otherImport != otherWritten) || (index.reports.size() != (size_t)(written + otherWritten))) {
+		cerr << "FAILED: " << otherImport << " of " << otherWritten << " different reports with the same file names have been imported\n";
+		passed = false;
+	}
+	written += otherWritten;
+
+	// The cache is indexed on startup, imported reports must not be added again either
+	reportIndex reloadedIndex;
+	reloadedIndex.importFiles(cache.fileNames(), reportCache::reportId);
+	int reimport = importDirectory(cache, reloadedIndex, reportDir.path().toStdString()) + importDirectory(cache, reloadedIndex, otherReportDir.path().toStdString());
+	if ((reimport != 0) || (reloadedIndex.reports.size() != (size_t)written)) {
+		cerr << "FAILED: importing into an index loaded from the cache added " << reimport << " reports\n";
+		passed = false;
+	}
+
+	// Report order must not depend on thread timing, a single threaded import is the reference
+	reportIndex serialIndex;
+	serialIndex.importFiles(cache.fileNames(), reportCache::reportId, nullptr, 1);
+	bool sameOrder = (serialIndex.reports.size() == reloadedIndex.reports.size());
+	for (size_t i = 0; (sameOrder) && (i < serialIndex.reports.size()); i++) {
+		sameOrder = (serialIndex.reports[i].fileName == reloadedIndex.reports[i].fileName);
+	}
+	if (!sameOrder) {
+		cerr << "FAILED: threaded import added the reports in a different order than a single threaded import\n";
+		passed = false;
+	}
+
+	return passed ? 0 : -1;
+}
@@ -0,0 +1,610 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Local stand-in for the OpenGL hardware database web services
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "localDatabaseServer.h"
+#include <QUrl>
+#include <QUrlQuery>
+#include <QTimer>
+#include <QPointer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Returns the percent decoded value of a query item ("+" is not treated as a space, as the client encodes it as %2B)
+	/// </summary>
+	string localHttpRequest::queryValue(const string& name) const
+	{
+		QUrlQuery urlQuery(QString::fromStdString(query));
+		return urlQuery.queryItemValue(QString::fromStdString(name), QUrl::FullyDecoded).toStdString();
+	}
+
+	/// <summary>
+	/// Returns the contents of a multipart/form-data field, or the whole body for other content types
+	/// Compressed fields (application/zlib) are decompressed using the uncompressed size sent in the "size" field
+	/// </summary>
+	QByteArray localHttpRequest::formData(const string& name) const
+	{
+		auto contentType = headers.find("content-type");
+		if ((contentType == headers.end()) || (contentType->second.find("multipart/form-data") == string::npos)) {
+			return body;
+		}
+		size_t boundaryPos = contentType->second.find("boundary=");
+		if (boundaryPos == string::npos) {
+			return QByteArray();
+		}
+		string boundary = "--" + contentType->second.substr(boundaryPos + 9);
+		boundary.erase(remove(boundary.begin(), boundary.end(), '"'), boundary.end());
+		string fieldName = "name=\"" + name + "\"";
+
+		int partStart = body.indexOf(boundary.c_str());
+		while (partStart > -1) {
+			int headerStart = partStart + (int)boundary.size() + 2;
+			int headerEnd = body.indexOf("\r\n\r\n", headerStart);
+			if (headerEnd < 0) {
+				break;
+			}
+			int partEnd = body.indexOf(("\r\n" + boundary).c_str(), headerEnd);
+			if (partEnd < 0) {
+				break;
+			}
+			QByteArray partHeader = body.mid(headerStart, headerEnd - headerStart);
+			if (partHeader.contains(fieldName.c_str())) {
+				QByteArray data = body.mid(headerEnd + 4, partEnd - headerEnd - 4);
+				if (partHeader.toLower().contains("application/zlib")) {
+					// Restore the size prefix expected by qUncompress
+					uint size = formData("size").toUInt();
+					QByteArray prefix(4, 0);
+					prefix[0] = (char)((size >> 24) & 0xff);
+					prefix[1] = (char)((size >> 16) & 0xff);
+					prefix[2] = (char)((size >> 8) & 0xff);
+					prefix[3] = (char)(size & 0xff);
+					data = qUncompress(prefix + data);
+				}
+				return data;
+			}
+			partStart = partEnd + 2;
+		}
+		return QByteArray();
+	}
+
+	/// <summary>
+	/// Reads a report in either layout, renderer and version are taken from the caps
+	/// </summary>
+	bool databaseReport::fromXml(const string& xml)
+	{
+		bool valid = reportData::fromXml(xml);
+		renderer = getCap("GL_RENDERER");
+		version = getCap("GL_VERSION");
+		return valid;
+	}
+
+	/// <summary>
+	/// Writes the report as returned by gl_getreport.php
+	/// </summary>
+	string databaseReport::toDatabaseXml()
+	{
+		// The client parses these without skipping whitespace, so no auto formatting
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("report");
+
+		xmlWriter.writeStartElement("implementation");
+		for (auto& cap : caps) {
+			xmlWriter.writeStartElement("cap");
+			xmlWriter.writeAttribute("id", QString::fromStdString(cap.first));
+			xmlWriter.writeCharacters(QString::fromStdString(cap.second));
+			xmlWriter.writeEndElement();
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("extensions");
+		for (auto& ext : extensions) {
+			xmlWriter.writeTextElement("extension", QString::fromStdString(ext));
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("compressedtextureformats");
+		for (auto& compressedFormat : compressedFormats) {
+			xmlWriter.writeTextElement("compressedtextureformat", QString::number(compressedFormat));
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	/// <summary>
+	/// Creates the server, the synthetic reports of the generator are the initial database contents
+	/// </summary>
+	/// <param name="settings">Port and latency/error injection settings</param>
+	/// <param name="generator">Generator with generated devices, must outlive the server</param>
+	localDatabaseServer::localDatabaseServer(localServerSettings settings, reportGenerator* generator, QObject* parent) : QObject(parent)
+	{
+		this->settings = settings;
+		this->generator = generator;
+		rng.seed(settings.seed);
+		for (size_t d = 0; d < generator->devices.size(); d++) {
+			for (int r = 0; r < generator->devices[d].reportCount; r++) {
+				reportIds[generator->reportDescription((int)d, r)] = generator->devices[d].firstReportId + r;
+			}
+		}
+		nextReportId = generator->reportCount() + 1;
+		connect(&server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()));
+	}
+
+	bool localDatabaseServer::start()
+	{
+		return server.listen(QHostAddress::Any, settings.port);
+	}
+
+	quint16 localDatabaseServer::port()
+	{
+		return server.serverPort();
+	}
+
+	string localDatabaseServer::errorString()
+	{
+		return server.errorString().toStdString();
+	}
+
+	void localDatabaseServer::slotNewConnection()
+	{
+		while (server.hasPendingConnections()) {
+			QTcpSocket* socket = server.nextPendingConnection();
+			requestBuffers[socket] = QByteArray();
+			connect(socket, SIGNAL(readyRead()), this, SLOT(slotReadyRead()));
+			connect(socket, SIGNAL(disconnected()), this, SLOT(slotDisconnected()));
+		}
+	}
+
+	void localDatabaseServer::slotReadyRead()
+	{
+		QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+		QByteArray& buffer = requestBuffers[socket];
+		buffer.append(socket->readAll());
+		localHttpRequest request;
+		while (parseRequest(buffer, request)) {
+			handleRequest(socket, request);
+			request = localHttpRequest();
+		}
+	}
+
+	void localDatabaseServer::slotDisconnected()
+	{
+		QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+		requestBuffers.erase(socket);
+		socket->deleteLater();
+	}
+
+	/// <summary>
+	/// Takes a complete request from the front of the connection buffer
+	/// </summary>
+	/// <returns>false if the buffer does not yet contain a complete request</returns>
+	bool localDatabaseServer::parseRequest(QByteArray& buffer, localHttpRequest& request)
+	{
+		int headerEnd = buffer.indexOf("\r\n\r\n");
+		if (headerEnd < 0) {
+			return false;
+		}
+
+		stringstream header(string(buffer.constData(), headerEnd));
+		string line;
+		getline(header, line);
+		stringstream requestLine(line);
+		string target;
+		requestLine >> request.method >> target;
+		while (getline(header, line)) {
+			size_t separator = line.find(':');
+			if (separator == string::npos) {
+				continue;
+			}
+			string name = line.substr(0, separator);
+			transform(name.begin(), name.end(), name.begin(), ::tolower);
+			string value = line.substr(separator + 1);
+			value.erase(0, value.find_first_not_of(" \t"));
+			value.erase(value.find_last_not_of(" \t\r") + 1);
+			request.headers[name] = value;
+		}
+
+		int contentLength = 0;
+		if (request.headers.count("content-length") > 0) {
+			contentLength = atoi(request.headers["content-length"].c_str());
+		}
+		if (buffer.size() < headerEnd + 4 + contentLength) {
+			return false;
+		}
+		request.body = buffer.mid(headerEnd + 4, contentLength);
+		buffer = buffer.mid(headerEnd + 4 + contentLength);
+
+		size_t queryPos = target.find('?');
+		if (queryPos != string::npos) {
+			request.query = target.substr(queryPos + 1);
+			target = target.substr(0, queryPos);
+		}
+		for (auto c : target) {
+			if ((c != '/') || (request.path.empty()) || (request.path.back() != '/')) {
+				request.path += c;
+			}
+		}
+		return true;
+	}
+
+	void localDatabaseServer::handleRequest(QTcpSocket* socket, const localHttpRequest& request)
+	{
+		auto handlingStart = chrono::high_resolution_clock::now();
+		auto connection = request.headers.find("connection");
+		bool keepAlive = (connection == request.headers.end()) || (connection->second.find("close") == string::npos);
+
+		auto endsWith = [&request](const string& endpoint) {
+			return (request.path.size() >= endpoint.size()) && (request.path.compare(request.path.size() - endpoint.size(), endpoint.size(), endpoint) == 0);
+		};
+
+		// Server statistics are not subject to error injection
+		if (endsWith("/stats")) {
+			sendResponse(socket, 200, "application/json", statsToJson(), keepAlive);
+			return;
+		}
+
+		const char* endpoints[] = { "services/gl_serverstate.php", "gl_checkreport.php", "services/gl_getreport.php", "services/gl_getdevices.php", "services/gl_getdevicereports.php",
+			"services/gl_convertreport.php", "services/gl_updatereport.php", "files/capslist.xml", "gl_generatereport.php" };
+		string endpoint;
+		for (auto& name : endpoints) {
+			if (endsWith(name)) {
+				endpoint = name;
+				break;
+			}
+		}
+		localEndpointStats& endpointStats = stats[endpoint.empty() ? "unknown" : endpoint];
+		endpointStats.requests++;
+		endpointStats.bytesIn += request.body.size();
+
+		uniform_real_distribution<double> chance(0.0, 1.0);
+		if (chance(rng) < settings.timeoutRate) {
+			endpointStats.timeouts++;
+			QPointer<QTcpSocket> guard(socket);
+			QTimer::singleShot(settings.timeoutDelay, this, [guard]() {
+				if (guard) {
+					guard->disconnectFromHost();
+				}
+			});
+			return;
+		}
+		if (chance(rng) < settings.errorRate) {
+			endpointStats.errors++;
+			sendResponse(socket, 500, "text/plain", "Internal server error (injected)", keepAlive);
+			return;
+		}
+		// Script errors are reported by php with status 200
+		if (((endpoint == "services/gl_convertreport.php") || (endpoint == "services/gl_updatereport.php")) && (chance(rng) < settings.errorBodyRate)) {
+			endpointStats.errors++;
+			sendResponse(socket, 200, "text/html", "<br />\n<b>Fatal error</b>:  Uncaught PDOException (injected) in " + endpoint + "<br />\n", keepAlive);
+			return;
+		}
+
+		int status = 200;
+		string contentType = "text/xml";
+		string body;
+		if (endpoint == "services/gl_serverstate.php") {
+			contentType = "text/plain";
+			// Advertises support for zlib compressed report updates
+			body = "ok\ncompressed_updates";
+		}
+		else if (endpoint == "gl_checkreport.php") {
+			contentType = "text/plain";
+			auto reportId = reportIds.find(request.queryValue("description"));
+			body = to_string((reportId != reportIds.end()) ? reportId->second : -1);
+		}
+		else if (endpoint == "services/gl_getreport.php") {
+			databaseReport* report = getReport(atoi(request.queryValue("reportId").c_str()));
+			if (report != nullptr) {
+				body = report->toDatabaseXml();
+			}
+			else {
+				status = 404;
+			}
+		}
+		else if (endpoint == "services/gl_getdevices.php") {
+			body = deviceListXml();
+		}
+		else if (endpoint == "services/gl_getdevicereports.php") {
+			body = deviceReportsXml(request.queryValue("glrenderer"));
+		}
+		else if (endpoint == "services/gl_convertreport.php") {
+			contentType = "text/plain";
+			body = uploadReport(request.formData("data"));
+		}
+		else if (endpoint == "services/gl_updatereport.php") {
+			contentType = "text/plain";
+			body = updateReport(request.formData("data"));
+		}
+		else if (endpoint == "files/capslist.xml") {
+			body = capsListXml;
+		}
+		else if (endpoint == "gl_generatereport.php") {
+			contentType = "text/html";
+			body = reportHtml(atoi(request.queryValue("reportID").c_str()));
+		}
+		else {
+			status = 404;
+		}
+
+		if (status != 200) {
+			contentType = "text/plain";
+			body = "Not found";
+		}
+		endpointStats.bytesOut += body.size();
+		endpointStats.handlingTime += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - handlingStart).count();
+		sendResponse(socket, status, contentType, body, keepAlive);
+	}
+
+	/// <summary>
+	/// Writes the response to the socket after the configured latency
+	/// </summary>
+	void localDatabaseServer::sendResponse(QTcpSocket* socket, int status, const string& contentType, const string& body, bool keepAlive)
+	{
+		string statusText = (status == 200) ? "OK" : (status == 404) ? "Not Found" : "Internal Server Error";
+		stringstream ss;
+		ss << "HTTP/1.1 " << status << " " << statusText << "\r\n";
+		ss << "Content-Type: " << contentType << "; charset=utf-8\r\n";
+		ss << "Content-Length: " << body.size() << "\r\n";
+		ss << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+		ss << body;
+		QByteArray response(ss.str().c_str(), (int)ss.str().size());
+
+		int delay = settings.latency;
+		if (settings.jitter > 0) {
+			delay += uniform_int_distribution<int>(0, settings.jitter)(rng);
+		}
+
+		QPointer<QTcpSocket> guard(socket);
+		auto send = [guard, response, keepAlive]() {
+			if (guard) {
+				guard->write(response);
+				if (!keepAlive) {
+					guard->disconnectFromHost();
+				}
+			}
+		};
+		if (delay > 0) {
+			QTimer::singleShot(delay, this, send);
+		}
+		else {
+			send();
+		}
+	}
+
+	/// <summary>
+	/// Returns a report from the store, synthetic reports that have not been modified are generated on the fly
+	/// </summary>
+	/// <returns>Pointer to the report (valid until the next call) or nullptr if there is no report with that id</returns>
+	databaseReport* localDatabaseServer::getReport(int reportId)
+	{
+		auto report = reports.find(reportId);
+		if (report != reports.end()) {
+			return &report->second;
+		}
+
+		syntheticReportInfo info = generator->getReportInfo(reportId);
+		if (info.deviceIndex < 0) {
+			return nullptr;
+		}
+		glCapsViewerCore core;
+		generator->fillCore(core, info.deviceIndex, info.reportIndex);
+		generatedReport = databaseReport();
+		generatedReport.fromXml(generator->databaseReportXml(core, reportId));
+		generatedReport.reportId = reportId;
+		generatedReport.description = core.description;
+		generatedReport.renderer = core.implementation["Renderer"];
+		generatedReport.version = info.version;
+		generatedReport.operatingSystem = info.operatingSystem;
+		return &generatedReport;
+	}
+
+	/// <summary>
+	/// Stores an uploaded report (gl_convertreport.php)
+	/// </summary>
+	/// <returns>"res_uploaded" on success, error message otherwise</returns>
+	string localDatabaseServer::uploadReport(const QByteArray& xml)
+	{
+		databaseReport report;
+		if ((!report.fromXml(string(xml.constData(), xml.size()))) || (report.description.empty())) {
+			return "Invalid report";
+		}
+		if (reportIds.count(report.description) > 0) {
+			return "Report already present";
+		}
+		report.reportId = nextReportId++;
+		reportIds[report.description] = report.reportId;
+		uploadedDeviceReports[report.renderer].push_back(report.reportId);
+		reports[report.reportId] = report;
+		accepted++;
+		return "res_uploaded";
+	}
+
+	/// <summary>
+	/// Fills caps and compressed formats missing in the stored report with those of the uploaded one (gl_updatereport.php)
+	/// </summary>
+	/// <returns>"res_updated" and the comma separated list of the updated caps on success, error message otherwise</returns>
+	string localDatabaseServer::updateReport(const QByteArray& xml)
+	{
+		databaseReport update;
+		if ((!update.fromXml(string(xml.constData(), xml.size()))) || (update.description.empty())) {
+			return "Invalid report";
+		}
+		auto reportId = reportIds.find(update.description);
+		if (reportId == reportIds.end()) {
+			return "Report not present";
+		}
+		// Modified synthetic reports become part of the store
+		databaseReport* report = getReport(reportId->second);
+		if (reports.count(reportId->second) == 0) {
+			reports[reportId->second] = *report;
+			report = &reports[reportId->second];
+		}
+
+		reportDiff diff;
+		diff.compare(*report, update);
+		vector<string> updated;
+		map<string, size_t> capIndices;
+		for (size_t i = 0; i < report->caps.size(); i++) {
+			capIndices[report->caps[i].first] = i;
+		}
+		for (auto& entry : diff.entries) {
+			if ((entry.section == diffSectionCaps) && ((entry.type == diffMissing) || (entry.type == diffAdded))) {
+				auto capIndex = capIndices.find(entry.name);
+				if (capIndex != capIndices.end()) {
+					report->caps[capIndex->second].second = entry.otherValue;
+				}
+				else {
+					report->caps.push_back(make_pair(entry.name, entry.otherValue));
+				}
+				updated.push_back(entry.name);
+			}
+			if ((entry.section == diffSectionCompressedFormats) && (entry.type == diffAdded)) {
+				report->compressedFormats.push_back(atoi(entry.name.c_str()));
+				updated.push_back(entry.name);
+			}
+		}
+
+		accepted++;
+		stringstream ss;
+		ss << "res_updated\n";
+		for (size_t i = 0; i < updated.size(); i++) {
+			ss << ((i > 0) ? "," : "") << updated[i];
+		}
+		return ss.str();
+	}
+
+	string localDatabaseServer::deviceListXml()
+	{
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("devices");
+		for (auto& device : generator->devices) {
+			xmlWriter.writeTextElement("device", QString::fromStdString(device.renderer));
+		}
+		for (auto& device : uploadedDeviceReports) {
+			if (generator->findDevice(device.first) < 0) {
+				xmlWriter.writeTextElement("device", QString::fromStdString(device.first));
+			}
+		}
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	string localDatabaseServer::deviceReportsXml(const string& renderer)
+	{
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("reports");
+		int deviceIndex = generator->findDevice(renderer);
+		if (deviceIndex > -1) {
+			for (auto& report : generator->getDeviceReports(deviceIndex)) {
+				xmlWriter.writeStartElement("report");
+				xmlWriter.writeAttribute("id", QString::number(report.reportId));
+				xmlWriter.writeAttribute("os", QString::fromStdString(report.operatingSystem));
+				xmlWriter.writeCharacters(QString::fromStdString(report.version));
+				xmlWriter.writeEndElement();
+			}
+		}
+		auto uploaded = uploadedDeviceReports.find(renderer);
+		if (uploaded != uploadedDeviceReports.end()) {
+			for (auto& reportId : uploaded->second) {
+				databaseReport& report = reports[reportId];
+				xmlWriter.writeStartElement("report");
+				xmlWriter.writeAttribute("id", QString::number(reportId));
+				xmlWriter.writeAttribute("os", QString::fromStdString(report.operatingSystem));
+				xmlWriter.writeCharacters(QString::fromStdString(report.version));
+				xmlWriter.writeEndElement();
+			}
+		}
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	/// <summary>
+	/// Minimal html version of a report, stands in for the report page opened in the browser
+	/// </summary>
+	string localDatabaseServer::reportHtml(int reportId)
+	{
+		databaseReport* report = getReport(reportId);
+		if (report == nullptr) {
+			return "<html><body>Unknown report</body></html>";
+		}
+		QString html = "<html><head><title>" + QString::fromStdString(report->description).toHtmlEscaped() + "</title></head><body>";
+		html += "<h1>" + QString::fromStdString(report->description).toHtmlEscaped() + "</h1><table>";
+		for (auto& cap : report->caps) {
+			html += "<tr><td>" + QString::fromStdString(cap.first) + "</td><td>" + QString::fromStdString(cap.second).toHtmlEscaped() + "</td></tr>";
+		}
+		html += "</table><h2>Extensions</h2><ul>";
+		for (auto& ext : report->extensions) {
+			html += "<li>" + QString::fromStdString(ext) + "</li>";
+		}
+		html += "</ul></body></html>";
+		return html.toStdString();
+	}
+
+	/// <summary>
+	/// Converts the per endpoint request statistics to json (served at /stats)
+	/// </summary>
+	string localDatabaseServer::statsToJson()
+	{
+		stringstream ss;
+		ss << fixed << setprecision(3);
+		ss << "{\n";
+		ss << "  \"server\": \"glcapsviewer_localserver\",\n";
+		ss << "  \"reports\": " << nextReportId - 1 << ",\n";
+		ss << "  \"uploaded\": " << nextReportId - 1 - generator->reportCount() << ",\n";
+		ss << "  \"endpoints\": [\n";
+		size_t index = 0;
+		for (auto& endpoint : stats) {
+			localEndpointStats& endpointStats = endpoint.second;
+			ss << "    {";
+			ss << "\"name\": \"" << endpoint.first << "\", ";
+			ss << "\"requests\": " << endpointStats.requests << ", ";
+			ss << "\"errors\": " << endpointStats.errors << ", ";
+			ss << "\"timeouts\": " << endpointStats.timeouts << ", ";
+			ss << "\"bytes_in\": " << endpointStats.bytesIn << ", ";
+			ss << "\"bytes_out\": " << endpointStats.bytesOut << ", ";
+			ss << "\"handling_ms\": " << endpointStats.handlingTime;
+			ss << "}" << ((++index < stats.size()) ? "," : "") << "\n";
+		}
+		ss << "  ]\n";
+		ss << "}\n";
+		return ss.str();
+	}
+
+}
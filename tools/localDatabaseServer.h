@@ -0,0 +1,138 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Local stand-in for the OpenGL hardware database web services
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include "reportGenerator.h"
+#include "reportDiff.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class localServerSettings
+	{
+	public:
+		quint16 port = 8080;
+		// Delay added to every response in ms, plus a uniformly distributed jitter
+		int latency = 0;
+		int jitter = 0;
+		// Fraction of requests answered with an internal server error
+		double errorRate = 0.0;
+		// Fraction of requests that are never answered, the connection is dropped after timeoutDelay ms
+		double timeoutRate = 0.0;
+		// Fraction of report uploads and updates answered with http 200 and a php error message instead of being stored
+		double errorBodyRate = 0.0;
+		int timeoutDelay = 30000;
+		// Seed for latency and error injection
+		unsigned int seed = 1;
+	};
+
+	class localHttpRequest
+	{
+	public:
+		string method;
+		// Path with duplicate slashes collapsed (the client requests e.g. "//files/capslist.xml")
+		string path;
+		string query;
+		map<string, string> headers;
+		QByteArray body;
+		string queryValue(const string& name) const;
+		QByteArray formData(const string& name) const;
+	};
+
+	class localEndpointStats
+	{
+	public:
+		int requests = 0;
+		int errors = 0;
+		int timeouts = 0;
+		qint64 bytesIn = 0;
+		qint64 bytesOut = 0;
+		// Time spent generating responses (without injected latency) in ms
+		double handlingTime = 0.0;
+	};
+
+	/// <summary>
+	/// Report in the database layout as returned by gl_getreport.php
+	/// </summary>
+	class databaseReport : public reportData
+	{
+	public:
+		int reportId = -1;
+		string renderer;
+		string version;
+		bool fromXml(const string& xml);
+		string toDatabaseXml();
+	};
+
+	class localDatabaseServer : public QObject
+	{
+		Q_OBJECT
+	private:
+		QTcpServer server;
+		map<QTcpSocket*, QByteArray> requestBuffers;
+		mt19937 rng;
+		reportGenerator* generator;
+		// Reports that have been uploaded or updated, synthetic reports are generated on request
+		map<int, databaseReport> reports;
+		map<string, int> reportIds;
+		map<string, vector<int>> uploadedDeviceReports;
+		// Last synthetic report returned by getReport
+		databaseReport generatedReport;
+		int nextReportId;
+		bool parseRequest(QByteArray& buffer, localHttpRequest& request);
+		void handleRequest(QTcpSocket* socket, const localHttpRequest& request);
+		void sendResponse(QTcpSocket* socket, int status, const string& contentType, const string& body, bool keepAlive);
+		databaseReport* getReport(int reportId);
+		string uploadReport(const QByteArray& xml);
+		string updateReport(const QByteArray& xml);
+		string deviceListXml();
+		string deviceReportsXml(const string& renderer);
+		string reportHtml(int reportId);
+	private slots:
+		void slotNewConnection();
+		void slotReadyRead();
+		void slotDisconnected();
+	public:
+		localServerSettings settings;
+		// Served as files/capslist.xml
+		string capsListXml;
+		map<string, localEndpointStats> stats;
+		// Report uploads and updates that have been stored
+		int accepted = 0;
+		localDatabaseServer(localServerSettings settings, reportGenerator* generator, QObject* parent = 0);
+		bool start();
+		quint16 port();
+		string errorString();
+		string statsToJson();
+	};
+
+}
@@ -0,0 +1,120 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Local database server for offline upload, concurrency and timeout testing
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+#include "localDatabaseServer.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_localserver [options]\n\n";
+	cout << "Serves the database web services from memory, start glcapsviewer with -database http://localhost:<port>/\n\n";
+	cout << "  --port <n>                 Port to listen on (default 8080)\n";
+	cout << "  --latency <ms>             Delay added to every response (default 0)\n";
+	cout << "  --jitter <ms>              Random additional delay of up to ms (default 0)\n";
+	cout << "  --error-rate <f>           Fraction of requests answered with http 500 (default 0)\n";
+	cout << "  --timeout-rate <f>         Fraction of requests that are never answered (default 0)\n";
+	cout << "  --error-body-rate <f>      Fraction of uploads and updates answered with http 200 and a php error (default 0)\n";
+	cout << "  --timeout-delay <ms>       Time after which unanswered connections are closed (default 30000)\n";
+	cout << "  --seed <n>                 Seed for the synthetic reports (default 42)\n";
+	cout << "  --devices <n>              Number of synthetic devices (default 100)\n";
+	cout << "  --reports-per-device <n>   Mean number of reports per device (default 3)\n";
+	cout << "  --capslist <file>          Capability list served and used for synthetic reports (default capslist.xml)\n";
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	localServerSettings serverSettings;
+	reportGeneratorSettings generatorSettings;
+	string capsListFile = "capslist.xml";
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--port") && hasValue) {
+			serverSettings.port = args[++i].toInt();
+		}
+		else if ((args[i] == "--latency") && hasValue) {
+			serverSettings.latency = args[++i].toInt();
+		}
+		else if ((args[i] == "--jitter") && hasValue) {
+			serverSettings.jitter = args[++i].toInt();
+		}
+		else if ((args[i] == "--error-rate") && hasValue) {
+			serverSettings.errorRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--timeout-rate") && hasValue) {
+			serverSettings.timeoutRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--error-body-rate") && hasValue) {
+			serverSettings.errorBodyRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--timeout-delay") && hasValue) {
+			serverSettings.timeoutDelay = args[++i].toInt();
+		}
+		else if ((args[i] == "--seed") && hasValue) {
+			generatorSettings.seed = args[++i].toInt();
+		}
+		else if ((args[i] == "--devices") && hasValue) {
+			generatorSettings.deviceCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--reports-per-device") && hasValue) {
+			generatorSettings.reportsPerDevice = args[++i].toDouble();
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+
+	reportGenerator generator(generatorSettings);
+	ifstream capsListStream(capsListFile);
+	string capsListXml((istreambuf_iterator<char>(capsListStream)), istreambuf_iterator<char>());
+	if ((capsListXml.empty()) || (!generator.capDefinitions.loadFromXml(capsListXml.c_str()))) {
+		cerr << "Could not load capability list " << capsListFile << "\n";
+		return -1;
+	}
+	generator.generateDevices();
+
+	localDatabaseServer server(serverSettings, &generator);
+	server.capsListXml = capsListXml;
+	if (!server.start()) {
+		cerr << "Could not listen on port " << serverSettings.port << " : " << server.errorString() << "\n";
+		return -1;
+	}
+
+	cout << "Serving " << generator.devices.size() << " devices and " << generator.reportCount() << " reports at http://localhost:" << server.port() << "/\n";
+	cout << "Request statistics at http://localhost:" << server.port() << "/stats\n";
+
+	return app.exec();
+}
@@ -0,0 +1,497 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Seeded generator for synthetic reports, device lists and device report lists
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "reportGenerator.h"
+#include <QXmlStreamWriter>
+#include <QDir>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <set>
+#include <cstdlib>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	// Commonly reported extensions, ordered by (roughly) decreasing adoption
+	const char* commonExtensions[] = {
+		"GL_ARB_multitexture", "GL_ARB_texture_compression", "GL_ARB_vertex_buffer_object", "GL_ARB_vertex_program", "GL_ARB_fragment_program",
+		"GL_ARB_framebuffer_object", "GL_ARB_texture_float", "GL_ARB_occlusion_query", "GL_EXT_texture_compression_s3tc", "GL_ARB_vertex_array_object",
+		"GL_ARB_uniform_buffer_object", "GL_ARB_sync", "GL_ARB_instanced_arrays", "GL_ARB_texture_rg", "GL_ARB_timer_query",
+		"GL_ARB_sampler_objects", "GL_ARB_blend_func_extended", "GL_ARB_draw_indirect", "GL_ARB_tessellation_shader", "GL_ARB_texture_buffer_range",
+		"GL_ARB_transform_feedback3", "GL_ARB_viewport_array", "GL_ARB_get_program_binary", "GL_ARB_internalformat_query", "GL_ARB_texture_storage",
+		"GL_ARB_shader_image_load_store", "GL_ARB_compute_shader", "GL_ARB_internalformat_query2", "GL_ARB_multi_draw_indirect", "GL_ARB_vertex_attrib_binding",
+		"GL_ARB_shader_storage_buffer_object", "GL_KHR_debug", "GL_ARB_buffer_storage", "GL_ARB_texture_view", "GL_ARB_clear_texture",
+		"GL_ARB_direct_state_access", "GL_ARB_clip_control", "GL_KHR_texture_compression_astc_ldr", "GL_ARB_bindless_texture", "GL_ARB_sparse_texture",
+		"GL_KHR_parallel_shader_compile", "GL_ARB_gl_spirv", "GL_NV_mesh_shader", "GL_EXT_memory_object", "GL_NV_gpu_shader5"
+	};
+
+	// Compressed texture formats (S3TC, RGTC, BPTC, ETC2/EAC, ASTC)
+	const GLint commonCompressedFormats[] = {
+		0x83F0, 0x83F1, 0x83F2, 0x83F3, 0x8DBB, 0x8DBC, 0x8DBD, 0x8DBE, 0x8E8C, 0x8E8D, 0x8E8E, 0x8E8F,
+		0x9274, 0x9275, 0x9276, 0x9277, 0x9278, 0x9279, 0x9270, 0x9271, 0x9272, 0x9273,
+		0x93B0, 0x93B1, 0x93B2, 0x93B3, 0x93B4, 0x93B5, 0x93B6, 0x93B7, 0x93B8, 0x93B9, 0x93BA, 0x93BB, 0x93BC, 0x93BD
+	};
+
+	struct vendorProfile
+	{
+		const char* vendor;
+		const char* renderers[4];
+		const char* rendererSuffix;
+		double weight;
+	};
+
+	const vendorProfile vendorProfiles[] = {
+		{ "NVIDIA Corporation", { "GeForce GT ", "GeForce GTX ", "Quadro K", "GeForce RTX " }, "/PCIe/SSE2", 0.40 },
+		{ "ATI Technologies Inc.", { "AMD Radeon HD ", "AMD Radeon R9 ", "AMD Radeon RX ", "AMD FirePro W" }, "", 0.25 },
+		{ "Intel", { "Intel(R) HD Graphics ", "Intel(R) UHD Graphics ", "Intel(R) Iris(R) Graphics ", "Intel(R) Iris(R) Pro Graphics " }, "", 0.30 },
+		{ "VMware, Inc.", { "llvmpipe (LLVM 3.", "softpipe ", "SVGA3D ", "llvmpipe (LLVM 6." }, ")", 0.05 }
+	};
+
+	const char* operatingSystems[] = { "Windows 10", "Windows 7", "Windows 8", "Linux 4.4.0 (x86_64)", "Linux 4.15.0 (x86_64)" };
+
+	reportGenerator::reportGenerator(reportGeneratorSettings settings)
+	{
+		this->settings = settings;
+
+		// Extension pool : common extensions and synthetic fill
+		for (auto& ext : commonExtensions) {
+			extensionPool.push_back(ext);
+		}
+		for (int i = 0; (int)extensionPool.size() < settings.extensionCount; i++) {
+			string ext = "GL_EXT_synthetic_extension_" + to_string(i);
+			extensionPool.push_back(ext);
+		}
+		extensionPool.resize(settings.extensionCount);
+
+		for (auto& format : commonCompressedFormats) {
+			compressedFormatPool.push_back(format);
+		}
+		for (int i = 0; (int)compressedFormatPool.size() < settings.compressedFormatCount; i++) {
+			compressedFormatPool.push_back(0xA000 + i);
+		}
+		compressedFormatPool.resize(settings.compressedFormatCount);
+	}
+
+	/// <summary>
+	/// Generates the device list, every device gets a vendor, performance tier, OpenGL version and report count
+	/// </summary>
+	void reportGenerator::generateDevices()
+	{
+		mt19937 rng(settings.seed);
+		discrete_distribution<int> vendorDist({ vendorProfiles[0].weight, vendorProfiles[1].weight, vendorProfiles[2].weight, vendorProfiles[3].weight });
+		geometric_distribution<int> reportDist(1.0 / max(settings.reportsPerDevice, 1.0));
+		const int glVersions[][2] = { { 3, 3 }, { 4, 1 }, { 4, 3 }, { 4, 5 } };
+
+		devices.clear();
+		set<string> renderers;
+		int reportId = 1;
+		int model = 0;
+		while ((int)devices.size() < settings.deviceCount) {
+			const vendorProfile& profile = vendorProfiles[vendorDist(rng)];
+			syntheticDevice device;
+			device.vendor = profile.vendor;
+			device.tier = rng() % 4;
+			stringstream renderer;
+			renderer << profile.renderers[device.tier] << (100 + (model++ * 7919) % 9900) << profile.rendererSuffix;
+			device.renderer = renderer.str();
+			// Model numbers wrap around, duplicates get a suffix to keep renderer names unique
+			if (!renderers.insert(device.renderer).second) {
+				device.renderer += " (" + to_string(model) + ")";
+				renderers.insert(device.renderer);
+			}
+			device.glMajor = glVersions[device.tier][0];
+			device.glMinor = glVersions[device.tier][1];
+			device.firstReportId = reportId;
+			device.reportCount = 1 + reportDist(rng);
+			reportId += device.reportCount;
+			devices.push_back(device);
+		}
+	}
+
+	int reportGenerator::reportCount()
+	{
+		return devices.empty() ? 0 : devices.back().firstReportId + devices.back().reportCount - 1;
+	}
+
+	/// <summary>
+	/// Each report has its own seed, so single reports can be regenerated without generating all preceding ones
+	/// </summary>
+	unsigned int reportGenerator::reportSeed(int deviceIndex, int reportIndex)
+	{
+		seed_seq seq{ settings.seed, (unsigned int)deviceIndex, (unsigned int)reportIndex };
+		unsigned int seed;
+		seq.generate(&seed, &seed + 1);
+		return seed;
+	}
+
+	string reportGenerator::driverVersion(const syntheticDevice& device, int reportIndex)
+	{
+		stringstream ss;
+		ss << device.glMajor << "." << device.glMinor << ".0";
+		if (device.vendor == vendorProfiles[0].vendor) {
+			ss << " NVIDIA " << 340 + reportIndex * 7 << "." << (reportIndex * 13) % 100;
+		}
+		else if (device.vendor == vendorProfiles[1].vendor) {
+			ss << " Compatibility Profile Context " << 15 + reportIndex / 12 << "." << 1 + reportIndex % 12;
+		}
+		else if (device.vendor == vendorProfiles[2].vendor) {
+			ss << " - Build 20.19.15." << 4300 + reportIndex * 31;
+		}
+		else {
+			ss << " Mesa " << 17 + reportIndex / 4 << "." << reportIndex % 4 << ".0";
+		}
+		return ss.str();
+	}
+
+	string reportGenerator::operatingSystem(const syntheticDevice& device, int reportIndex)
+	{
+		return operatingSystems[(device.firstReportId + reportIndex) % 5];
+	}
+
+	/// <summary>
+	/// Generates a plausible value for a cap, limits scale with the performance tier of the device
+	/// </summary>
+	string reportGenerator::capValue(mt19937& rng, const syntheticDevice& device, const string& name, const string& type)
+	{
+		if (type == "glfloat") {
+			return to_string((double)(rng() % 64) / 4.0);
+		}
+		if (name.find("SIZE") != string::npos) {
+			return to_string(1 << (11 + device.tier + rng() % 2));
+		}
+		if ((name.find("MIN_") != string::npos) || (name.find("OFFSET") != string::npos)) {
+			return to_string(-8 * (1 + (int)(rng() % 4)));
+		}
+		return to_string((1 + (int)(rng() % 16)) << (2 + device.tier));
+	}
+
+	/// <summary>
+	/// Returns the report description as generated by glCapsViewerCore::readImplementation
+	/// </summary>
+	string reportGenerator::reportDescription(int deviceIndex, int reportIndex)
+	{
+		const syntheticDevice& device = devices[deviceIndex];
+		stringstream ss;
+		ss << device.vendor << " " << device.renderer << " " << driverVersion(device, reportIndex) << " (" << operatingSystem(device, reportIndex) << ")";
+		return ss.str();
+	}
+
+	/// <summary>
+	/// Fills the core with the synthetic report of a device (no OpenGL context required)
+	/// </summary>
+	/// <param name="core">Core to fill, will be cleared first</param>
+	/// <param name="deviceIndex">Index of the device in the generated device list</param>
+	/// <param name="reportIndex">Index of the report (driver version) for that device</param>
+	void reportGenerator::fillCore(glCapsViewerCore& core, int deviceIndex, int reportIndex)
+	{
+		const syntheticDevice& device = devices[deviceIndex];
+		mt19937 rng(reportSeed(deviceIndex, reportIndex));
+		uniform_real_distribution<double> chance(0.0, 1.0);
+
+		core.clear();
+		core.internalFormatTargets.clear();
+		core.contextType = "default";
+		core.implementation["Operating system"] = operatingSystem(device, reportIndex);
+		core.implementation["Vendor"] = device.vendor;
+		core.implementation["Renderer"] = device.renderer;
+		core.implementation["OpenGL version"] = driverVersion(device, reportIndex);
+		core.implementation["Shading language version"] = to_string(device.glMajor) + "." + to_string(device.glMinor) + "0";
+		core.description = reportDescription(deviceIndex, reportIndex);
+
+		// Extensions : adoption falls off with the pool index, higher tiers and newer drivers support more
+		double reach = 0.3 + 0.15 * device.tier + 0.02 * reportIndex;
+		for (size_t i = 0; i < extensionPool.size(); i++) {
+			double adoption = 1.0 - (double)i / extensionPool.size() / reach;
+			if (chance(rng) < adoption) {
+				core.extensions.push_back(extensionPool[i]);
+			}
+		}
+		core.osextensions.push_back("GLX_ARB_create_context");
+		core.osextensions.push_back("GLX_ARB_create_context_profile");
+
+		capsGroup implementationGroup;
+		implementationGroup.name = "implementation";
+		implementationGroup.supported = true;
+		implementationGroup.visible = false;
+		implementationGroup.capabilities["GL_VENDOR"] = core.implementation["Vendor"];
+		implementationGroup.capabilities["GL_RENDERER"] = core.implementation["Renderer"];
+		implementationGroup.capabilities["GL_VERSION"] = core.implementation["OpenGL version"];
+		implementationGroup.capabilities["GL_SHADING_LANGUAGE_VERSION"] = core.implementation["Shading language version"];
+		core.capgroups.push_back(implementationGroup);
+
+		// Caps from the capability list, support depends on the device version and extensions
+		for (auto& category : capDefinitions.categories) {
+			capsGroup group;
+			group.name = category.name;
+			group.supported = category.hasRequirements;
+			if (!category.requiredExtension.empty()) {
+				group.supported = core.extensionSupported(category.requiredExtension);
+			}
+			if (!category.requiredVersion.empty()) {
+				int major = atoi(category.requiredVersion.c_str());
+				int minor = atoi(category.requiredVersion.substr(category.requiredVersion.find('.') + 1).c_str());
+				group.supported = (device.glMajor > major) || ((device.glMajor == major) && (device.glMinor >= minor));
+			}
+			if (group.supported) {
+				for (auto& cap : category.caps) {
+					for (int i = 0; i < cap.components; i++) {
+						string name = (cap.components > 1) ? cap.name + "[" + to_string(i) + "]" : cap.name;
+						group.capabilities[name] = (chance(rng) < settings.missingCapRate) ? "n/a" : capValue(rng, device, cap.name, cap.type);
+					}
+				}
+			}
+			core.capgroups.push_back(group);
+		}
+
+		// Synthetic caps, 100 per group
+		for (int c = 0; c < settings.capCount; c += 100) {
+			capsGroup group;
+			group.name = "GL_EXT_synthetic_caps_" + to_string(c / 100);
+			group.supported = true;
+			for (int i = c; i < min(c + 100, settings.capCount); i++) {
+				string name = "GL_MAX_SYNTHETIC_LIMIT_" + to_string(i);
+				group.capabilities[name] = (chance(rng) < settings.missingCapRate) ? "n/a" : capValue(rng, device, name, "glint");
+			}
+			core.capgroups.push_back(group);
+		}
+
+		// Compressed formats : the common formats are mostly present, synthetic ones less likely
+		for (size_t i = 0; i < compressedFormatPool.size(); i++) {
+			double support = (i < 12) ? 0.95 : 0.25 + 0.2 * device.tier;
+			if (chance(rng) < support) {
+				core.compressedFormats.push_back(compressedFormatPool[i]);
+			}
+		}
+
+		if (settings.internalFormats) {
+			GLenum targets[] = { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_RENDERBUFFER };
+			const pair<GLenum, const char*> valueInfos[] = {
+				{ GL_INTERNALFORMAT_PREFERRED, "GL_INTERNALFORMAT_PREFERRED" }, { GL_READ_PIXELS_FORMAT, "GL_READ_PIXELS_FORMAT" }, { GL_READ_PIXELS_TYPE, "GL_READ_PIXELS_TYPE" },
+				{ GL_TEXTURE_IMAGE_FORMAT, "GL_TEXTURE_IMAGE_FORMAT" }, { GL_TEXTURE_IMAGE_TYPE, "GL_TEXTURE_IMAGE_TYPE" }, { GL_MAX_WIDTH, "GL_MAX_WIDTH" },
+				{ GL_MAX_HEIGHT, "GL_MAX_HEIGHT" }, { GL_FRAMEBUFFER_BLEND, "GL_FRAMEBUFFER_BLEND" }, { GL_FILTER, "GL_FILTER" } };
+			const pair<GLenum, const char*> supportInfos[] = {
+				{ GL_VERTEX_TEXTURE, "GL_VERTEX_TEXTURE" }, { GL_FRAGMENT_TEXTURE, "GL_FRAGMENT_TEXTURE" }, { GL_COMPUTE_TEXTURE, "GL_COMPUTE_TEXTURE" },
+				{ GL_TEXTURE_SHADOW, "GL_TEXTURE_SHADOW" }, { GL_TEXTURE_GATHER, "GL_TEXTURE_GATHER" }, { GL_SHADER_IMAGE_LOAD, "GL_SHADER_IMAGE_LOAD" },
+				{ GL_SHADER_IMAGE_STORE, "GL_SHADER_IMAGE_STORE" }, { GL_SHADER_IMAGE_ATOMIC, "GL_SHADER_IMAGE_ATOMIC" } };
+			GLint supportLevels[] = { GL_NONE, GL_CAVEAT_SUPPORT, GL_FULL_SUPPORT };
+			for (auto& target : targets) {
+				internalFormatTarget formatTarget(target, core.compressedFormats);
+				for (auto& format : formatTarget.textureFormats) {
+					format.supported = (chance(rng) < 0.8);
+					if (!format.supported) {
+						continue;
+					}
+					for (auto& info : valueInfos) {
+						format.addValueInfo(infoTypeValue, info.first, info.second);
+						format.formatInfoValues.back().infoValue = ((info.first == GL_MAX_WIDTH) || (info.first == GL_MAX_HEIGHT)) ? (1 << (12 + device.tier)) : (GLint)((rng() % 2) ? GL_RGBA : GL_UNSIGNED_BYTE);
+					}
+					for (auto& info : supportInfos) {
+						format.addValueInfo(infoTypeSupport, info.first, info.second);
+						format.formatInfoValues.back().infoValue = supportLevels[rng() % 3];
+					}
+				}
+				core.internalFormatTargets.push_back(formatTarget);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Generates a report xml as exported by glCapsViewerCore::reportToXml
+	/// </summary>
+	string reportGenerator::reportXml(int deviceIndex, int reportIndex)
+	{
+		glCapsViewerCore core;
+		fillCore(core, deviceIndex, reportIndex);
+		return core.reportToXml();
+	}
+
+	/// <summary>
+	/// Generates a report xml as returned by the database (gl_getreport.php) for the given core
+	/// A fraction of the caps (settings.databaseMissingRate) is left empty so the report can be updated
+	/// </summary>
+	string reportGenerator::databaseReportXml(glCapsViewerCore& core, unsigned int seed)
+	{
+		mt19937 rng(seed);
+		uniform_real_distribution<double> chance(0.0, 1.0);
+
+		// The client parses these without skipping whitespace, so no auto formatting
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("report");
+
+		xmlWriter.writeStartElement("implementation");
+		for (auto& group : core.capgroups) {
+			for (auto& cap : group.capabilities) {
+				bool missing = (cap.second == "n/a") || (chance(rng) < settings.databaseMissingRate);
+				xmlWriter.writeStartElement("cap");
+				xmlWriter.writeAttribute("id", QString::fromStdString(cap.first));
+				xmlWriter.writeCharacters(missing ? "" : QString::fromStdString(cap.second));
+				xmlWriter.writeEndElement();
+			}
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("extensions");
+		for (auto& ext : core.extensions) {
+			xmlWriter.writeTextElement("extension", QString::fromStdString(ext));
+		}
+		for (auto& ext : core.osextensions) {
+			xmlWriter.writeTextElement("extension", QString::fromStdString(ext));
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeStartElement("compressedtextureformats");
+		for (auto& compressedFormat : core.compressedFormats) {
+			if (chance(rng) >= settings.databaseMissingRate) {
+				xmlWriter.writeTextElement("compressedtextureformat", QString::number(compressedFormat));
+			}
+		}
+		xmlWriter.writeEndElement();
+
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	/// <summary>
+	/// Generates a capability list xml (capslist.xml layout) with the given number of categories and caps
+	/// </summary>
+	string reportGenerator::capsListXml(int categoryCount, int capsPerCategory)
+	{
+		stringstream ss;
+		ss << "<?xml version=\"1.0\"?>\n<categories version=\"0.1\">\n";
+		for (int c = 0; c < categoryCount; c++) {
+			ss << "\t<category name=\"GL_EXT_synthetic_caps_" << c << "\">\n";
+			ss << "\t\t<requirements extension=\"GL_EXT_synthetic_extension_" << c << "\" version=\"\"/>\n";
+			for (int i = 0; i < capsPerCategory; i++) {
+				ss << "\t\t<cap name=\"GL_MAX_SYNTHETIC_LIMIT_" << c * capsPerCategory + i << "\" enum=\"0x" << hex << (0x10000 + c * capsPerCategory + i) << dec << "\" type=\"glint\" components=\"1\" />\n";
+			}
+			ss << "\t</category>\n";
+		}
+		ss << "</categories>\n";
+		return ss.str();
+	}
+
+	/// <summary>
+	/// Generates the device list as returned by gl_getdevices.php
+	/// </summary>
+	string reportGenerator::deviceListXml()
+	{
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("devices");
+		for (auto& device : devices) {
+			xmlWriter.writeTextElement("device", QString::fromStdString(device.renderer));
+		}
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	/// <summary>
+	/// Generates the list of reports for a device as returned by gl_getdevicereports.php
+	/// </summary>
+	string reportGenerator::deviceReportsXml(int deviceIndex)
+	{
+		QString xmlStr;
+		QXmlStreamWriter xmlWriter(&xmlStr);
+		xmlWriter.writeStartDocument();
+		xmlWriter.writeStartElement("reports");
+		for (auto& report : getDeviceReports(deviceIndex)) {
+			xmlWriter.writeStartElement("report");
+			xmlWriter.writeAttribute("id", QString::number(report.reportId));
+			xmlWriter.writeAttribute("os", QString::fromStdString(report.operatingSystem));
+			xmlWriter.writeCharacters(QString::fromStdString(report.version));
+			xmlWriter.writeEndElement();
+		}
+		xmlWriter.writeEndElement();
+		xmlWriter.writeEndDocument();
+		return xmlStr.toStdString();
+	}
+
+	vector<syntheticReportInfo> reportGenerator::getDeviceReports(int deviceIndex)
+	{
+		vector<syntheticReportInfo> reports;
+		const syntheticDevice& device = devices[deviceIndex];
+		for (int i = 0; i < device.reportCount; i++) {
+			reports.push_back(getReportInfo(device.firstReportId + i));
+		}
+		return reports;
+	}
+
+	/// <summary>
+	/// Returns device and report index for a report id
+	/// </summary>
+	/// <returns>Report info, deviceIndex is -1 if there is no report with that id</returns>
+	syntheticReportInfo reportGenerator::getReportInfo(int reportId)
+	{
+		syntheticReportInfo info;
+		info.reportId = reportId;
+		info.deviceIndex = -1;
+		info.reportIndex = -1;
+		// Devices are ordered by their first report id
+		auto device = upper_bound(devices.begin(), devices.end(), reportId, [](int id, const syntheticDevice& device) { return id < device.firstReportId; });
+		if ((device == devices.begin()) || (reportId > reportCount())) {
+			return info;
+		}
+		--device;
+		info.deviceIndex = (int)(device - devices.begin());
+		info.reportIndex = reportId - device->firstReportId;
+		info.version = driverVersion(*device, info.reportIndex);
+		info.operatingSystem = operatingSystem(*device, info.reportIndex);
+		return info;
+	}
+
+	int reportGenerator::findDevice(const string& renderer)
+	{
+		for (size_t i = 0; i < devices.size(); i++) {
+			if (devices[i].renderer == renderer) {
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+
+	/// <summary>
+	/// Writes exported report xmls for the first count reports to a directory
+	/// </summary>
+	/// <returns>Number of reports written</returns>
+	int reportGenerator::writeReports(string directory, int count)
+	{
+		QDir().mkpath(QString::fromStdString(directory));
+		int written = 0;
+		for (int reportId = 1; (reportId <= reportCount()) && (written < count); reportId++) {
+			syntheticReportInfo info = getReportInfo(reportId);
+			ofstream destfile;
+			destfile.open(directory + "/report_" + to_string(reportId) + ".xml");
+			destfile << reportXml(info.deviceIndex, info.reportIndex);
+			destfile.close();
+			written++;
+		}
+		return written;
+	}
+
+}
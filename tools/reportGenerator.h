@@ -0,0 +1,109 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Seeded generator for synthetic reports, device lists and device report lists
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include "glCapsViewerCore.h"
+#include "capsList.h"
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class reportGeneratorSettings
+	{
+	public:
+		unsigned int seed = 42;
+		// Number of distinct devices (GL_RENDERER strings) in the device list
+		int deviceCount = 100;
+		// Mean number of reports (driver versions) per device, geometrically distributed
+		double reportsPerDevice = 3.0;
+		// Synthetic caps added on top of the capability list definitions
+		int capCount = 0;
+		// Size of the extension pool, adoption falls off with the index in the pool
+		int extensionCount = 250;
+		// Size of the compressed format pool
+		int compressedFormatCount = 40;
+		// Fraction of caps reported as not available
+		double missingCapRate = 0.05;
+		// Fraction of caps left empty in database reports (i.e. that can be updated)
+		double databaseMissingRate = 0.02;
+		bool internalFormats = false;
+	};
+
+	class syntheticDevice
+	{
+	public:
+		string vendor;
+		string renderer;
+		// Performance tier from 0 (low end) to 3 (high end), scales limits
+		int tier;
+		int glMajor;
+		int glMinor;
+		int firstReportId;
+		int reportCount;
+	};
+
+	class syntheticReportInfo
+	{
+	public:
+		int reportId;
+		int deviceIndex;
+		int reportIndex;
+		string version;
+		string operatingSystem;
+	};
+
+	class reportGenerator
+	{
+	private:
+		vector<string> extensionPool;
+		vector<GLint> compressedFormatPool;
+		unsigned int reportSeed(int deviceIndex, int reportIndex);
+		string driverVersion(const syntheticDevice& device, int reportIndex);
+		string operatingSystem(const syntheticDevice& device, int reportIndex);
+		string capValue(mt19937& rng, const syntheticDevice& device, const string& name, const string& type);
+	public:
+		reportGeneratorSettings settings;
+		// Cap definitions used for the generated caps (usually loaded from capslist.xml)
+		capsList capDefinitions;
+		vector<syntheticDevice> devices;
+		reportGenerator(reportGeneratorSettings settings);
+		void generateDevices();
+		int reportCount();
+		syntheticReportInfo getReportInfo(int reportId);
+		string reportDescription(int deviceIndex, int reportIndex);
+		vector<syntheticReportInfo> getDeviceReports(int deviceIndex);
+		int findDevice(const string& renderer);
+		void fillCore(glCapsViewerCore& core, int deviceIndex, int reportIndex);
+		string reportXml(int deviceIndex, int reportIndex);
+		string databaseReportXml(glCapsViewerCore& core, unsigned int seed);
+		static string capsListXml(int categoryCount, int capsPerCategory);
+		string deviceListXml();
+		string deviceReportsXml(int deviceIndex);
+		int writeReports(string directory, int count);
+	};
+
+}
@@ -0,0 +1,99 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Command line comparison of two reports
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+#include "glCapsViewerCore.h"
+#include "reportDiff.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_reportdiff <base.xml> <other.xml> [options]\n\n";
+	cout << "Compares two reports (exported or database layout), exits with 1 if they differ\n\n";
+	cout << "  --updates   Only list values the base report can be updated with\n";
+}
+
+bool readReport(const string& fileName, reportData& report)
+{
+	ifstream file(fileName);
+	string xml((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	if ((xml.empty()) || (!report.fromXml(xml))) {
+		cerr << "Could not read report " << fileName << "\n";
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	vector<string> fileNames;
+	bool updatesOnly = false;
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		if (args[i] == "--updates") {
+			updatesOnly = true;
+		}
+		else if ((!args[i].startsWith("-")) && (fileNames.size() < 2)) {
+			fileNames.push_back(args[i].toStdString());
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+	if (fileNames.size() != 2) {
+		printUsage();
+		return -1;
+	}
+
+	reportData base;
+	reportData other;
+	if ((!readReport(fileNames[0], base)) || (!readReport(fileNames[1], other))) {
+		return -1;
+	}
+
+	// Compressed formats are listed by name if the enum list is available
+	glCapsViewerCore core;
+	core.loadEnumList();
+
+	reportDiff diff;
+	diff.compare(base, other);
+	if (updatesOnly) {
+		vector<reportDiffEntry> updates;
+		for (auto& entry : diff.updates()) {
+			updates.push_back(*entry);
+		}
+		diff.entries = updates;
+	}
+	cout << diff.toText([&core](GLint glenum) { return core.getEnumName(glenum); });
+
+	return (diff.entries.empty()) ? 0 : 1;
+}
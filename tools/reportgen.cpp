@@ -0,0 +1,116 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Command line tool for generating synthetic reports and device lists
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <iostream>
+#include <fstream>
+
+#include "reportGenerator.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_reportgen --out <dir> [options]\n\n";
+	cout << "Writes report_<id>.xml files (exportXml layout) and devices.xml to the output directory\n\n";
+	cout << "  --seed <n>                 Random seed (default 42)\n";
+	cout << "  --devices <n>              Number of devices (default 100)\n";
+	cout << "  --reports-per-device <n>   Mean number of reports per device (default 3)\n";
+	cout << "  --count <n>                Maximum number of reports to write (default all)\n";
+	cout << "  --caps <n>                 Synthetic caps on top of capslist.xml (default 0)\n";
+	cout << "  --extensions <n>           Size of the extension pool (default 250)\n";
+	cout << "  --formats <n>              Size of the compressed format pool (default 40)\n";
+	cout << "  --internal-formats         Generate internal format information\n";
+	cout << "  --capslist <file>          Capability list to generate caps for (default capslist.xml)\n";
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	reportGeneratorSettings settings;
+	string outDir;
+	string capsListFile = "capslist.xml";
+	int count = -1;
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--out") && hasValue) {
+			outDir = args[++i].toStdString();
+		}
+		else if ((args[i] == "--seed") && hasValue) {
+			settings.seed = args[++i].toInt();
+		}
+		else if ((args[i] == "--devices") && hasValue) {
+			settings.deviceCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--reports-per-device") && hasValue) {
+			settings.reportsPerDevice = args[++i].toDouble();
+		}
+		else if ((args[i] == "--count") && hasValue) {
+			count = args[++i].toInt();
+		}
+		else if ((args[i] == "--caps") && hasValue) {
+			settings.capCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--extensions") && hasValue) {
+			settings.extensionCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--formats") && hasValue) {
+			settings.compressedFormatCount = args[++i].toInt();
+		}
+		else if (args[i] == "--internal-formats") {
+			settings.internalFormats = true;
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+
+	if (outDir.empty()) {
+		printUsage();
+		return -1;
+	}
+
+	reportGenerator generator(settings);
+	if (!generator.capDefinitions.loadFromFile(capsListFile)) {
+		cerr << "Could not load capability list " << capsListFile << ", only synthetic caps will be generated\n";
+	}
+	generator.generateDevices();
+
+	int written = generator.writeReports(outDir, (count < 0) ? generator.reportCount() : count);
+
+	ofstream deviceList;
+	deviceList.open(outDir + "/devices.xml");
+	deviceList << generator.deviceListXml();
+	deviceList.close();
+
+	cout << "Generated " << generator.devices.size() << " devices and " << written << " reports in " << outDir << "\n";
+
+	return 0;
+}
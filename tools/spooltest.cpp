@@ -0,0 +1,192 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Upload spool throughput test against the local database server
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <iostream>
+#include <iomanip>
+
+#include "localDatabaseServer.h"
+#include "reportGenerator.h"
+#include "uploadSpool.h"
+#include "glCapsViewerHttp.h"
+
+using namespace std;
+using namespace capsViewer;
+
+void printUsage()
+{
+	cout << "Usage: glcapsviewer_spooltest [options]\n\n";
+	cout << "Spools synthetic reports and submits them to an in-process local database server\n\n";
+	cout << "  --reports <n>          Number of reports to spool (default 200)\n";
+	cout << "  --present-rate <f>     Fraction of reports already present in the database (default 0.25)\n";
+	cout << "  --batch <n>            Reports submitted per flush (default 8)\n";
+	cout << "  --concurrency <n>      Reports submitted at the same time (default 4)\n";
+	cout << "  --latency <ms>         Server latency (default 20)\n";
+	cout << "  --jitter <ms>          Server latency jitter (default 10)\n";
+	cout << "  --error-rate <f>       Fraction of requests failing with http 500 (default 0.05)\n";
+	cout << "  --timeout-rate <f>     Fraction of requests never answered (default 0.01)\n";
+	cout << "  --error-body-rate <f>  Fraction of uploads and updates answered with http 200 and a php error (default 0.05)\n";
+	cout << "  --timeout <ms>         Request timeout of the spool (default 2000)\n";
+	cout << "  --capslist <file>      Capability list (default capslist.xml)\n";
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	int reportCount = 200;
+	double presentRate = 0.25;
+	string capsListFile = "capslist.xml";
+	localServerSettings serverSettings;
+	serverSettings.port = 0;
+	serverSettings.latency = 20;
+	serverSettings.jitter = 10;
+	serverSettings.errorRate = 0.05;
+	serverSettings.timeoutRate = 0.01;
+	serverSettings.errorBodyRate = 0.05;
+	int batchSize = 8;
+	int concurrency = 4;
+	int requestTimeout = 2000;
+	QStringList args = app.arguments();
+	for (int i = 1; i < args.size(); i++) {
+		bool hasValue = (i + 1 < args.size());
+		if ((args[i] == "--reports") && hasValue) {
+			reportCount = args[++i].toInt();
+		}
+		else if ((args[i] == "--present-rate") && hasValue) {
+			presentRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--batch") && hasValue) {
+			batchSize = args[++i].toInt();
+		}
+		else if ((args[i] == "--concurrency") && hasValue) {
+			concurrency = args[++i].toInt();
+		}
+		else if ((args[i] == "--latency") && hasValue) {
+			serverSettings.latency = args[++i].toInt();
+		}
+		else if ((args[i] == "--jitter") && hasValue) {
+			serverSettings.jitter = args[++i].toInt();
+		}
+		else if ((args[i] == "--error-rate") && hasValue) {
+			serverSettings.errorRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--timeout-rate") && hasValue) {
+			serverSettings.timeoutRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--error-body-rate") && hasValue) {
+			serverSettings.errorBodyRate = args[++i].toDouble();
+		}
+		else if ((args[i] == "--timeout") && hasValue) {
+			requestTimeout = args[++i].toInt();
+		}
+		else if ((args[i] == "--capslist") && hasValue) {
+			capsListFile = args[++i].toStdString();
+		}
+		else {
+			printUsage();
+			return (args[i] == "--help") ? 0 : -1;
+		}
+	}
+	// Unanswered requests are closed by the server after the spool has given up on them
+	serverSettings.timeoutDelay = requestTimeout * 2;
+
+	// The database contains the reports of the first device set, new reports come from a second one
+	reportGeneratorSettings databaseSettings;
+	databaseSettings.deviceCount = max(1, (int)(reportCount * presentRate));
+	databaseSettings.reportsPerDevice = 1.0;
+	reportGenerator databaseGenerator(databaseSettings);
+	reportGeneratorSettings newSettings = databaseSettings;
+	newSettings.seed = databaseSettings.seed + 1;
+	newSettings.deviceCount = reportCount;
+	reportGenerator newGenerator(newSettings);
+	if ((!databaseGenerator.capDefinitions.loadFromFile(capsListFile)) || (!newGenerator.capDefinitions.loadFromFile(capsListFile))) {
+		cerr << "Could not load capability list " << capsListFile << "\n";
+		return -1;
+	}
+	databaseGenerator.generateDevices();
+	newGenerator.generateDevices();
+
+	localDatabaseServer server(serverSettings, &databaseGenerator);
+	if (!server.start()) {
+		cerr << "Could not start local database server : " << server.errorString() << "\n";
+		return -1;
+	}
+	glCapsViewerHttp::setBaseUrl("http://localhost:" + to_string(server.port()) + "/");
+
+	QTemporaryDir spoolDir;
+	uploadSpool spool(spoolDir.path().toStdString());
+	spool.batchSize = batchSize;
+	spool.maxConcurrent = concurrency;
+	spool.requestTimeout = requestTimeout;
+	spool.baseBackoff = 50;
+	spool.maxBackoff = 2000;
+	spool.flushInterval = 50;
+
+	// Every report is spooled twice to check deduplication
+	QElapsedTimer enqueueTimer;
+	enqueueTimer.start();
+	int presentCount = 0;
+	for (int i = 0; i < reportCount; i++) {
+		glCapsViewerCore core;
+		bool present = (i < (int)(reportCount * presentRate)) && (i < (int)databaseGenerator.devices.size());
+		if (present) {
+			databaseGenerator.fillCore(core, i, 0);
+			presentCount++;
+		}
+		else {
+			newGenerator.fillCore(core, i, 0);
+		}
+		string xml = core.reportToXml();
+		spool.enqueue(core.description, xml);
+		spool.enqueue(core.description, xml);
+	}
+	double enqueueTime = enqueueTimer.elapsed() / 1000.0;
+	cout << "Spooled " << spool.count() << " reports (" << presentCount << " already present, " << spool.duplicates << " duplicates skipped) in " << fixed << setprecision(3) << enqueueTime << " s\n";
+
+	QElapsedTimer flushTimer;
+	flushTimer.start();
+	spool.start();
+	QTimer pollTimer;
+	QObject::connect(&pollTimer, &QTimer::timeout, [&]() {
+		if ((spool.count() == 0) && (spool.idle())) {
+			app.quit();
+		}
+	});
+	pollTimer.start(10);
+	app.exec();
+	double flushTime = flushTimer.elapsed() / 1000.0;
+
+	cout << "Submitted " << spool.submitted << " reports in " << flushTime << " s (" << setprecision(1) << spool.submitted / flushTime << " reports/s), " << spool.failures << " failed attempts retried\n";
+	cout << server.statsToJson();
+
+	// Reports answered with an error are retried, so every spooled report has to be stored exactly once
+	if ((server.accepted != spool.submitted) || (spool.submitted != reportCount)) {
+		cerr << "FAILED: " << spool.submitted << " of " << reportCount << " reports submitted, " << server.accepted << " stored by the server\n";
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,367 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Persistent queue of reports waiting for submission to the database
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "uploadSpool.h"
+#include "glCapsViewerHttp.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QDateTime>
+#include <QStringList>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QHttpMultiPart>
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	uploadSpool::uploadSpool(string directory, QObject* parent) : QObject(parent)
+	{
+		this->directory = directory;
+		rng.seed((unsigned int)QDateTime::currentMSecsSinceEpoch());
+		QDir().mkpath(QString::fromStdString(directory));
+		loadEntries();
+		connect(&flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+	}
+
+	string uploadSpool::defaultDirectory()
+	{
+		return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString() + "/spool";
+	}
+
+	/// <summary>
+	/// Hash of a report xml, ignoring the capture date so repeated captures of the same implementation are identical
+	/// </summary>
+	string uploadSpool::contentHash(const string& xml)
+	{
+		string content = xml;
+		size_t dateStart = content.find("<date>");
+		size_t dateEnd = content.find("</date>");
+		if ((dateStart != string::npos) && (dateEnd != string::npos) && (dateEnd > dateStart)) {
+			content.erase(dateStart, dateEnd - dateStart);
+		}
+		return QCryptographicHash::hash(QByteArray(content.c_str(), (int)content.size()), QCryptographicHash::Sha1).toHex().constData();
+	}
+
+	string uploadSpool::entryFileName(const string& id, const string& extension)
+	{
+		return directory + "/" + id + extension;
+	}
+
+	void uploadSpool::loadEntries()
+	{
+		QDir dir(QString::fromStdString(directory));
+		QStringList fileNames = dir.entryList(QStringList() << "*.ini", QDir::Files);
+		for (auto& fileName : fileNames) {
+			string id = QFileInfo(fileName).baseName().toStdString();
+			if (!QFile::exists(QString::fromStdString(entryFileName(id, ".xml")))) {
+				continue;
+			}
+			QSettings ini(dir.filePath(fileName), QSettings::IniFormat);
+			spoolEntry entry;
+			entry.id = id;
+			entry.description = ini.value("description").toString().toStdString();
+			entry.contentHash = ini.value("hash").toString().toStdString();
+			entry.attempts = ini.value("attempts", 0).toInt();
+			entry.nextAttempt = ini.value("nextattempt", 0).toLongLong();
+			entry.lastError = ini.value("lasterror").toString().toStdString();
+			entries[id] = entry;
+		}
+	}
+
+	void uploadSpool::saveEntry(const spoolEntry& entry)
+	{
+		QSettings ini(QString::fromStdString(entryFileName(entry.id, ".ini")), QSettings::IniFormat);
+		ini.setValue("description", QString::fromStdString(entry.description));
+		ini.setValue("hash", QString::fromStdString(entry.contentHash));
+		ini.setValue("attempts", entry.attempts);
+		ini.setValue("nextattempt", entry.nextAttempt);
+		ini.setValue("lasterror", QString::fromStdString(entry.lastError));
+	}
+
+	void uploadSpool::removeEntry(const string& id)
+	{
+		QFile::remove(QString::fromStdString(entryFileName(id, ".ini")));
+		QFile::remove(QString::fromStdString(entryFileName(id, ".xml")));
+		entries.erase(id);
+	}
+
+	/// <summary>
+	/// Adds a report to the spool, replacing an older capture with the same description
+	/// </summary>
+	/// <param name="description">Description of the report (used to identify it in the database)</param>
+	/// <param name="xml">Report xml as generated by glCapsViewerCore::reportToXml</param>
+	/// <returns>false if an identical report is already spooled</returns>
+	bool uploadSpool::enqueue(const string& description, const string& xml)
+	{
+		spoolEntry entry;
+		entry.id = QCryptographicHash::hash(QByteArray(description.c_str(), (int)description.size()), QCryptographicHash::Sha1).toHex().constData();
+		entry.description = description;
+		entry.contentHash = contentHash(xml);
+
+		auto existing = entries.find(entry.id);
+		if ((existing != entries.end()) && (existing->second.contentHash == entry.contentHash)) {
+			duplicates++;
+			return false;
+		}
+
+		// Write the report first, so a partially written entry is never picked up by loadEntries
+		QFile file(QString::fromStdString(entryFileName(entry.id, ".xml")));
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			return false;
+		}
+		file.write(xml.c_str(), xml.size());
+		file.close();
+		saveEntry(entry);
+		entries[entry.id] = entry;
+		return true;
+	}
+
+	int uploadSpool::count()
+	{
+		return (int)entries.size();
+	}
+
+	bool uploadSpool::idle()
+	{
+		return (inFlight == 0) && (!checkingServer) && (batchQueue.empty());
+	}
+
+	vector<spoolEntry> uploadSpool::getEntries()
+	{
+		vector<spoolEntry> list;
+		for (auto& entry : entries) {
+			list.push_back(entry.second);
+		}
+		return list;
+	}
+
+	/// <summary>
+	/// Starts flushing the spool in the background every flushInterval ms
+	/// </summary>
+	void uploadSpool::start()
+	{
+		flushTimer.start(flushInterval);
+		QTimer::singleShot(0, this, SLOT(flush()));
+	}
+
+	void uploadSpool::stop()
+	{
+		flushTimer.stop();
+	}
+
+	/// <summary>
+	/// Exponential backoff with up to 25% jitter, so clients that failed at the same time don't retry at the same time
+	/// </summary>
+	qint64 uploadSpool::backoff(int attempts)
+	{
+		qint64 delay = baseBackoff;
+		for (int i = 1; (i < attempts) && (delay < maxBackoff); i++) {
+			delay *= 2;
+		}
+		delay = min(delay, (qint64)maxBackoff);
+		return delay + uniform_int_distribution<qint64>(0, delay / 4)(rng);
+	}
+
+	/// <summary>
+	/// Submits the next batch of due reports if the database can be reached
+	/// </summary>
+	void uploadSpool::flush()
+	{
+		if ((!idle()) || (entries.empty())) {
+			return;
+		}
+		qint64 now = QDateTime::currentMSecsSinceEpoch();
+		if (now < serverRetryTime) {
+			return;
+		}
+		bool due = false;
+		for (auto& entry : entries) {
+			due |= (entry.second.nextAttempt <= now);
+		}
+		if (!due) {
+			return;
+		}
+
+		checkingServer = true;
+		QUrl url(QString::fromStdString(glCapsViewerHttp::getBaseUrl() + "services/gl_serverstate.php"));
+		QNetworkReply* reply = manager.get(QNetworkRequest(url));
+		connect(reply, SIGNAL(finished()), this, SLOT(slotServerStateFinished()));
+		QTimer::singleShot(requestTimeout, reply, SLOT(abort()));
+	}
+
+	void uploadSpool::slotServerStateFinished()
+	{
+		QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+		reply->deleteLater();
+		checkingServer = false;
+		qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+		if (reply->error() != QNetworkReply::NoError) {
+			serverFailures++;
+			serverRetryTime = now + backoff(serverFailures);
+			return;
+		}
+		serverFailures = 0;
+		QByteArray state = reply->readAll();
+		compressedUpdates = glCapsViewerHttp::supportsCompressedUpdates(string(state.constData(), state.size()));
+
+		vector<spoolEntry*> dueEntries;
+		for (auto& entry : entries) {
+			if (entry.second.nextAttempt <= now) {
+				dueEntries.push_back(&entry.second);
+			}
+		}
+		sort(dueEntries.begin(), dueEntries.end(), [](const spoolEntry* a, const spoolEntry* b) { return a->nextAttempt < b->nextAttempt; });
+		for (size_t i = 0; (i < dueEntries.size()) && (i < (size_t)batchSize); i++) {
+			batchQueue.push_back(dueEntries[i]->id);
+		}
+		startNext();
+	}
+
+	void uploadSpool::startNext()
+	{
+		while ((inFlight < maxConcurrent) && (!batchQueue.empty())) {
+			string id = batchQueue.front();
+			batchQueue.pop_front();
+			if (entries.count(id) > 0) {
+				inFlight++;
+				startRequest(id, spoolStepCheck);
+			}
+		}
+		// Continue with the next batch right away if there are more due reports
+		if (idle()) {
+			QTimer::singleShot(0, this, SLOT(flush()));
+		}
+	}
+
+	/// <summary>
+	/// Reports are checked for presence first, present reports are posted to the update script which only fills in missing values
+	/// </summary>
+	void uploadSpool::startRequest(const string& id, spoolStep step)
+	{
+		spoolEntry& entry = entries[id];
+		string baseUrl = glCapsViewerHttp::getBaseUrl();
+		QNetworkReply* reply;
+		bool compressed = false;
+		if (step == spoolStepCheck) {
+			QUrl url(QString::fromStdString(glCapsViewerHttp::encodeUrl(baseUrl + "gl_checkreport.php?description=" + entry.description)));
+			reply = manager.get(QNetworkRequest(url));
+		}
+		else {
+			QFile file(QString::fromStdString(entryFileName(id, ".xml")));
+			QByteArray xml;
+			if (file.open(QIODevice::ReadOnly)) {
+				xml = file.readAll();
+				file.close();
+			}
+			// Never post an empty report, the update script would accept it and the entry would be dropped
+			if (xml.isEmpty()) {
+				requestFailed(id, "Could not read spooled report " + file.fileName().toStdString());
+				return;
+			}
+			compressed = (step == spoolStepUpdate) && (compressedUpdates);
+			QHttpMultiPart* multiPart = glCapsViewerHttp::createMultiPart(string(xml.constData(), xml.size()), compressed);
+			string script = (step == spoolStepUpload) ? "services/gl_convertreport.php" : "services/gl_updatereport.php";
+			reply = manager.post(QNetworkRequest(QUrl(QString::fromStdString(baseUrl + script))), multiPart);
+			multiPart->setParent(reply);
+		}
+		spoolRequest request;
+		request.id = id;
+		request.step = step;
+		request.contentHash = entry.contentHash;
+		request.compressed = compressed;
+		pendingRequests[reply] = request;
+		connect(reply, SIGNAL(finished()), this, SLOT(slotRequestFinished()));
+		QTimer::singleShot(requestTimeout, reply, SLOT(abort()));
+	}
+
+	void uploadSpool::slotRequestFinished()
+	{
+		QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+		reply->deleteLater();
+		auto request = pendingRequests.find(reply);
+		if (request == pendingRequests.end()) {
+			return;
+		}
+		string id = request->second.id;
+		spoolStep step = request->second.step;
+		string requestHash = request->second.contentHash;
+		bool compressed = request->second.compressed;
+		pendingRequests.erase(request);
+
+		if (reply->error() != QNetworkReply::NoError) {
+			requestFailed(id, reply->errorString().toStdString());
+			return;
+		}
+		QByteArray replyData = reply->readAll();
+		string replyStr(replyData.constData(), replyData.size());
+
+		if (step == spoolStepCheck) {
+			int reportId = replyStr.empty() ? -1 : atoi(replyStr.c_str());
+			startRequest(id, (reportId > -1) ? spoolStepUpdate : spoolStepUpload);
+			return;
+		}
+		if ((step == spoolStepUpload) && (replyStr != "res_uploaded")) {
+			requestFailed(id, replyStr);
+			return;
+		}
+		// The server didn't accept the compressed update, updates are sent as plain xml from now on
+		if ((step == spoolStepUpdate) && (compressed) && (!glCapsViewerHttp::updateSucceeded(replyStr))) {
+			compressedUpdates = false;
+			startRequest(id, spoolStepUpdate);
+			return;
+		}
+		// Script errors (e.g. php error messages) are returned with status 200, the entry is kept and retried
+		if ((step == spoolStepUpdate) && (!glCapsViewerHttp::updateSucceeded(replyStr))) {
+			requestFailed(id, replyStr);
+			return;
+		}
+
+		QString description = QString::fromStdString(entries[id].description);
+		// A newer capture enqueued while the request was in flight stays in the spool
+		if (entries[id].contentHash == requestHash) {
+			removeEntry(id);
+		}
+		submitted++;
+		inFlight--;
+		emit reportSubmitted(description, QString::fromStdString(replyStr));
+		startNext();
+	}
+
+	void uploadSpool::requestFailed(const string& id, const string& error)
+	{
+		spoolEntry& entry = entries[id];
+		entry.attempts++;
+		entry.nextAttempt = QDateTime::currentMSecsSinceEpoch() + backoff(entry.attempts);
+		entry.lastError = error;
+		saveEntry(entry);
+		failures++;
+		inFlight--;
+		emit reportFailed(QString::fromStdString(entry.description), QString::fromStdString(error));
+		startNext();
+	}
+
+}
@@ -0,0 +1,130 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Persistent queue of reports waiting for submission to the database
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <random>
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	class spoolEntry
+	{
+	public:
+		// Hash of the description, used as file name
+		string id;
+		string description;
+		// Hash of the report contents (without the capture date)
+		string contentHash;
+		int attempts = 0;
+		// Earliest time for the next submission (ms since epoch)
+		qint64 nextAttempt = 0;
+		string lastError;
+	};
+
+	enum spoolStep { spoolStepCheck, spoolStepUpload, spoolStepUpdate };
+
+	class spoolRequest
+	{
+	public:
+		string id;
+		spoolStep step;
+		// Content hash of the entry when the request was started, the entry may be replaced by a newer capture meanwhile
+		string contentHash;
+		// Update sent zlib compressed
+		bool compressed = false;
+	};
+
+	/// <summary>
+	/// Reports are stored on disk (<id>.xml and <id>.ini) until they have been submitted
+	/// Only the latest capture per description is kept, identical captures are skipped
+	/// </summary>
+	class uploadSpool : public QObject
+	{
+		Q_OBJECT
+	private:
+		QNetworkAccessManager manager;
+		QTimer flushTimer;
+		mt19937 rng;
+		map<string, spoolEntry> entries;
+		map<QNetworkReply*, spoolRequest> pendingRequests;
+		deque<string> batchQueue;
+		int inFlight = 0;
+		bool checkingServer = false;
+		int serverFailures = 0;
+		qint64 serverRetryTime = 0;
+		// Updates are only sent compressed if the server state lists support for it
+		bool compressedUpdates = false;
+		void loadEntries();
+		void saveEntry(const spoolEntry& entry);
+		void removeEntry(const string& id);
+		string entryFileName(const string& id, const string& extension);
+		qint64 backoff(int attempts);
+		void startNext();
+		void startRequest(const string& id, spoolStep step);
+		void requestFailed(const string& id, const string& error);
+	private slots:
+		void slotServerStateFinished();
+		void slotRequestFinished();
+	signals:
+		void reportSubmitted(QString description, QString reply);
+		void reportFailed(QString description, QString error);
+	public:
+		string directory;
+		// Maximum number of reports submitted per flush
+		int batchSize = 8;
+		// Maximum number of reports submitted at the same time
+		int maxConcurrent = 4;
+		// Retry delays in ms, doubled with every failed attempt
+		int baseBackoff = 5000;
+		int maxBackoff = 3600000;
+		// Interval for automatic flushes and timeout for single requests in ms
+		int flushInterval = 30000;
+		int requestTimeout = 30000;
+		// Statistics since construction
+		int submitted = 0;
+		int failures = 0;
+		int duplicates = 0;
+		uploadSpool(string directory, QObject* parent = 0);
+		static string defaultDirectory();
+		static string contentHash(const string& xml);
+		bool enqueue(const string& description, const string& xml);
+		int count();
+		bool idle();
+		vector<spoolEntry> getEntries();
+		void start();
+		void stop();
+	public slots:
+		void flush();
+	};
+
+}
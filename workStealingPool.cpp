@@ -0,0 +1,147 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Thread pool with per worker task queues and work stealing
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#include "workStealingPool.h"
+#include <algorithm>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Starts the worker threads
+	/// </summary>
+	/// <param name="threadCount">Number of workers, 0 for one per hardware thread</param>
+	workStealingPool::workStealingPool(int threadCount) : steals(0)
+	{
+		if (threadCount <= 0) {
+			threadCount = max(1, (int)thread::hardware_concurrency());
+		}
+		for (int i = 0; i < threadCount; i++) {
+			queues.push_back(unique_ptr<workerQueue>(new workerQueue()));
+		}
+		for (int i = 0; i < threadCount; i++) {
+			threads.push_back(thread(&workStealingPool::workerLoop, this, i));
+		}
+	}
+
+	workStealingPool::~workStealingPool()
+	{
+		{
+			lock_guard<mutex> guard(stateLock);
+			stopping = true;
+		}
+		taskAvailable.notify_all();
+		for (auto& workerThread : threads) {
+			workerThread.join();
+		}
+	}
+
+	int workStealingPool::threadCount() const
+	{
+		return (int)threads.size();
+	}
+
+	void workStealingPool::submit(function<void(int)> task)
+	{
+		size_t queueIndex;
+		{
+			lock_guard<mutex> guard(stateLock);
+			queueIndex = nextQueue++ % queues.size();
+		}
+		{
+			lock_guard<mutex> guard(queues[queueIndex]->lock);
+			queues[queueIndex]->tasks.push_back(move(task));
+		}
+		{
+			lock_guard<mutex> guard(stateLock);
+			queuedTasks++;
+			pendingTasks++;
+		}
+		taskAvailable.notify_one();
+	}
+
+	/// <summary>
+	/// Blocks until all submitted tasks have finished
+	/// </summary>
+	void workStealingPool::wait()
+	{
+		unique_lock<mutex> guard(stateLock);
+		tasksDone.wait(guard, [this]() { return pendingTasks == 0; });
+	}
+
+	/// <summary>
+	/// Takes the newest task from the worker's own queue, or the oldest task of another worker's queue
+	/// </summary>
+	bool workStealingPool::popTask(int worker, function<void(int)>& task)
+	{
+		{
+			workerQueue& own = *queues[worker];
+			lock_guard<mutex> guard(own.lock);
+			if (!own.tasks.empty()) {
+				task = move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+		for (size_t i = 1; i < queues.size(); i++) {
+			workerQueue& victim = *queues[(worker + i) % queues.size()];
+			lock_guard<mutex> guard(victim.lock);
+			if (!victim.tasks.empty()) {
+				task = move(victim.tasks.front());
+				victim.tasks.pop_front();
+				steals++;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void workStealingPool::workerLoop(int worker)
+	{
+		while (true) {
+			{
+				unique_lock<mutex> guard(stateLock);
+				taskAvailable.wait(guard, [this]() { return (stopping) || (queuedTasks > 0); });
+				if ((stopping) && (queuedTasks == 0)) {
+					return;
+				}
+				// Reserve a task, tasks are queued before they are counted so popTask always finds one
+				queuedTasks--;
+			}
+			function<void(int)> task;
+			while (!popTask(worker, task)) {
+				this_thread::yield();
+			}
+			task(worker);
+			bool done;
+			{
+				lock_guard<mutex> guard(stateLock);
+				done = (--pendingTasks == 0);
+			}
+			if (done) {
+				tasksDone.notify_all();
+			}
+		}
+	}
+
+}
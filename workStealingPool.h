@@ -0,0 +1,73 @@
+/*
+*
+* OpenGL hardware capability viewer and database
+*
+* Thread pool with per worker task queues and work stealing
+*
+* Copyright (C) 2011-2016 by Sascha Willems (www.saschawillems.de)
+*
+* This code is free software, you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License version 3 as published by the Free Software Foundation.
+*
+* Please review the following information to ensure the GNU Lesser
+* General Public License version 3 requirements will be met:
+* http://opensource.org/licenses/lgpl-3.0.html
+*
+* The code is distributed WITHOUT ANY WARRANTY; without even the
+* implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU LGPL 3.0 for more details.
+*
+*/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace capsViewer {
+
+	using namespace std;
+
+	/// <summary>
+	/// Tasks are distributed round robin to the worker queues, idle workers steal from the other queues
+	/// Tasks get the index of the worker running them, so they can accumulate into per worker state without locking
+	/// </summary>
+	class workStealingPool
+	{
+	private:
+		class workerQueue
+		{
+		public:
+			mutex lock;
+			deque<function<void(int)>> tasks;
+		};
+		vector<unique_ptr<workerQueue>> queues;
+		vector<thread> threads;
+		mutex stateLock;
+		condition_variable taskAvailable;
+		condition_variable tasksDone;
+		// Tasks waiting in any queue and tasks not yet finished
+		size_t queuedTasks = 0;
+		size_t pendingTasks = 0;
+		size_t nextQueue = 0;
+		bool stopping = false;
+		bool popTask(int worker, function<void(int)>& task);
+		void workerLoop(int worker);
+	public:
+		// Number of tasks taken from another worker's queue
+		atomic<size_t> steals;
+		workStealingPool(int threadCount = 0);
+		~workStealingPool();
+		int threadCount() const;
+		void submit(function<void(int)> task);
+		void wait();
+	};
+
+}